@@ -26,7 +26,7 @@ echo "Removal complete."
 echo "Compiling GLSL shaders to SPIR-V..."
 
 # Определяем нужные расширения файлов
-SHADER_EXTENSIONS=("vert" "frag" "geom")
+SHADER_EXTENSIONS=("vert" "frag" "geom" "comp")
 
 # Проходим по всем папкам в текущей директории
 for MAT_DIR in "$SCRIPT_DIR"/*; do
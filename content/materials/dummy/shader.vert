@@ -1,6 +1,10 @@
 #version 450 core
 #extension GL_ARB_separate_shader_objects : enable
 
+// Константы специализации (задаются при создании конвейера материала)
+// Формат вершин: 0 - полный, 1 - упакованный, 2 - упакованный с квантованным положением
+layout(constant_id = 3) const uint VERTEX_FORMAT = 0;
+
 // Входные данные вершины
 layout(location = 0) in vec3 in_position;
 layout(location = 1) in vec3 in_normal;
@@ -12,9 +16,38 @@ layout (location = 0) out VS_OUT {
     vec3 color;
 } vs_out;
 
+// Push constants
+layout(push_constant) uniform PushConstants {
+    uint mat_index;
+    uint obj_index;
+    vec4 pos_offset;
+    vec4 pos_scale;
+} pc_push;
+
+// Параметры трансформаций одиночного объекта
+struct ObjectTransforms
+{
+    mat4 model;
+    mat4 normals;
+};
+
+// Uniform buffer для матриц камеры
+layout(set = 0, binding = 0, std140) uniform UCamera {
+    mat4 view;
+    mat4 proj;
+} u_camera;
+
+// Storage buffer для матриц объектов
+layout(set = 1, binding = 0, std430) readonly buffer SObjectTransforms {
+    ObjectTransforms s_objects[];
+};
+
 void main()
 {
-    // Выход
-    gl_Position = vec4(in_position, 1.0);
+    // Положение (квантованное восстанавливается по AABB mesh'а)
+    vec3 position = VERTEX_FORMAT == 2 ? in_position * pc_push.pos_scale.xyz + pc_push.pos_offset.xyz : in_position;
+
+    // Выход (материал-заглушка рисует объект на его месте, пока конвейер его материала создается)
+    gl_Position = u_camera.proj * u_camera.view * s_objects[pc_push.obj_index].model * vec4(position, 1.0);
     vs_out.color = in_color.rgb;
-}
\ No newline at end of file
+}
@@ -4,9 +4,14 @@
 
 // Константы
 #define PI 3.14159
-#define MAX_OBJECTS 1000
-#define MAX_MATERIALS 100
-#define MAX_LIGHTS 100
+#define TEXTURE_SAMPLERS 6
+
+// Константы специализации (задаются при создании конвейера материала)
+layout(constant_id = 1) const uint TEXTURE_TABLE_SIZE = 4096;
+layout(constant_id = 2) const uint TEXTURE_FEATURES = 0xFFFFFFFFu;
+layout(constant_id = 4) const uint LIGHT_CLUSTERS_X = 16u;
+layout(constant_id = 5) const uint LIGHT_CLUSTERS_Y = 9u;
+layout(constant_id = 6) const uint LIGHT_CLUSTERS_Z = 24u;
 
 // Входные данные фрагмента
 layout(location = 0) in GS_OUT {
@@ -37,6 +42,12 @@ struct MaterialSettings {
     float emission;
 };
 
+// Индексы текстур одиночного материала в глобальной таблице и индексы семплеров (по типу текстуры)
+struct MaterialTextures {
+    uint textures[8];
+    uint samplers[8];
+};
+
 // Параметры одиночного источника света
 struct LightSource {
     vec4 position;
@@ -48,12 +59,6 @@ struct LightSource {
     float intensity;
 };
 
-// Индексы активных источников света
-struct LightIndices {
-    uint count;
-    uint active_indices[MAX_LIGHTS];
-};
-
 // Uniform buffer для матриц камеры
 layout(set = 0, binding = 0, std140) uniform UCamera {
     mat4 view;
@@ -63,26 +68,51 @@ layout(set = 0, binding = 0, std140) uniform UCamera {
 
 // Storage buffer для PBR материалов
 layout(set = 2, binding = 1, std430) readonly buffer SMaterials {
-    MaterialSettings s_materials[MAX_MATERIALS];
+    MaterialSettings s_materials[];
+};
+
+// Storage buffer для индексов текстур материалов
+layout(set = 2, binding = 2, std430) readonly buffer SMaterialTextures {
+    MaterialTextures s_material_textures[];
 };
 
 // Storage buffer для источников света
 layout(set = 4, binding = 0, std430) readonly buffer SLightSources {
-    LightSource s_lights[MAX_LIGHTS];
+    LightSource s_lights[];
 };
 
 // Storage buffer для индексов активных источников
 layout(set = 4, binding = 1, std430) readonly buffer SLightIndices {
-    LightIndices s_light_indices;
-};
+    uint count;
+    uint active_indices[];
+} s_light_indices;
 
-// Текстуры объекта
-layout(set = 3, binding = 0) uniform sampler2D t_aldeo[MAX_MATERIALS];
-layout(set = 3, binding = 1) uniform sampler2D t_normal[MAX_MATERIALS];
-layout(set = 3, binding = 2) uniform sampler2D t_roughness[MAX_MATERIALS];
-layout(set = 3, binding = 3) uniform sampler2D t_height[MAX_MATERIALS];
-layout(set = 3, binding = 4) uniform sampler2D t_metallic[MAX_MATERIALS];
-layout(set = 3, binding = 5) uniform sampler2D t_ao[MAX_MATERIALS];
+// Storage buffer кластеров источников (ячейки экрана по слоям глубины, отрезки общего списка индексов)
+// Размер сетки задается константами, поэтому отрезки (первый индекс и кол-во) и индексы - один массив
+layout(set = 4, binding = 2, std430) readonly buffer SLightClusters {
+    uvec4 grid;
+    vec4 slices;
+    uint data[];
+} s_light_clusters;
+
+// Глобальная таблица текстур (общая для всех материалов) и семплеры
+layout(set = 3, binding = 0) uniform texture2D t_textures[TEXTURE_TABLE_SIZE];
+layout(set = 3, binding = 1) uniform sampler t_samplers[TEXTURE_SAMPLERS];
+
+// Выборка из текстуры материала заданного типа (индексы одинаковы для всего вызова отрисовки)
+vec4 sample_texture(uint type, vec2 uv)
+{
+    uint texture_id = s_material_textures[pc_push.mat_index].textures[type];
+    uint sampler_id = s_material_textures[pc_push.mat_index].samplers[type];
+    return texture(sampler2D(t_textures[texture_id], t_samplers[sampler_id]), uv);
+}
+
+// Признаки заданных текстур (бит на тип текстуры, выборки из незаданных исключаются при создании конвейера)
+const bool HAS_ALBEDO_MAP = (TEXTURE_FEATURES & (1u << 0)) != 0u;
+const bool HAS_NORMAL_MAP = (TEXTURE_FEATURES & (1u << 1)) != 0u;
+const bool HAS_ROUGHNESS_MAP = (TEXTURE_FEATURES & (1u << 2)) != 0u;
+const bool HAS_METALLIC_MAP = (TEXTURE_FEATURES & (1u << 4)) != 0u;
+const bool HAS_AO_MAP = (TEXTURE_FEATURES & (1u << 5)) != 0u;
 
 /**
  * @brief Normal Distribution Function
@@ -135,12 +165,11 @@ vec3 F_Schlick(float VoH, vec3 F0) {
 
 void main()
 {
-    // Данные из текстур объекта
-    vec4  tex_albedo = texture(t_aldeo[pc_push.mat_index], fs_in.uv);
-    vec3  tex_normal = texture(t_normal[pc_push.mat_index], fs_in.uv).rgb;
-    float tex_roughness = texture(t_roughness[pc_push.mat_index], fs_in.uv).r;
-    float tex_metallic = texture(t_metallic[pc_push.mat_index], fs_in.uv).r;
-    float tex_ao = texture(t_ao[pc_push.mat_index], fs_in.uv).r;
+    // Данные из текстур объекта (вместо незаданных - значения встроенных текстур по умолчанию)
+    vec4  tex_albedo = HAS_ALBEDO_MAP ? sample_texture(0u, fs_in.uv) : vec4(1.0);
+    float tex_roughness = HAS_ROUGHNESS_MAP ? sample_texture(2u, fs_in.uv).r : 1.0;
+    float tex_metallic = HAS_METALLIC_MAP ? sample_texture(4u, fs_in.uv).r : 1.0;
+    float tex_ao = HAS_AO_MAP ? sample_texture(5u, fs_in.uv).r : 1.0;
 
     // Параметры материала объекта
     MaterialSettings material = s_materials[pc_push.mat_index];
@@ -149,27 +178,53 @@ void main()
     float roughness = clamp(material.roughness * tex_roughness, 0.0f, 1.0f);
     float metallic = clamp(material.metallic * tex_metallic, 0.0f, 1.0f);
 
-    // Преобразуем нормаль из пространства касательных в мировое пространство
-    vec3 normal = normalize(tex_normal * 2.0 - 1.0); // Из [0,1] в [-1,1]
-    normal = normalize(fs_in.TBN * normal);
+    // Преобразуем нормаль из пространства касательных в мировое пространство (без карты нормалей - нормаль вершины)
+    vec3 normal = normalize(fs_in.normal);
+    if (HAS_NORMAL_MAP)
+    {
+        vec3 tex_normal = sample_texture(1u, fs_in.uv).rgb;
+        normal = normalize(tex_normal * 2.0 - 1.0); // Из [0,1] в [-1,1]
+        normal = normalize(fs_in.TBN * normal);
+    }
 
     // Сумарная освещенность точки (фрагмента)
     vec3 Lo = vec3(0.0f,0.0f,0.0f);
 
+    // Источники кластера фрагмента (без кластеров - все активные источники)
+    bool clustered = s_light_clusters.grid.z != 0u;
+    uint light_first = 0u;
+    uint light_count = s_light_indices.count;
+    if (clustered)
+    {
+        float view_depth = -(u_camera.view * vec4(fs_in.position, 1.0)).z;
+        float slice = log(max(view_depth, 1e-4)) * s_light_clusters.slices.x + s_light_clusters.slices.y;
+        uvec3 cluster = uvec3(
+            min(uvec2(gl_FragCoord.xy) / s_light_clusters.grid.xy, uvec2(LIGHT_CLUSTERS_X - 1u, LIGHT_CLUSTERS_Y - 1u)),
+            uint(clamp(slice, 0.0, float(LIGHT_CLUSTERS_Z - 1u))));
+        uint range = ((cluster.z * LIGHT_CLUSTERS_Y + cluster.y) * LIGHT_CLUSTERS_X + cluster.x) * 2u;
+        light_first = LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z * 2u + s_light_clusters.data[range];
+        light_count = s_light_clusters.data[range + 1u];
+    }
+
     // Обработка активных источников света
-    for (uint i = 0u; i < s_light_indices.count; ++i)
+    for (uint i = 0u; i < light_count; ++i)
     {
         // Получить источник
-        uint idx = s_light_indices.active_indices[i];
-        if (idx >= MAX_LIGHTS) continue;
+        uint idx = clustered ? s_light_clusters.data[light_first + i] : s_light_indices.active_indices[i];
+        if (idx >= uint(s_lights.length())) continue;
         LightSource light = s_lights[idx];
 
         // Вычисляем расстояние и направление к источнику света
         float dist = length(fs_in.position - light.position.xyz);
         vec3 light_dir = normalize(light.position.xyz - fs_in.position);
 
-        // Вычисляем затухание
+        // Вычисляем затухание (источник с радиусом плавно гаснет к границе радиуса и не освещает точки за ней)
         float attenuation = 1.0 / (1.0 + light.quadratic * dist * dist);
+        if (light.radius > 0.0)
+        {
+            float falloff = clamp(1.0 - pow(dist / light.radius, 4.0), 0.0, 1.0);
+            attenuation *= falloff * falloff;
+        }
 
         // Облученность (интенсивность освещенности) точки (фрагмента) конкретным источником
         vec3 radiance = light.color.rgb * attenuation * light.intensity;
@@ -2,8 +2,9 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_EXT_scalar_block_layout : enable
 
-// Константы
-#define MAX_OBJECTS 1000
+// Константы специализации (задаются при создании конвейера материала)
+// Формат вершин: 0 - полный, 1 - упакованный, 2 - упакованный с квантованным положением
+layout(constant_id = 3) const uint VERTEX_FORMAT = 0;
 
 // Входные данные вершины
 layout(location = 0) in vec3 in_position;
@@ -23,6 +24,8 @@ layout(location = 0) out VS_OUT {
 layout(push_constant) uniform PushConstants {
     uint mat_index;
     uint obj_index;
+    vec4 pos_offset;
+    vec4 pos_scale;
 } pc_push;
 
 // Параметры трансформаций одиночного объекта
@@ -41,22 +44,35 @@ layout(set = 0, binding = 0, std140) uniform UCamera {
 
 // Storage buffer для матриц объектов
 layout(set = 1, binding = 0, std430) readonly buffer SObjectTransforms {
-    ObjectTransforms s_objects[MAX_OBJECTS];
+    ObjectTransforms s_objects[];
 };
 
+// Восстановление единичного вектора из октаэдрических координат (упакованные форматы вершин)
+vec3 oct_decode(vec2 e)
+{
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-v.z, 0.0);
+    v.xy += vec2(v.x >= 0.0 ? -t : t, v.y >= 0.0 ? -t : t);
+    return normalize(v);
+}
+
 void main()
 {
+    // Атрибуты вершины (упакованные распаковываются, квантованное положение восстанавливается по AABB mesh'а)
+    vec3 position = VERTEX_FORMAT == 2 ? in_position * pc_push.pos_scale.xyz + pc_push.pos_offset.xyz : in_position;
+    vec3 normal = VERTEX_FORMAT == 0 ? in_normal : oct_decode(in_normal.xy);
+
     // Матрицы модели и нормалей
     mat4 model = s_objects[pc_push.obj_index].model;
     mat3 normal_mat = mat3(s_objects[pc_push.obj_index].normals);
 
-    // Нораль в мировом пространстве
-    vec4 world_pos = model * vec4(in_position, 1.0);
+    // Положение вершины в мировом пространстве
+    vec4 world_pos = model * vec4(position, 1.0);
 
     // Выход
     vs_out.uv = in_uv;
     vs_out.color = in_color.rgb;
-    vs_out.normal = normal_mat * in_normal;
+    vs_out.normal = normal_mat * normal;
     vs_out.position = world_pos.xyz;
     gl_Position = u_camera.proj * u_camera.view * world_pos;
 }
\ No newline at end of file
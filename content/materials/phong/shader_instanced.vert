@@ -0,0 +1,76 @@
+#version 450 core
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_scalar_block_layout : enable
+
+// Вариант shader.vert для instanced-отрисовки (индекс объекта - из буфера индексов экземпляров)
+// Общие объявления и распаковка атрибутов описаны в shader.vert
+
+layout(constant_id = 3) const uint VERTEX_FORMAT = 0;
+
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec2 in_uv;
+layout(location = 3) in vec4 in_color;
+
+layout(location = 0) out VS_OUT {
+    vec3 color;
+    vec3 position;
+    vec3 normal;
+    vec2 uv;
+} vs_out;
+
+layout(push_constant) uniform PushConstants {
+    uint mat_index;
+    uint obj_index;
+    vec4 pos_offset;
+    vec4 pos_scale;
+} pc_push;
+
+struct ObjectTransforms
+{
+    mat4 model;
+    mat4 normals;
+};
+
+layout(set = 0, binding = 0, std140) uniform UCamera {
+    mat4 view;
+    mat4 proj;
+    vec4 position;
+} u_camera;
+
+layout(set = 1, binding = 0, std430) readonly buffer SObjectTransforms {
+    ObjectTransforms s_objects[];
+};
+
+// Storage buffer для индексов объектов экземпляров (области всех активных кадров)
+layout(set = 1, binding = 1, std430) readonly buffer SInstanceIndices {
+    uint s_instances[];
+};
+
+vec3 oct_decode(vec2 e)
+{
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-v.z, 0.0);
+    v.xy += vec2(v.x >= 0.0 ? -t : t, v.y >= 0.0 ? -t : t);
+    return normalize(v);
+}
+
+void main()
+{
+    // Индекс объекта экземпляра (gl_InstanceIndex учитывает смещение области кадра)
+    uint obj_index = s_instances[gl_InstanceIndex];
+
+    vec3 position = VERTEX_FORMAT == 2 ? in_position * pc_push.pos_scale.xyz + pc_push.pos_offset.xyz : in_position;
+    vec3 normal = VERTEX_FORMAT == 0 ? in_normal : oct_decode(in_normal.xy);
+
+    mat4 model = s_objects[obj_index].model;
+    mat3 normal_mat = mat3(s_objects[obj_index].normals);
+
+    vec4 world_pos = model * vec4(position, 1.0);
+
+    vs_out.uv = in_uv;
+    vs_out.color = in_color.rgb;
+    vs_out.normal = normal_mat * normal;
+    vs_out.position = world_pos.xyz;
+    gl_Position = u_camera.proj * u_camera.view * world_pos;
+}
\ No newline at end of file
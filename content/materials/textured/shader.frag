@@ -3,8 +3,10 @@
 #extension GL_EXT_scalar_block_layout : enable
 
 // Константы
-#define MAX_OBJECTS 1000
-#define MAX_MATERIALS 100
+#define TEXTURE_SAMPLERS 6
+
+// Константы специализации (задаются при создании конвейера материала)
+layout(constant_id = 1) const uint TEXTURE_TABLE_SIZE = 4096;
 
 // Входные данные фрагмента
 layout (location = 0) in VS_OUT {
@@ -21,11 +23,31 @@ layout(push_constant) uniform PushConstants {
     uint obj_index;
 } pc_push;
 
-// Текстуры объекта
-layout(set = 3, binding = 0) uniform sampler2D t_color[MAX_MATERIALS];
+// Индексы текстур одиночного материала в глобальной таблице и индексы семплеров (по типу текстуры)
+struct MaterialTextures {
+    uint textures[8];
+    uint samplers[8];
+};
+
+// Storage buffer для индексов текстур материалов
+layout(set = 2, binding = 2, std430) readonly buffer SMaterialTextures {
+    MaterialTextures s_material_textures[];
+};
+
+// Глобальная таблица текстур (общая для всех материалов) и семплеры
+layout(set = 3, binding = 0) uniform texture2D t_textures[TEXTURE_TABLE_SIZE];
+layout(set = 3, binding = 1) uniform sampler t_samplers[TEXTURE_SAMPLERS];
+
+// Выборка из текстуры материала заданного типа (индексы одинаковы для всего вызова отрисовки)
+vec4 sample_texture(uint type, vec2 uv)
+{
+    uint texture_id = s_material_textures[pc_push.mat_index].textures[type];
+    uint sampler_id = s_material_textures[pc_push.mat_index].samplers[type];
+    return texture(sampler2D(t_textures[texture_id], t_samplers[sampler_id]), uv);
+}
 
 void main()
 {
-    vec4 tex_color = texture(t_color[pc_push.mat_index], fs_in.uv);
+    vec4 tex_color = sample_texture(0u, fs_in.uv);
     color = vec4(tex_color.rgb, 1.0);
 }
\ No newline at end of file
@@ -2,8 +2,9 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_EXT_scalar_block_layout : enable
 
-// Константы
-#define MAX_OBJECTS 1000
+// Константы специализации (задаются при создании конвейера материала)
+// Формат вершин: 0 - полный, 1 - упакованный, 2 - упакованный с квантованным положением
+layout(constant_id = 3) const uint VERTEX_FORMAT = 0;
 
 // Входные данные вершины
 layout(location = 0) in vec3 in_position;
@@ -21,6 +22,8 @@ layout (location = 0) out VS_OUT {
 layout(push_constant) uniform PushConstants {
     uint mat_index;
     uint obj_index;
+    vec4 pos_offset;
+    vec4 pos_scale;
 } pc_push;
 
 // Параметры трансформаций одиночного объекта
@@ -38,12 +41,15 @@ layout(set = 0, binding = 0, std140) uniform UCamera {
 
 // Storage buffer для матриц объектов
 layout(set = 1, binding = 0, std430) readonly buffer SObjectTransforms {
-    ObjectTransforms s_objects[MAX_OBJECTS];
+    ObjectTransforms s_objects[];
 };
 
 void main()
 {
-    gl_Position = u_camera.proj * u_camera.view * s_objects[pc_push.obj_index].model * vec4(in_position, 1.0);
+    // Положение (квантованное восстанавливается по AABB mesh'а)
+    vec3 position = VERTEX_FORMAT == 2 ? in_position * pc_push.pos_scale.xyz + pc_push.pos_offset.xyz : in_position;
+
+    gl_Position = u_camera.proj * u_camera.view * s_objects[pc_push.obj_index].model * vec4(position, 1.0);
     vs_out.color = in_color.rgb;
     vs_out.uv = in_uv;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include <nasral/logging/logger.h>
+#include <nasral/profiling/profiler.h>
 #include <nasral/resources/resource_manager.h>
 #include <nasral/rendering/renderer.h>
 #include <nasral/rendering/mesh_instance.h>
@@ -9,11 +10,27 @@ namespace nasral
     class Engine
     {
     public:
+        // Только для тестирования
+        struct TestSceneConfig
+        {
+            uint32_t node_count = 2;                                        // Кол-во узлов (сетка стульев)
+            bool instanced = false;                                         // Использовать instanced-варианты материалов
+            uint32_t layers = 1;                                            // Кол-во слоев сетки по глубине (слои перекрывают друг друга)
+            uint32_t material_variants = 0;                                 // Кол-во вариантов Phong материала (ресурсы "<путь>:vN", 0 - без вариантов)
+            bool vertex_tangents = false;                                   // Касательные из вершин вместо геометрического шейдера
+            uint32_t light_count = 2;                                       // Кол-во источников света (первые два - без ограничения радиуса)
+            float light_radius = 2.0f;                                      // Радиус остальных источников (распределены по объему сцены)
+            uint32_t texture_materials = 0;                                 // Кол-во Phong материалов со своей парой встроенных текстур ("<путь>:vN")
+            bool texture_swaps = false;                                     // Менять основную текстуру этих материалов каждый кадр
+        };
+
         struct Config
         {
             logging::LoggingConfig log;
+            profiling::ProfilingConfig profiling;
             resources::ResourceConfig resources;
             rendering::RenderingConfig rendering;
+            TestSceneConfig test;
         };
 
         class TestNode
@@ -104,16 +121,21 @@ namespace nasral
 
     protected:
         // Только для тестирования
-        void init_test_scene();
+        void init_test_scene(const TestSceneConfig& config);
 
     private:
         logging::Logger::Ptr logger_;
         resources::ResourceManager::Ptr resource_manager_;
         rendering::Renderer::Ptr renderer_;
+        std::string trace_file_;
 
         // Только для тестирования
         std::vector<TestNode> test_scene_nodes_;
         std::vector<LightSource> test_light_sources_;
+        std::vector<uint32_t> test_texture_materials_;
+        std::vector<resources::Ref> test_texture_refs_;
+        bool test_texture_swaps_ = false;
+        uint32_t test_texture_parity_ = 0;
         rendering::CameraUniforms camera_uniforms_;
     };
 }
@@ -0,0 +1,37 @@
+#pragma once
+#include <nasral/profiling/profiling_types.h>
+
+namespace nasral::profiling
+{
+    /**
+     * Зона замера времени CPU (от создания до end() либо разрушения)
+     *
+     * @details Зона пишется в кольцевой буфер своего потока без блокировок (буфер создается при первой зоне потока).
+     * Имя зоны не копируется и должно существовать до сохранения трассировки (строковый литерал), уточнение
+     * (например, путь ресурса) копируется с усечением до kDetailSize - 1 байт по границе символа UTF-8
+     */
+    class Zone
+    {
+    public:
+        static constexpr size_t kDetailSize = 48;
+
+        explicit Zone(const char* name, std::string_view detail = {}) noexcept;
+        ~Zone();
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+        void end() noexcept;
+
+    private:
+        const char* name_;
+        int64_t start_ns_;
+        bool active_;
+        char detail_[kDetailSize];
+    };
+
+    void configure(const ProfilingConfig& config);
+    void set_thread_name(const std::string& name);
+    void save_trace(const std::string& path);
+    [[nodiscard]] bool is_enabled() noexcept;
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <string>
+#include <nasral/core_types.h>
+
+namespace nasral::profiling
+{
+    struct ProfilingConfig
+    {
+        bool enabled = false;                                               // Запись зон CPU
+        std::string trace_file;                                             // Файл трассировки (Chrome trace_event JSON, сохраняется при завершении)
+        uint32_t zones_per_thread = 65536;                                  // Емкость кольцевого буфера зон каждого потока (старые зоны перезаписываются)
+    };
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <nasral/rendering/rendering_types.h>
+#include <vulkan/utils/buffer.hpp>
+
+namespace nasral::rendering
+{
+    class Renderer;
+    class FrameRingBuffer
+    {
+    public:
+        typedef std::unique_ptr<FrameRingBuffer> Ptr;
+
+        FrameRingBuffer(const Renderer* renderer,
+                        vk::DeviceSize stride,
+                        uint32_t capacity,
+                        uint32_t frames,
+                        vk::BufferUsageFlags usage,
+                        vk::DeviceSize offset_alignment,
+                        bool device_local = false);
+        ~FrameRingBuffer() = default;
+
+        FrameRingBuffer(const FrameRingBuffer&) = delete;
+        FrameRingBuffer& operator=(const FrameRingBuffer&) = delete;
+
+        void reserve(uint32_t capacity);
+        bool reallocate(std::vector<vk::utils::Buffer::Ptr>& retired);
+        void update(uint32_t index, const void* data, vk::DeviceSize size);
+        vk::DeviceSize flush(size_t frame_index, const vk::CommandBuffer& cmd_buffer);
+
+        template<typename T>
+        void update(const uint32_t index, const T& data){
+            update(index, &data, sizeof(T));
+        }
+
+        [[nodiscard]] const vk::Buffer& vk_buffer() const{
+            return buffer_->vk_buffer();
+        }
+        [[nodiscard]] bool is_device_local() const{
+            return device_local_;
+        }
+        [[nodiscard]] uint32_t capacity() const{
+            return capacity_;
+        }
+        [[nodiscard]] vk::DeviceSize region_size() const{
+            return region_size_;
+        }
+        [[nodiscard]] vk::DeviceSize region_offset(const size_t frame_index) const{
+            assert(frame_index < dirty_.size());
+            return region_size_ * frame_index;
+        }
+
+    private:
+        void allocate();
+
+    protected:
+        SafeHandle<const Renderer> renderer_;
+
+        // Буфер устройства (по области на каждый активный кадр, смещения областей выровнены)
+        vk::utils::Buffer::Ptr buffer_;
+        // Промежуточный буфер (только для буфера в памяти устройства, области совпадают с областями буфера)
+        vk::utils::Buffer::Ptr staging_;
+        vk::DeviceSize stride_;
+        vk::DeviceSize region_size_;
+
+        // Параметры создания буферов (для перевыделения при росте емкости)
+        vk::BufferUsageFlags usage_;
+        vk::DeviceSize offset_alignment_;
+        bool device_local_;
+
+        // Емкость копии CPU и емкость выделенных буферов (меньше, пока буферы не перевыделены)
+        uint32_t capacity_;
+        uint32_t allocated_;
+
+        // Копия данных в памяти CPU (источник для областей кадров)
+        std::vector<uint8_t> shadow_;
+        // Граница записанных элементов
+        uint32_t used_;
+
+        // Элементы, измененные после последнего переноса в область кадра (список и флаги, для каждого кадра)
+        std::vector<std::vector<uint32_t>> dirty_;
+        std::vector<std::vector<uint8_t>> dirty_flags_;
+        // Отрезки копирования из промежуточного буфера (смежные измененные элементы объединяются)
+        std::vector<vk::BufferCopy> copy_regions_;
+    };
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <nasral/rendering/rendering_types.h>
+
+namespace nasral::rendering
+{
+    class FrustumCuller
+    {
+    public:
+        struct Stats
+        {
+            uint32_t visible = 0;
+            uint32_t culled = 0;
+            double cull_time_ms = 0.0;
+        };
+
+        explicit FrustumCuller(size_t capacity);
+        ~FrustumCuller() = default;
+
+        FrustumCuller(const FrustumCuller&) = delete;
+        FrustumCuller& operator=(const FrustumCuller&) = delete;
+
+        void reserve(size_t capacity);
+        void set_sphere(uint32_t index, const glm::vec4& sphere);
+        void reset(uint32_t index);
+        void reset_all();
+        void cull(const glm::mat4& view_proj);
+
+        [[nodiscard]] bool is_visible(const uint32_t index) const{
+            assert(index < visible_.size());
+            return visible_[index] != 0;
+        }
+        [[nodiscard]] glm::vec4 sphere(const uint32_t index) const{
+            assert(index < r_.size());
+            return {x_[index], y_[index], z_[index], r_[index]};
+        }
+        [[nodiscard]] const Stats& stats() const{
+            return stats_;
+        }
+
+        [[nodiscard]] static std::array<glm::vec4, 6> extract_planes(const glm::mat4& view_proj);
+
+    private:
+        void cull_range(const std::array<glm::vec4, 6>& planes, size_t begin, size_t end);
+
+    protected:
+        // Ограничивающие сферы объектов в мировом пространстве (SoA, неактивные объекты имеют отрицательный радиус)
+        std::vector<float> x_;
+        std::vector<float> y_;
+        std::vector<float> z_;
+        std::vector<float> r_;
+
+        // Результат последнего отсечения (по байту на объект)
+        std::vector<uint8_t> visible_;
+
+        // Граница занятых индексов (кратна ширине SIMD блока)
+        size_t count_;
+
+        // Статистика последнего отсечения
+        Stats stats_;
+    };
+}
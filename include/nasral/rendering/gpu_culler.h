@@ -0,0 +1,133 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <nasral/rendering/rendering_types.h>
+#include <nasral/resources/ref.h>
+#include <vulkan/utils/buffer.hpp>
+#include <vulkan/utils/image.hpp>
+
+namespace nasral::rendering
+{
+    class Renderer;
+    class GpuProfiler;
+    class GpuCuller
+    {
+    public:
+        typedef std::unique_ptr<GpuCuller> Ptr;
+
+        // Кандидат на отсечение (объект и команда непрямой отрисовки, в которую он попадает при видимости)
+        struct Candidate
+        {
+            uint32_t obj_index = 0;
+            uint32_t command_index = 0;
+        };
+
+        // Пакет, кластеры объектов которого отсекаются на GPU (видимые кластеры дописываются в команды пакета)
+        struct MeshletBatch
+        {
+            vk::Buffer meshlet_buffer;
+            uint32_t meshlet_count = 0;
+            uint32_t first_candidate = 0;
+            uint32_t candidate_count = 0;
+            uint32_t first_command = 0;
+            uint32_t command_capacity = 0;
+        };
+
+        struct Stats
+        {
+            uint32_t candidates = 0;
+            uint32_t visible = 0;
+            uint32_t meshlets_tested = 0;
+            uint32_t meshlets_visible = 0;
+        };
+
+        GpuCuller(const Renderer* renderer, resources::ResourceManager* manager);
+        ~GpuCuller();
+
+        GpuCuller(const GpuCuller&) = delete;
+        GpuCuller& operator=(const GpuCuller&) = delete;
+
+        void refresh_framebuffers();
+        void reset_frames();
+        void reserve(uint32_t capacity, std::vector<vk::utils::Buffer::Ptr>& retired);
+        void update_frame_descriptors(size_t frame_index);
+        void set_view(const glm::mat4& view_proj, const glm::vec3& camera_position);
+        void set_frame_candidates(size_t frame_index, uint32_t candidate_count, uint32_t command_count, const std::vector<MeshletBatch>& meshlet_batches);
+        void read_back(size_t frame_index);
+        void cmd_build_pyramid(const vk::CommandBuffer& cmd_buffer, size_t framebuffer_index);
+        [[nodiscard]] vk::CommandBuffer cmd_cull(size_t frame_index, GpuProfiler* profiler = nullptr);
+
+        [[nodiscard]] bool is_ready() const{
+            return vk_cull_pipeline_ && vk_pyramid_pipeline_;
+        }
+        [[nodiscard]] bool is_meshlet_culling_ready() const{
+            return is_ready() && vk_meshlet_pipeline_;
+        }
+        [[nodiscard]] Candidate* candidates(const size_t frame_index) const{
+            return static_cast<Candidate*>(vk_candidates_->mapped_ptr()) + frame_index * capacity_;
+        }
+        [[nodiscard]] Candidate* meshlet_candidates(const size_t frame_index) const{
+            return static_cast<Candidate*>(vk_meshlet_candidates_->mapped_ptr()) + frame_index * capacity_;
+        }
+        [[nodiscard]] const Stats& stats() const{
+            return stats_;
+        }
+
+    private:
+        // Задание кадра (кандидаты и команды области кадра)
+        struct FrameWork
+        {
+            uint32_t candidate_count = 0;
+            uint32_t command_count = 0;
+            std::vector<MeshletBatch> meshlet_batches;
+        };
+
+        void init_candidates();
+        void init_pyramid();
+        void init_descriptors();
+
+    protected:
+        SafeHandle<const Renderer> renderer_;
+
+        // Вычислительные shader'ы (отсечение объектов, кластеров и построение пирамиды глубины) и их конвейеры
+        resources::Ref cull_shader_res_;
+        resources::Ref meshlet_shader_res_;
+        resources::Ref pyramid_shader_res_;
+        vk::UniquePipeline vk_cull_pipeline_;
+        vk::UniquePipeline vk_meshlet_pipeline_;
+        vk::UniquePipeline vk_pyramid_pipeline_;
+
+        // Параметры отсечения и кандидаты объектов и кластеров (по области на каждый активный кадр)
+        // Области кадров кандидатов, команд и экземпляров - по емкости буферов отрисовки renderer'а
+        uint32_t capacity_;
+        vk::utils::Buffer::Ptr vk_ubo_culling_;
+        vk::utils::Buffer::Ptr vk_candidates_;
+        vk::utils::Buffer::Ptr vk_meshlet_candidates_;
+
+        // Пирамида глубины (максимум глубины по области, уровни доступны по отдельности для записи)
+        vk::utils::Image::Ptr vk_pyramid_;
+        std::vector<vk::UniqueImageView> vk_pyramid_levels_;
+        std::vector<vk::Extent2D> pyramid_extents_;
+        bool pyramid_valid_;
+
+        // Представления глубины вложений кадровых буферов (только аспект глубины, для чтения в shader'е)
+        std::vector<vk::UniqueImageView> vk_depth_views_;
+
+        // Дескрипторные наборы (отсечение - по набору на кадр, пирамида - по набору на кадровый буфер и уровень)
+        std::vector<vk::UniqueDescriptorSet> vk_dsets_cull_;
+        std::vector<vk::UniqueDescriptorSet> vk_dsets_pyramid_depth_;
+        std::vector<vk::UniqueDescriptorSet> vk_dsets_pyramid_levels_;
+        // Наборы кластеров (MAX_MESHLET_BATCHES на каждый кадр, обновляются при записи команд кадра)
+        std::vector<vk::UniqueDescriptorSet> vk_dsets_meshlets_;
+
+        // Командные буферы вычислительного прохода (по одному на кадр)
+        std::vector<vk::UniqueCommandBuffer> vk_command_buffers_;
+
+        // Матрицы вида-проекции (текущего кадра и кадра, по глубине которого построена пирамида) и положение камеры
+        glm::mat4 view_proj_;
+        glm::mat4 pyramid_view_proj_;
+        glm::vec3 camera_position_;
+
+        std::vector<FrameWork> frames_;
+        Stats stats_;
+    };
+}
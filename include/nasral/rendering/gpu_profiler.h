@@ -0,0 +1,88 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <nasral/rendering/rendering_types.h>
+
+namespace nasral::rendering
+{
+    class Renderer;
+    class GpuProfiler
+    {
+    public:
+        typedef std::unique_ptr<GpuProfiler> Ptr;
+
+        GpuProfiler(const Renderer* renderer, uint32_t max_scopes);
+        ~GpuProfiler() = default;
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        void read_back(size_t frame_index);
+        void reset_frames();
+        void cmd_begin_frame(const vk::CommandBuffer& cmd_buffer, size_t frame_index);
+        void set_cmd_buffer(const vk::CommandBuffer& cmd_buffer);
+        void cmd_end_frame();
+        void cmd_begin_scope(const std::string& name);
+        void cmd_end_scope();
+        void save(const std::string& path) const;
+
+        [[nodiscard]] bool is_supported() const{
+            return !vk_query_pools_.empty();
+        }
+        [[nodiscard]] const std::vector<GpuTiming>& timings() const{
+            return timings_;
+        }
+        [[nodiscard]] size_t timings_frame() const{
+            return timings_frame_;
+        }
+
+    private:
+        // Область замера (временные метки начала и конца - пара запросов с индексом области)
+        struct Scope
+        {
+            std::string name;
+            uint32_t depth = 0;
+        };
+
+        // Области кадра (открытые области - стек индексов, не поместившиеся в пул области не замеряются)
+        struct FrameScopes
+        {
+            std::vector<Scope> scopes;
+            std::vector<std::optional<uint32_t>> stack;
+            size_t frame = 0;
+            bool submitted = false;
+        };
+
+        // Итог замеров области за время работы
+        struct Summary
+        {
+            std::string name;
+            uint32_t depth = 0;
+            uint64_t count = 0;
+            double total_ms = 0.0;
+            double min_ms = std::numeric_limits<double>::max();
+            double max_ms = 0.0;
+        };
+
+    protected:
+        SafeHandle<const Renderer> renderer_;
+
+        // Пулы запросов временных меток (по пулу на каждый активный кадр, пусто - замеры не поддерживаются)
+        std::vector<vk::UniqueQueryPool> vk_query_pools_;
+        uint32_t max_scopes_;
+        // Длительность такта счетчика (нс) и маска значащих бит временной метки
+        double timestamp_period_;
+        uint64_t timestamp_mask_;
+
+        // Области кадров и буфер команд, в который пишутся метки записываемого кадра
+        std::vector<FrameScopes> frames_;
+        vk::CommandBuffer cmd_buffer_;
+        size_t frame_index_;
+
+        // Результаты последнего прочитанного кадра и итоги по областям (в порядке первого появления)
+        std::vector<uint64_t> results_;
+        std::vector<GpuTiming> timings_;
+        size_t timings_frame_;
+        std::vector<Summary> summaries_;
+        std::unordered_map<std::string, size_t> summary_indices_;
+    };
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <nasral/rendering/rendering_types.h>
+
+namespace nasral::rendering
+{
+    class LightClusterer
+    {
+    public:
+        struct Stats
+        {
+            uint32_t lights = 0;
+            uint32_t assignments = 0;
+            uint32_t max_per_cluster = 0;
+            bool overflow = false;
+            double build_time_ms = 0.0;
+        };
+
+        explicit LightClusterer(size_t capacity);
+        ~LightClusterer() = default;
+
+        LightClusterer(const LightClusterer&) = delete;
+        LightClusterer& operator=(const LightClusterer&) = delete;
+
+        void reserve(size_t capacity);
+        void set_light(uint32_t index, const glm::vec4& sphere);
+        void build(const std::vector<uint32_t>& active_ids,
+                   const glm::mat4& view,
+                   const glm::mat4& projection,
+                   const glm::uvec2& extent,
+                   bool opengl_style);
+        void write(void* dst) const;
+
+        [[nodiscard]] static vk::DeviceSize data_size(){
+            return sizeof(LightClusterHeader) + sizeof(glm::uvec2) * kClusterCount + sizeof(uint32_t) * MAX_LIGHT_CLUSTER_INDICES;
+        }
+        [[nodiscard]] const Stats& stats() const{
+            return stats_;
+        }
+
+    private:
+        // Кол-во кластеров сетки (ячейки экрана по слоям глубины)
+        static constexpr uint32_t kClusterCount = LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z;
+
+        // Диапазон кластеров источника (включительно)
+        struct LightRange
+        {
+            uint32_t index = 0;
+            glm::uvec3 min = glm::uvec3(0);
+            glm::uvec3 max = glm::uvec3(0);
+        };
+
+    protected:
+        // Ограничивающие сферы источников в мировом пространстве (нулевой радиус - источник без ограничения)
+        std::vector<glm::vec4> spheres_;
+
+        // Результат последнего построения: параметры сетки, отрезки кластеров (начало, кол-во) и индексы источников
+        LightClusterHeader header_;
+        std::vector<glm::uvec2> ranges_;
+        std::vector<uint32_t> indices_;
+
+        // Диапазоны кластеров активных источников и счетчики заполнения кластеров (промежуточные данные построения)
+        std::vector<LightRange> light_ranges_;
+        std::vector<uint32_t> cursors_;
+
+        // Статистика последнего построения
+        Stats stats_;
+    };
+}
@@ -38,10 +38,13 @@ namespace nasral::rendering
         void set_settings(const MaterialUniforms& settings);
         void request_resources();
         void release_resources();
+        void update_render_handles();
+        void use_vertex_format(VertexFormat format);
 
-        [[nodiscard]] const Handles::Material& mat_render_handles() const;
+        [[nodiscard]] Handles::Material mat_render_handles(VertexFormat format = VertexFormat::eFull) const;
         [[nodiscard]] const Handles::Texture& tex_render_handles(TextureType type) const;
         [[nodiscard]] TextureSamplerType tex_sampler(TextureType type) const;
+        [[nodiscard]] uint32_t texture_features() const;
         [[nodiscard]] const std::optional<MaterialUniforms>& settings() const;
         [[nodiscard]] static resources::BuiltinResources builtin_tex_for_type(TextureType type);
 
@@ -52,7 +55,10 @@ namespace nasral::rendering
     protected:
         MaterialType material_type_ = MaterialType::eDummy;
         resources::Ref material_ref_;
-        Handles::Material material_handles_ = {};
+        // Конвейеры по форматам вершин (основной либо вариант по заданным текстурам) и форматы, ожидающие выбора варианта
+        std::array<Handles::Material, static_cast<uint32_t>(VertexFormat::TOTAL)> material_handles_ = {};
+        uint32_t vertex_formats_ = 1u << static_cast<uint32_t>(VertexFormat::eFull);
+        uint32_t variants_pending_ = 0;
         std::array<resources::Ref, static_cast<uint32_t>(TextureType::TOTAL)> texture_refs_;
         std::array<Handles::Texture, static_cast<uint32_t>(TextureType::TOTAL)> texture_handles_;
         std::array<TextureSamplerType, static_cast<uint32_t>(TextureType::TOTAL)> texture_samplers_;
@@ -28,6 +28,7 @@ namespace nasral::rendering
         void release_resources();
 
         [[nodiscard]] const Handles::Mesh& mesh_render_handles() const;
+        [[nodiscard]] const Bounds& mesh_bounds() const;
 
     private:
         void bind_callbacks();
@@ -36,6 +37,7 @@ namespace nasral::rendering
     protected:
         resources::Ref mesh_ref_;
         Handles::Mesh mesh_handles_ = {};
+        Bounds mesh_bounds_ = {};
     };
 
     static_assert(std::is_move_constructible_v<MeshInstance>, "MeshInstance must be movable-constructible");
@@ -0,0 +1,67 @@
+#pragma once
+#include <nasral/rendering/rendering_types.h>
+
+namespace nasral::rendering
+{
+    class RenderQueue
+    {
+    public:
+        struct Packet
+        {
+            Handles::Material material = {};
+            Handles::Mesh mesh = {};
+            uint32_t mat_index = 0;
+            uint32_t obj_index = 0;
+
+            // Пакеты с общим конвейером, материалом и геометрией (и её уровнем детализации) могут быть отрисованы одним вызовом
+            [[nodiscard]] bool shares_state(const Packet& other) const{
+                return material.pipeline == other.material.pipeline
+                    && mat_index == other.mat_index
+                    && mesh.vertex_buffer == other.mesh.vertex_buffer
+                    && mesh.index_buffer == other.mesh.index_buffer
+                    && mesh.first_index == other.mesh.first_index;
+            }
+        };
+
+        RenderQueue() = default;
+        ~RenderQueue() = default;
+
+        RenderQueue(const RenderQueue&) = delete;
+        RenderQueue& operator=(const RenderQueue&) = delete;
+
+        void push(const Handles::Material& material, uint32_t mat_index, const Handles::Mesh& mesh, uint32_t obj_index, float depth);
+        void sort();
+        void clear();
+
+        [[nodiscard]] size_t size() const{
+            return packets_.size();
+        }
+        [[nodiscard]] bool empty() const{
+            return packets_.empty();
+        }
+        [[nodiscard]] const Packet& packet(const size_t index) const{
+            assert(index < order_.size());
+            return packets_[order_[index]];
+        }
+
+    private:
+        [[nodiscard]] uint16_t pipeline_id(const vk::Pipeline& pipeline);
+        [[nodiscard]] uint16_t mesh_id(const vk::Buffer& vertex_buffer, uint32_t lod);
+        [[nodiscard]] static uint64_t make_key(uint16_t pipeline, uint32_t mat_index, uint16_t mesh, float depth);
+
+    protected:
+        // Пакеты отрисовки и их ключи сортировки (в порядке добавления)
+        std::vector<Packet> packets_;
+        std::vector<uint64_t> keys_;
+
+        // Порядок пакетов после сортировки (и временные буферы поразрядной сортировки)
+        std::vector<uint32_t> order_;
+        std::vector<uint32_t> order_swap_;
+        std::vector<uint64_t> keys_sorted_;
+        std::vector<uint64_t> keys_swap_;
+
+        // Компактные идентификаторы конвейеров и геометрии (для старших разрядов ключа)
+        std::unordered_map<VkPipeline, uint16_t> pipeline_ids_;
+        std::unordered_map<VkBuffer, uint16_t> mesh_ids_;
+    };
+}
@@ -2,8 +2,16 @@
 #include <vulkan/vulkan.hpp>
 #include <nasral/rendering/rendering_types.h>
 #include <nasral/rendering/material_instance.h>
+#include <nasral/rendering/render_queue.h>
+#include <nasral/rendering/frustum_culler.h>
+#include <nasral/rendering/light_clusterer.h>
+#include <nasral/rendering/gpu_culler.h>
+#include <nasral/rendering/gpu_profiler.h>
+#include <nasral/rendering/frame_ring_buffer.h>
+#include <nasral/threading/thread_pool.h>
 #include <vulkan/utils/framebuffer.hpp>
 #include <vulkan/utils/buffer.hpp>
+#include <vulkan/utils/image.hpp>
 #include <vulkan/utils/uniform_layout.hpp>
 
 namespace nasral{class Engine;}
@@ -15,6 +23,7 @@ namespace nasral::rendering
     public:
         typedef std::unique_ptr<Renderer> Ptr;
         typedef vk::UniqueHandle<vk::DebugReportCallbackEXT, vk::detail::DispatchLoaderDynamic> DebugReportCallback;
+        typedef std::function<void(size_t begin, size_t end)> RecordFn;
 
         enum class CommandGroup : size_t
         {
@@ -31,16 +40,32 @@ namespace nasral::rendering
         void cmd_bind_material(const Handles::Material& handles, uint32_t mat_index);
         void cmd_bind_frame_descriptors();
         void cmd_draw_mesh(const Handles::Mesh& handles, uint32_t obj_index);
+        void cmd_draw_mesh_instanced(const Handles::Mesh& handles, const uint32_t* obj_indices, uint32_t count);
+        void cmd_draw_mesh_indirect(const Handles::Mesh& handles, uint32_t first_command, uint32_t count);
+        void cmd_record_parallel(size_t count, const RecordFn& record);
+        void cmd_draw_queue();
         void cmd_wait_for_frame() const;
+        void cmd_begin_gpu_scope(const std::string& name);
+        void cmd_end_gpu_scope();
+        void save_gpu_profile(const std::string& path) const;
 
         void request_surface_refresh();
+        void queue_draw(const Handles::Material& material, uint32_t mat_index, const Handles::Mesh& mesh, uint32_t obj_index, float depth);
 
-        void update_cam_ubo(uint32_t index, const CameraUniforms& uniforms) const;
+        void update_cam_ubo(uint32_t index, const CameraUniforms& uniforms);
         void update_obj_ubo(uint32_t index, const ObjectTransformUniforms& uniforms) const;
+        void update_obj_bounds(uint32_t index, const glm::vec4& sphere, const glm::mat4& model);
+        void cull_objects(const glm::mat4& view_proj);
+        void init_gpu_culling(resources::ResourceManager* manager);
+        void release_gpu_culling();
         void update_material_ubo(uint32_t index, const MaterialPhongUniforms& uniforms) const;
         void update_material_ubo(uint32_t index, const MaterialPbrUniforms& uniforms) const;
-        void update_material_tex(uint32_t index, const TextureBindingInfo& info) const;
-        void update_light_ubo(uint32_t index, const LightUniforms& uniforms) const;
+        void update_material_tex(uint32_t index, const MaterialTextureUniforms& uniforms) const;
+        void update_light_ubo(uint32_t index, const LightUniforms& uniforms);
+
+        [[nodiscard]] vk::UniquePipeline create_graphics_pipeline(const vk::GraphicsPipelineCreateInfo& info) const;
+        [[nodiscard]] vk::UniquePipeline create_compute_pipeline(const UniformLayoutType& layout, const vk::ShaderModule& shader_module) const;
+        [[nodiscard]] std::future<void> submit_pipeline_task(threading::ThreadPool::Task task) const;
 
         [[nodiscard]] uint32_t obj_id_acquire_unsafe();
         [[nodiscard]] uint32_t obj_id_acquire();
@@ -76,6 +101,26 @@ namespace nasral::rendering
         [[nodiscard]] size_t current_frame() const{
             return current_frame_;
         }
+        [[nodiscard]] size_t last_frame_index() const{
+            const auto frames = static_cast<size_t>(config_.max_frames_in_flight);
+            return (current_frame_ + frames - 1) % frames;
+        }
+        [[nodiscard]] bool is_obj_visible(const uint32_t index) const{
+            return !config_.frustum_culling || frustum_culler_.is_visible(index);
+        }
+        [[nodiscard]] bool is_headless() const{
+            return config_.headless;
+        }
+        [[nodiscard]] const FrameStats& frame_stats() const{
+            return frame_stats_;
+        }
+        [[nodiscard]] const std::vector<GpuTiming>& gpu_timings() const{
+            static const std::vector<GpuTiming> empty;
+            return gpu_profiler_ ? gpu_profiler_->timings() : empty;
+        }
+        [[nodiscard]] uint32_t pipelines_created() const{
+            return pipelines_created_.load(std::memory_order_relaxed);
+        }
         [[nodiscard]] const SafeHandle<const Engine>& engine() const{
             return engine_;
         }
@@ -88,6 +133,9 @@ namespace nasral::rendering
         [[nodiscard]] const vk::utils::Device::Ptr& vk_device() const{
             return vk_device_;
         }
+        [[nodiscard]] const vk::PipelineCache& vk_pipeline_cache() const{
+            return *vk_pipeline_cache_;
+        }
         [[nodiscard]] const vk::RenderPass& vk_render_pass() const{
             return *vk_render_pass_;
         }
@@ -97,6 +145,33 @@ namespace nasral::rendering
         [[nodiscard]] const vk::utils::Framebuffer& vk_framebuffer(const size_t index) const{
             return *vk_framebuffers_[index];
         }
+        [[nodiscard]] size_t vk_framebuffer_count() const{
+            return vk_framebuffers_.size();
+        }
+        [[nodiscard]] const vk::Fence& vk_frame_fence(const size_t index) const{
+            return *vk_frame_fence_[index];
+        }
+        [[nodiscard]] const vk::Fence& vk_last_frame_fence() const{
+            return *vk_frame_fence_[last_frame_index()];
+        }
+        [[nodiscard]] const FrameRingBuffer& vk_objects_transforms() const{
+            return *vk_ubo_objects_transforms_;
+        }
+        [[nodiscard]] const FrameRingBuffer& vk_objects_bounds() const{
+            return *vk_ubo_objects_bounds_;
+        }
+        [[nodiscard]] const vk::utils::Buffer& vk_instance_indices() const{
+            return *vk_ubo_instance_indices_;
+        }
+        [[nodiscard]] const vk::utils::Buffer& vk_indirect_commands() const{
+            return *vk_indirect_commands_;
+        }
+        [[nodiscard]] const vk::utils::Buffer& vk_indirect_counts() const{
+            return *vk_indirect_counts_;
+        }
+        [[nodiscard]] uint32_t draw_capacity() const{
+            return draw_capacity_;
+        }
         [[nodiscard]] const vk::Sampler& vk_texture_sampler(const TextureSamplerType& type) const{
             return *vk_texture_samplers_[to<size_t>(type)];
         }
@@ -123,51 +198,78 @@ namespace nasral::rendering
             void* user_data);
 
     private:
+        // Пакет непрямой отрисовки (отрезок отсортированной очереди с общим материалом и геометрией)
+        struct IndirectBatch
+        {
+            uint32_t first_packet = 0;
+            uint32_t packet_count = 0;
+            uint32_t first_command = 0;
+            uint32_t command_count = 0;
+        };
+
+        // Контекст записи команд (основной буфер либо вторичный буфер потока записи)
+        struct RecordingContext
+        {
+            vk::CommandBuffer cmd_buffer = VK_NULL_HANDLE;
+            FrameStats stats = {};
+
+            // Текущее состояние буфера команд (для пропуска избыточных команд)
+            vk::Pipeline pipeline = VK_NULL_HANDLE;
+            vk::Buffer vertex_buffer = VK_NULL_HANDLE;
+            vk::Buffer index_buffer = VK_NULL_HANDLE;
+            std::optional<uint32_t> mat_index = std::nullopt;
+            bool instanced = false;
+            bool viewport_set = false;
+
+            void reset_state(){
+                pipeline = VK_NULL_HANDLE;
+                vertex_buffer = VK_NULL_HANDLE;
+                index_buffer = VK_NULL_HANDLE;
+                mat_index = std::nullopt;
+                instanced = false;
+                viewport_set = false;
+            }
+        };
+
         [[nodiscard]] const logging::Logger* logger() const;
+        [[nodiscard]] RecordingContext& recording_context();
+        [[nodiscard]] uint32_t select_lod(const Handles::Mesh& mesh, uint32_t obj_index) const;
+        void cmd_bind_mesh(RecordingContext& context, const Handles::Mesh& handles) const;
+        void collect_frame_stats();
+        void build_indirect_batches();
+        void build_light_clusters(size_t frame_index);
+        [[nodiscard]] uint32_t texture_id_acquire_unsafe(const Handles::Texture& texture);
+        void texture_id_release_unsafe(uint32_t id);
+        void texture_writes_flush_unsafe();
+        void texture_writes_apply_unsafe(size_t frame_index);
+        void write_texture_table(const vk::DescriptorSet& dset, std::vector<std::pair<uint32_t, vk::DescriptorImageInfo>>& elements);
 
         void init_vk_instance();
         void init_vk_loader();
         void init_vk_debug_callback();
         void init_vk_surface();
         void init_vk_device();
+        void init_vk_pipeline_cache();
         void init_vk_render_passes();
         void init_vk_swap_chain();
         void init_vk_framebuffers();
+        void init_vk_offscreen_framebuffers();
         void init_vk_uniform_layouts();
         void init_vk_texture_samplers();
         void init_vk_uniforms();
+        void init_vk_texture_table();
+        void init_vk_draw_buffers();
         void init_vk_command_buffers();
+        void init_vk_recording_pools();
         void init_vk_sync_objects();
         void init_index_pools();
         void refresh_vk_surface();
+        void update_frame_descriptors(size_t frame_index);
+        void grow_frame_buffers(size_t frame_index);
+        void save_vk_pipeline_cache() const;
+        void on_pipeline_created(const std::chrono::steady_clock::time_point& started) const;
 
-        template<typename T>
-        [[nodiscard]] vk::DeviceSize aligned_ubo_size() const{
-            assert(vk_device_);
-            auto& d = vk_device_->physical_device();
-            static const auto alignment = d.getProperties().limits.minUniformBufferOffsetAlignment;
-            return size_align(sizeof(T), alignment);
-        }
-
-        template<typename T>
-        [[nodiscard]] vk::DeviceSize aligned_sbo_size() const{
-            assert(vk_device_);
-            auto& d = vk_device_->physical_device();
-            static const auto alignment = d.getProperties().limits.minStorageBufferOffsetAlignment;
-            return size_align(sizeof(T), alignment);
-        }
-
-        template<typename T>
-        [[nodiscard]] vk::DeviceSize ubo_offset(const uint32_t index) const{
-            assert(vk_device_);
-            return aligned_ubo_size<T>() * index;
-        }
-
-        template<typename T>
-        [[nodiscard]] vk::DeviceSize sbo_offset(const uint32_t index) const{
-            assert(vk_device_);
-            return aligned_sbo_size<T>() * index;
-        }
+        [[nodiscard]] vk::CommandBuffer cmd_upload_frame_uniforms(size_t frame_index);
 
     protected:
         SafeHandle<const Engine> engine_;
@@ -183,48 +285,139 @@ namespace nasral::rendering
         vk::detail::DispatchLoaderDynamic vk_dispatch_loader_;
         vk::UniqueSurfaceKHR vk_surface_;
         vk::utils::Device::Ptr vk_device_;
+        vk::UniquePipelineCache vk_pipeline_cache_;
         vk::UniqueRenderPass vk_render_pass_;
         vk::UniqueSwapchainKHR vk_swap_chain_;
         std::vector<vk::utils::Framebuffer::Ptr> vk_framebuffers_;
 
+        // Статистика создания конвейеров (кеш загружен с диска, кол-во и суммарное время создания)
+        bool pipeline_cache_warm_;
+        mutable std::atomic<uint32_t> pipelines_created_;
+        mutable std::atomic<uint64_t> pipelines_create_time_us_;
+        // Пул потоков создания конвейеров материалов (кеш конвейеров синхронизирован внутренне)
+        threading::ThreadPool::Ptr compile_pool_;
+
         // Макеты конвейеров
         std::vector<vk::utils::UniformLayout::Ptr> vk_uniform_layouts_;
         // Семплеры текстур
         std::array<vk::UniqueSampler, static_cast<size_t>(TextureSamplerType::TOTAL)> vk_texture_samplers_;
-        // Дескрипторные наборы (камера, трансформации и материалы объектов, текстуры объектов)
-        vk::UniqueDescriptorSet vk_dset_view_;
-        vk::UniqueDescriptorSet vk_dset_objects_uniforms_;
-        vk::UniqueDescriptorSet vk_dset_material_uniforms_;
-        vk::UniqueDescriptorSet vk_dset_material_textures_;
-        vk::UniqueDescriptorSet vk_dset_light_sources_;
-        // Uniform буферы объектов (камера, трансформации, материалы, источники света)
-        vk::utils::Buffer::Ptr vk_ubo_view_;
-        vk::utils::Buffer::Ptr vk_ubo_objects_transforms_;
-        vk::utils::Buffer::Ptr vk_ubo_materials_phong_;
-        vk::utils::Buffer::Ptr vk_ubo_materials_pbr_;
-        vk::utils::Buffer::Ptr vk_ubo_light_sources_;
-        vk::utils::Buffer::Ptr vk_ubo_light_indices_;
+        // Дескрипторные наборы (камера, трансформации и материалы объектов, источники света - по набору на активный кадр)
+        std::vector<vk::UniqueDescriptorSet> vk_dsets_view_;
+        std::vector<vk::UniqueDescriptorSet> vk_dsets_objects_uniforms_;
+        std::vector<vk::UniqueDescriptorSet> vk_dsets_material_uniforms_;
+        std::vector<vk::UniqueDescriptorSet> vk_dsets_light_sources_;
+        // Дескрипторные наборы глобальной таблицы текстур и семплеров (общий для всех кадров при записи
+        // во время исполнения кадров, иначе - по набору на каждый активный кадр)
+        std::vector<vk::UniqueDescriptorSet> vk_dsets_material_textures_;
+        // Текстура по умолчанию (элемент 0 таблицы, для текстур материалов, которые еще не загружены)
+        vk::utils::Image::Ptr vk_fallback_texture_;
+        // Uniform буферы объектов (камера, трансформации и ограничивающие сферы, материалы, источники света)
+        // Кольцевые буферы: запись идет в копию CPU, в область кадра изменения переносятся при его завершении
+        FrameRingBuffer::Ptr vk_ubo_view_;
+        FrameRingBuffer::Ptr vk_ubo_objects_transforms_;
+        FrameRingBuffer::Ptr vk_ubo_objects_bounds_;
+        FrameRingBuffer::Ptr vk_ubo_materials_phong_;
+        FrameRingBuffer::Ptr vk_ubo_materials_pbr_;
+        FrameRingBuffer::Ptr vk_ubo_materials_textures_;
+        FrameRingBuffer::Ptr vk_ubo_light_sources_;
+        FrameRingBuffer::Ptr vk_ubo_light_indices_;
+        // Буфер индексов объектов для instanced-отрисовки (по области на каждый активный кадр)
+        vk::utils::Buffer::Ptr vk_ubo_instance_indices_;
+        std::atomic<uint32_t> instance_cursor_;
+        // Буферы непрямой отрисовки (команды и их кол-во, по области на каждый активный кадр)
+        vk::utils::Buffer::Ptr vk_indirect_commands_;
+        vk::utils::Buffer::Ptr vk_indirect_counts_;
+        // Буфер кластеров освещения (заголовок, отрезки кластеров и индексы источников, по области на каждый активный кадр)
+        vk::utils::Buffer::Ptr vk_light_clusters_;
+        vk::DeviceSize light_clusters_region_;
+        // Емкость областей кадров буферов отрисовки (следует за емкостью объектов и кол-вом экземпляров, перевыделяются в начале кадра)
+        uint32_t draw_capacity_;
+        // Поколение буферов (растет при перевыделении) и поколение, на которое ссылаются наборы каждого кадра
+        uint64_t buffers_generation_;
+        std::vector<uint64_t> frame_buffers_generation_;
+        // Буферы, замененные при росте емкости (освобождаются после завершения кадров, которые могли их использовать)
+        std::vector<std::pair<size_t, vk::utils::Buffer::Ptr>> retired_buffers_;
 
         // Синхронизация и команды (кол-во примитивов соответствует кол-ву активных кадров)
         size_t current_frame_;
         uint32_t available_image_index_;
         std::vector<vk::UniqueCommandBuffer> vk_command_buffers_;
+        std::vector<vk::UniqueCommandBuffer> vk_upload_command_buffers_;
         std::vector<vk::UniqueSemaphore> vk_render_available_semaphore_;
         std::vector<vk::UniqueSemaphore> vk_render_finished_semaphore_;
         std::vector<vk::UniqueFence> vk_frame_fence_;
 
+        // Параллельная запись команд (пулы и вторичные буферы для каждого кадра и потока)
+        threading::ThreadPool::Ptr recording_pool_;
+        std::vector<std::vector<vk::UniqueCommandPool>> vk_recording_pools_;
+        std::vector<std::vector<std::vector<vk::UniqueCommandBuffer>>> vk_recording_buffers_;
+        std::vector<vk::CommandBuffer> vk_recorded_buffers_;
+        std::vector<RecordingContext> recording_contexts_;
+        size_t recording_batches_;
+
+        // Очередь отрисовки текущего кадра (и её пакеты непрямой отрисовки)
+        RenderQueue render_queue_;
+        std::vector<IndirectBatch> indirect_batches_;
+        // Пакеты, кластеры которых отсекаются на GPU (в текущем кадре)
+        std::vector<GpuCuller::MeshletBatch> meshlet_batches_;
+
+        // Отсечение объектов по пирамиде видимости (мировые ограничивающие сферы)
+        FrustumCuller frustum_culler_;
+        // Распределение источников света по кластерам пространства вида (мировые ограничивающие сферы источников)
+        LightClusterer light_clusterer_;
+        // Параметры камеры (выбор уровней детализации, отсечение кластеров по конусу нормалей, кластеры освещения)
+        glm::vec3 camera_position_;
+        float camera_projection_scale_;
+        glm::mat4 camera_view_;
+        glm::mat4 camera_projection_;
+        // Отсечение на GPU (пирамида видимости и пирамида глубины прошлого кадра)
+        GpuCuller::Ptr gpu_culler_;
+        // Замер времени областей кадра на GPU (результаты читаются после завершения кадра, без ожидания)
+        GpuProfiler::Ptr gpu_profiler_;
+
+        // Статистика последнего завершенного кадра
+        FrameStats frame_stats_;
+
+        // Контекст записи текущего потока (задан только при записи вторичного буфера)
+        static thread_local RecordingContext* active_context_;
+
+        // При нехватке индексов объектов, источников или материалов их емкость растет вдвое: копии CPU растут сразу,
+        // буферы GPU перевыделяются в начале следующего кадра (grow_frame_buffers)
+
         // Индексы объектов
         std::vector<uint32_t> object_ids_;
         std::mutex obj_ids_mutex_;
+        uint32_t object_capacity_;
 
         // Индексы источников света
         std::vector<uint32_t> light_ids_;
+        // Активные источники - плотный список и позиция каждого источника в нем (удаление заменой на последний)
         std::vector<uint32_t> active_light_ids_;
+        std::vector<uint32_t> active_light_slots_;
         std::mutex light_ids_mutex_;
+        uint32_t light_capacity_;
+        static constexpr uint32_t INACTIVE_LIGHT_SLOT = std::numeric_limits<uint32_t>::max();
 
         // Материалы
         std::vector<std::optional<MaterialInstance>> materials_;
         std::vector<uint32_t> material_ids_;
         std::mutex materials_mutex_;
+        uint32_t material_capacity_;
+        // Индексы текстур материалов в глобальной таблице (по типу текстуры, для освобождения при замене)
+        std::vector<std::array<uint32_t, static_cast<size_t>(TextureType::TOTAL)>> material_texture_ids_;
+
+        // Глобальная таблица текстур (индекс по представлению изображения, кол-во ссылок материалов на каждый индекс)
+        std::unordered_map<VkImageView, uint32_t> texture_ids_;
+        std::vector<VkImageView> texture_views_;
+        std::vector<uint32_t> texture_refs_;
+        std::vector<uint32_t> texture_free_ids_;
+        // Освобожденные индексы (переиспользуются после завершения кадров, которые могли к ним обращаться)
+        std::vector<std::pair<size_t, uint32_t>> retired_texture_ids_;
+        // Элементы таблицы, ожидающие записи (записываются одним вызовом в конце обновления материалов)
+        std::vector<std::pair<uint32_t, vk::DescriptorImageInfo>> texture_writes_;
+        // Элементы, ожидающие записи в набор каждого кадра (записываются после завершения кадра)
+        std::vector<std::vector<std::pair<uint32_t, vk::DescriptorImageInfo>>> texture_frame_writes_;
+        // Запись элементов во время исполнения кадров (иначе у каждого кадра свой набор таблицы)
+        bool texture_writes_concurrent_ = false;
     };
 }
\ No newline at end of file
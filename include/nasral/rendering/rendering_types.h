@@ -6,9 +6,14 @@
 #include <nasral/core_types.h>
 
 #define MAX_CAMERAS 1
-#define MAX_OBJECTS 1000
-#define MAX_MATERIALS 100
-#define MAX_LIGHTS 100
+#define MAX_MESH_LODS 4
+#define MAX_MESHLET_VERTICES 64
+#define MAX_MESHLET_TRIANGLES 124
+#define MAX_MESHLET_BATCHES 64
+#define LIGHT_CLUSTERS_X 16
+#define LIGHT_CLUSTERS_Y 9
+#define LIGHT_CLUSTERS_Z 24
+#define MAX_LIGHT_CLUSTER_INDICES (1u << 18)
 
 namespace nasral::rendering
 {
@@ -30,15 +35,33 @@ namespace nasral::rendering
         std::shared_ptr<VkSurfaceProvider> surface_provider;                // Указатель на объект получения поверхности
         std::array<float, 4> clear_color = {0.0f, 0.0f, 0.0f, 1.0f};        // Цвет очистки
         PFN_vkGetInstanceProcAddr pfn_vk_get_proc_addr;                     // Указатель на функцию получения адресов функций
-        std::optional<glm::uvec2> rendering_resolution;                     // Целевое разрешение рендеринга
+        std::optional<glm::uvec2> rendering_resolution;                     // Целевое разрешение рендеринга (обязательно для headless)
         vk::Format color_format = vk::Format::eB8G8R8A8Unorm;               // Формат цветовых вложений
         vk::Format depth_stencil_format = vk::Format::eD32SfloatS8Uint;     // Формат вложений глубины и трафарета
         vk::ColorSpaceKHR color_space = vk::ColorSpaceKHR::eSrgbNonlinear;  // Цветовое пространство
         vk::PresentModeKHR present_mode = vk::PresentModeKHR::eFifo;        // Режим представления
         bool use_opengl_style = true;                                       // Входные данные в стиле OpenGL
         bool use_validation_layers = false;                                 // Использовать слои валидации
+        bool headless = false;                                              // Рендеринг без поверхности (во внеэкранные кадры)
         uint32_t max_frames_in_flight = 2;                                  // Кол-во единовременно обрабатываемых кадров
         uint32_t swap_chain_image_count = 3;                                // Кол-во изображений в цепочке свопинга
+        uint32_t recording_threads = 0;                                     // Кол-во потоков записи команд (0 - в основной буфер)
+        bool indirect_draws = false;                                        // Запись очереди непрямыми вызовами (для instanced-материалов)
+        bool frustum_culling = true;                                        // Отсечение объектов по пирамиде видимости (CPU)
+        bool gpu_culling = false;                                           // Отсечение на GPU (пирамида видимости и Hi-Z, требует непрямой отрисовки)
+        bool device_local_uniforms = true;                                  // Данные объектов, материалов и источников в памяти устройства (загрузка копированием)
+        std::string pipeline_cache_file;                                    // Файл кеша конвейеров (загружается при инициализации, пустой - без сохранения)
+        uint32_t pipeline_compile_threads = 2;                              // Кол-во потоков создания конвейеров материалов (0 - в основном потоке)
+        bool meshlet_culling = false;                                       // Отсечение кластеров геометрии (meshlet) на GPU по пирамиде видимости и конусу нормалей (требует gpu_culling)
+        float lod_screen_size = 0.5f;                                       // Экранный размер (радиус к половине высоты кадра), ниже которого выбираются упрощенные LOD (0 - только LOD 0)
+        bool clustered_lighting = false;                                    // Распределение источников по кластерам пространства вида (фрагмент обходит источники своего кластера)
+        uint32_t object_capacity = 1024;                                    // Начальная емкость буферов объектов (растет вдвое при нехватке индексов)
+        uint32_t material_capacity = 64;                                    // Начальная емкость буферов материалов (растет вдвое при нехватке индексов)
+        uint32_t light_capacity = 64;                                       // Начальная емкость буферов источников света (растет вдвое при нехватке индексов)
+        uint32_t texture_table_size = 4096;                                 // Размер глобальной таблицы текстур (массив дескрипторов изображений, общий для всех материалов)
+        bool gpu_profiling = false;                                         // Замер времени областей кадра на GPU (запросы временных меток)
+        uint32_t gpu_profiler_scopes = 64;                                  // Наибольшее кол-во областей замера GPU в кадре
+        std::string gpu_profile_file;                                       // Файл итогов замеров GPU (сохраняется при завершении, пустой - без сохранения)
     };
 
     struct Vertex
@@ -47,13 +70,70 @@ namespace nasral::rendering
         glm::vec3 normal;
         glm::vec2 uv;
         glm::vec4 color;
+        glm::vec4 tangent;                                                  // Касательная (xyz) и направление битангенса (w)
     };
 
+    enum class VertexFormat : unsigned
+    {
+        eFull = 0,                                                          // Vertex (все атрибуты float)
+        ePacked,                                                            // PackedVertex
+        ePackedQuantized,                                                   // QuantizedVertex
+        TOTAL
+    };
+
+    inline const std::array<std::string, static_cast<size_t>(VertexFormat::TOTAL)> kVertexFormatNames = {
+        "Full",
+        "Packed",
+        "PackedQuantized"
+    };
+
+    struct PackedVertex
+    {
+        glm::vec3 pos;
+        uint32_t normal;                                                    // Октаэдрическая нормаль (snorm16 x2)
+        uint32_t tangent;                                                   // Октаэдрическая касательная (snorm16 x2, знак y - направление битангенса)
+        uint32_t uv;                                                        // Текстурные координаты (half x2)
+        uint32_t color;                                                     // Цвет (unorm8 x4)
+    };
+
+    struct QuantizedVertex
+    {
+        std::array<uint16_t, 4> pos;                                        // Положение в AABB mesh'а (unorm16 x3, w не используется)
+        uint32_t normal;                                                    // Октаэдрическая нормаль (snorm16 x2)
+        uint32_t tangent;                                                   // Октаэдрическая касательная (snorm16 x2, знак y - направление битангенса)
+        uint32_t uv;                                                        // Текстурные координаты (half x2)
+        uint32_t color;                                                     // Цвет (unorm8 x4)
+    };
+
+    struct Bounds
+    {
+        glm::vec3 aabb_min = glm::vec3(0.0f);                               // Минимальная точка AABB
+        glm::vec3 aabb_max = glm::vec3(0.0f);                               // Максимальная точка AABB
+        glm::vec4 sphere = glm::vec4(0.0f);                                 // Ограничивающая сфера (центр и радиус)
+    };
+
+    struct MeshLod
+    {
+        uint32_t first_index = 0;                                           // Первый индекс уровня в буфере индексов
+        uint32_t index_count = 0;                                           // Кол-во индексов уровня
+    };
+
+    struct Meshlet
+    {
+        glm::vec4 sphere = glm::vec4(0.0f);                                 // Ограничивающая сфера (в пространстве модели)
+        glm::vec4 cone = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);                 // Ось конуса нормалей (xyz) и порог отсечения обратной стороны (w, 1 - не отсекается)
+        uint32_t first_index = 0;                                           // Первый индекс треугольников кластера
+        uint32_t index_count = 0;                                           // Кол-во индексов кластера
+        uint32_t reserved[2] = {};
+    };
+    static_assert(sizeof(Meshlet) % 16 == 0, "Meshlet size must be multiple of 16 bytes");
+
     struct Handles
     {
         struct Material
         {
             vk::Pipeline pipeline = VK_NULL_HANDLE;
+            bool instanced = false;
 
             [[nodiscard]] explicit operator bool() const noexcept{
                 return pipeline;
@@ -64,7 +144,17 @@ namespace nasral::rendering
         {
             vk::Buffer vertex_buffer = VK_NULL_HANDLE;
             vk::Buffer index_buffer = VK_NULL_HANDLE;
+            uint32_t first_index = 0;                                       // Отрезок индексов выбранного уровня детализации
             uint32_t index_count = 0;
+            vk::IndexType index_type = vk::IndexType::eUint32;
+            VertexFormat vertex_format = VertexFormat::eFull;
+            glm::vec4 pos_offset = glm::vec4(0.0f);                         // Восстановление квантованного положения (pos * scale + offset)
+            glm::vec4 pos_scale = glm::vec4(1.0f);
+            std::array<MeshLod, MAX_MESH_LODS> lods = {};                   // Уровни детализации (от полного к наиболее упрощенному)
+            uint32_t lod_count = 1;
+            uint32_t lod = 0;                                               // Выбранный уровень
+            vk::Buffer meshlet_buffer = VK_NULL_HANDLE;                     // Кластеры полного уровня детализации (storage buffer)
+            uint32_t meshlet_count = 0;
 
             [[nodiscard]] explicit operator bool() const noexcept{
                 return vertex_buffer && index_buffer && index_count;
@@ -85,6 +175,7 @@ namespace nasral::rendering
         eDummy = 0,
         eBasicRasterization,
         ePostProcessing,
+        eGpuCulling,
         TOTAL
     };
 
@@ -120,6 +211,21 @@ namespace nasral::rendering
         TOTAL
     };
 
+    // Признаки текстур материала (бит на тип текстуры, выборки из незаданных текстур исключаются из shader'а)
+    constexpr uint32_t kAllTextureFeatures = (1u << static_cast<uint32_t>(TextureType::TOTAL)) - 1u;
+
+    // Идентификаторы констант специализации shader'ов материалов (constant_id)
+    enum class SpecializationConstant : uint32_t
+    {
+        eTextureTableSize = 1,
+        eTextureFeatures,
+        eVertexFormat,
+        eLightClustersX,
+        eLightClustersY,
+        eLightClustersZ,
+        TOTAL
+    };
+
     inline const std::array<std::string, static_cast<size_t>(TextureType::TOTAL)> kTextureTypePhongNames = {
         "Color",
         "Normal",
@@ -154,13 +260,6 @@ namespace nasral::rendering
         "PBR"
     };
 
-    struct TextureBindingInfo
-    {
-        TextureType type = TextureType::eAlbedoColor;
-        TextureSamplerType sampler_type = TextureSamplerType::eNearest;
-        Handles::Texture texture = {};
-    };
-
     struct CameraUniforms
     {
         glm::mat4 view = glm::identity<glm::mat4>();
@@ -174,6 +273,7 @@ namespace nasral::rendering
         glm::mat4 model = glm::identity<glm::mat4>();
         glm::mat4 normals = glm::identity<glm::mat4>();
     };
+    static_assert(sizeof(ObjectTransformUniforms) % 16 == 0, "ObjectTransformUniforms size must be multiple of 16 bytes");
 
     struct MaterialPhongUniforms
     {
@@ -181,7 +281,9 @@ namespace nasral::rendering
         glm::vec4 ambient = glm::vec4(0.05f);
         glm::float32 shininess = 32.0f;
         glm::float32 specular = 1.0f;
+        glm::float32 reserved[2] = {};
     };
+    static_assert(sizeof(MaterialPhongUniforms) % 16 == 0, "MaterialPhongUniforms size must be multiple of 16 bytes");
 
     struct MaterialPbrUniforms
     {
@@ -191,6 +293,15 @@ namespace nasral::rendering
         glm::float32 ao = 1.0f;
         glm::float32 emission = 0.0f;
     };
+    static_assert(sizeof(MaterialPbrUniforms) % 16 == 0, "MaterialPbrUniforms size must be multiple of 16 bytes");
+
+    struct MaterialTextureUniforms
+    {
+        uint32_t textures[8] = {};                                          // Индексы текстур в глобальной таблице (по типу текстуры, 0 - текстура по умолчанию)
+        uint32_t samplers[8] = {};                                          // Индексы семплеров (по типу текстуры)
+    };
+    static_assert(sizeof(MaterialTextureUniforms) % 16 == 0, "MaterialTextureUniforms size must be multiple of 16 bytes");
+    static_assert(static_cast<size_t>(TextureType::TOTAL) <= 8, "MaterialTextureUniforms must fit all texture types");
 
     using MaterialUniforms = std::variant<MaterialPhongUniforms, MaterialPbrUniforms>;
 
@@ -203,12 +314,62 @@ namespace nasral::rendering
         glm::float32 quadratic = 0.1f;
         glm::float32 radius = 0.0f;
         glm::float32 intensity = 1.0f;
+        glm::float32 reserved = 0.0f;
+    };
+    static_assert(sizeof(LightUniforms) % 16 == 0, "LightUniforms size must be multiple of 16 bytes");
+
+    struct GpuCullingUniforms
+    {
+        glm::mat4 view_proj = glm::identity<glm::mat4>();                   // Матрица вида-проекции текущего кадра
+        glm::mat4 prev_view_proj = glm::identity<glm::mat4>();              // Матрица вида-проекции кадра, по глубине которого построена пирамида
+        glm::vec4 planes[6] = {};                                           // Плоскости пирамиды видимости текущего кадра
+        glm::vec4 pyramid = glm::vec4(0.0f);                                // Размеры пирамиды глубины (xy), кол-во уровней (z), знак оси Y экрана (w)
+        glm::vec4 camera_position = glm::vec4(0.0f);                        // Положение камеры (для отсечения кластеров по конусу нормалей)
+    };
+    static_assert(sizeof(GpuCullingUniforms) % 16 == 0, "GpuCullingUniforms size must be multiple of 16 bytes");
+
+    struct LightClusterHeader
+    {
+        glm::uvec4 grid = glm::uvec4(0);                                    // Размеры ячейки экрана в пикселях (xy), кластеры построены (z)
+        glm::vec4 slices = glm::vec4(0.0f);                                 // Масштаб (x) и смещение (y) логарифма глубины для индекса слоя
+    };
+    static_assert(sizeof(LightClusterHeader) % 16 == 0, "LightClusterHeader size must be multiple of 16 bytes");
+
+    struct FrameStats
+    {
+        uint64_t frame = 0;                                                 // Номер кадра
+        uint32_t draw_calls = 0;                                            // Кол-во вызовов отрисовки
+        uint32_t instances = 0;                                             // Кол-во объектов, отрисованных instanced-вызовами
+        uint32_t instances_overflow = 0;                                    // Кол-во экземпляров, не поместившихся в область кадра
+        uint32_t indirect_commands = 0;                                     // Кол-во команд в буфере непрямой отрисовки
+        uint32_t objects_visible = 0;                                       // Кол-во объектов, прошедших отсечение
+        uint32_t objects_culled = 0;                                        // Кол-во отсеченных объектов
+        double cull_time_ms = 0.0;                                          // Время отсечения объектов (мс)
+        uint32_t gpu_cull_candidates = 0;                                   // Кол-во объектов, переданных на отсечение GPU
+        uint32_t gpu_cull_visible = 0;                                      // Кол-во объектов, прошедших отсечение GPU
+        uint32_t command_buffers = 0;                                       // Кол-во вторичных буферов команд
+        uint32_t pipeline_binds = 0;                                        // Кол-во привязок конвейеров
+        uint32_t pipeline_binds_saved = 0;                                  // Кол-во пропущенных (избыточных) привязок конвейеров
+        uint32_t vertex_buffer_binds = 0;                                   // Кол-во привязок буферов вершин
+        uint32_t vertex_buffer_binds_saved = 0;                             // Кол-во пропущенных (избыточных) привязок буферов вершин
+        double record_time_ms = 0.0;                                        // Время записи команд отрисовки (мс)
+        uint64_t uniform_bytes_uploaded = 0;                                // Объем данных, перенесенных из копий CPU в области кадра (байт)
+        uint64_t triangles_queued = 0;                                      // Кол-во треугольников в очереди отрисовки (после выбора LOD)
+        uint32_t meshlets_tested = 0;                                       // Кол-во кластеров, переданных на отсечение GPU
+        uint32_t meshlets_visible = 0;                                      // Кол-во кластеров, прошедших отсечение GPU
+        uint32_t light_assignments = 0;                                     // Кол-во индексов источников во всех кластерах освещения
+        uint32_t lights_per_cluster_max = 0;                                // Наибольшее кол-во источников в одном кластере
+        double light_cluster_time_ms = 0.0;                                 // Время распределения источников по кластерам (мс)
+        uint32_t descriptor_writes = 0;                                     // Кол-во записанных элементов таблицы текстур
+        uint32_t descriptor_updates = 0;                                    // Кол-во вызовов обновления дескрипторов
+        double gpu_time_ms = 0.0;                                           // Время GPU кадра, включая копирование и отсечение (последнего кадра с прочитанными замерами, мс)
     };
 
-    struct LightIndices
+    struct GpuTiming
     {
-        uint32_t count = 0;
-        uint32_t indices[MAX_LIGHTS]{};
+        std::string name;                                                   // Имя области замера
+        uint32_t depth = 0;                                                 // Уровень вложенности области
+        double time_ms = 0.0;                                               // Время GPU (мс)
     };
 
     class Instance
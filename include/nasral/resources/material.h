@@ -1,5 +1,8 @@
 #pragma once
 #include <memory>
+#include <future>
+#include <mutex>
+#include <unordered_map>
 #include <vulkan/vulkan.hpp>
 #include <nasral/resources/ref.h>
 #include <nasral/resources/resource_types.h>
@@ -20,6 +23,7 @@ namespace nasral::resources
             std::string type_name;
             std::string polygon_mode;
             float line_width;
+            bool instanced;
         };
 
         Material(ResourceManager* manager, const std::string_view& path, std::unique_ptr<Loader<Data>> loader);
@@ -31,16 +35,31 @@ namespace nasral::resources
         void load() noexcept override;
         [[nodiscard]] const vk::Pipeline& vk_pipeline() const {return *vk_pipeline_;}
         [[nodiscard]] rendering::Handles::Material render_handles() const;
+        [[nodiscard]] std::optional<rendering::Handles::Material> variant_handles(
+            uint32_t features,
+            rendering::VertexFormat vertex_format = rendering::VertexFormat::eFull) const;
         [[nodiscard]] rendering::MaterialType material_type() const {return material_type_;}
+        [[nodiscard]] bool is_instanced() const {return instanced_;}
+        [[nodiscard]] bool has_texture_features() const {
+            return material_type_ == rendering::MaterialType::ePhong || material_type_ == rendering::MaterialType::ePbr;
+        }
         [[nodiscard]] const std::string_view& path() const {return path_;}
 
     private:
         void try_init_vk_objects();
+        void init_vk_pipeline(const vk::Extent2D& extent, bool gl_style, const vk::RenderPass& render_pass);
+        [[nodiscard]] vk::UniquePipeline create_vk_pipeline(
+            const vk::Extent2D& extent,
+            bool gl_style,
+            const vk::RenderPass& render_pass,
+            uint32_t features,
+            rendering::VertexFormat vertex_format) const;
 
     protected:
         rendering::MaterialType material_type_;
         vk::PolygonMode vk_polygon_mode_;
         float vk_line_width_;
+        bool instanced_;
         std::string_view path_;
         std::unique_ptr<Loader<Data>> loader_;
         Ref vert_shader_res_;
@@ -50,5 +69,16 @@ namespace nasral::resources
         std::optional<vk::ShaderModule> vk_frag_shader_;
         std::optional<vk::ShaderModule> vk_geom_shader_;
         vk::UniquePipeline vk_pipeline_;
+        std::future<void> vk_pipeline_task_;
+
+        // Варианты конвейера по признакам текстур и формату вершин (константы специализации), создаются при первом запросе
+        struct Variant
+        {
+            std::future<void> task;
+            vk::UniquePipeline pipeline;
+            bool ready = false;
+        };
+        mutable std::mutex variants_mutex_;
+        mutable std::unordered_map<uint32_t, Variant> variants_;
     };
 }
\ No newline at end of file
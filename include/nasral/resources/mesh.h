@@ -28,6 +28,12 @@ namespace nasral::resources
         [[nodiscard]] const vk::Buffer& vk_index_buffer() const { return index_buffer_->vk_buffer(); }
         [[nodiscard]] size_t vertex_count() const { return vertex_count_; }
         [[nodiscard]] size_t index_count() const { return index_count_; }
+        [[nodiscard]] size_t lod_count() const { return lod_count_; }
+        [[nodiscard]] size_t meshlet_count() const { return meshlet_count_; }
+        [[nodiscard]] vk::IndexType index_type() const { return index_type_; }
+        [[nodiscard]] rendering::VertexFormat vertex_format() const { return vertex_format_; }
+        [[nodiscard]] vk::DeviceSize vertex_buffer_size() const { return vertex_buffer_ ? vertex_buffer_->size() : 0; }
+        [[nodiscard]] const rendering::Bounds& bounds() const { return bounds_; }
         [[nodiscard]] rendering::Handles::Mesh render_handles() const;
 
     protected:
@@ -35,7 +41,14 @@ namespace nasral::resources
         std::unique_ptr<Loader<Data>> loader_;
         vk::utils::Buffer::Ptr vertex_buffer_;
         vk::utils::Buffer::Ptr index_buffer_;
+        vk::utils::Buffer::Ptr meshlet_buffer_;
         size_t vertex_count_;
         size_t index_count_;
+        std::array<rendering::MeshLod, MAX_MESH_LODS> lods_;
+        size_t lod_count_;
+        size_t meshlet_count_;
+        rendering::VertexFormat vertex_format_;
+        vk::IndexType index_type_;
+        rendering::Bounds bounds_;
     };
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <nasral/core_types.h>
 #include <nasral/resources/resource_types.h>
 #include <nasral/resources/ref.h>
+#include <nasral/rendering/rendering_types.h>
 
 namespace nasral{class Engine;}
 namespace nasral::logging{class Logger;}
@@ -54,6 +55,7 @@ namespace nasral::resources
         [[nodiscard]] Ref make_ref(Type type, const std::string& path) const;
         [[nodiscard]] std::string full_path(const std::string& path) const;
         [[nodiscard]] const SafeHandle<const Engine>& engine() const { return engine_; }
+        [[nodiscard]] rendering::Handles::Material fallback_material(rendering::VertexFormat format = rendering::VertexFormat::eFull) const;
 
     private:
         void request(Ref* ref, bool unsafe = false);
@@ -82,5 +84,10 @@ namespace nasral::resources
         std::unordered_map<std::string_view, size_t> indices_;
         /// Ссылки на встроенные ресурсы (запрашиваются по умолчанию)
         std::array<Ref, static_cast<size_t>(BuiltinResources::TOTAL)> builtin_resources_;
+        /// Путь к материалу-заглушке (используется материалами, конвейеры которых еще не созданы)
+        std::string fallback_material_path_;
+        /// Ссылка на материал-заглушку и его дескрипторы
+        Ref fallback_material_;
+        rendering::Handles::Material fallback_material_handles_;
     };
 }
\ No newline at end of file
@@ -2,9 +2,11 @@
 #include <string>
 #include <array>
 #include <variant>
+#include <atomic>
 #include <nasral/core_types.h>
+#include <nasral/rendering/rendering_types.h>
 
-#define MAX_RESOURCE_COUNT 100
+#define MAX_RESOURCE_COUNT 1024
 #define DEFAULT_REFS_COUNT 10
 #define MAX_RESOURCE_PATH_LENGTH 64
 
@@ -137,7 +139,7 @@ namespace nasral::resources
         {}
 
         Type type_ = Type::eFile;
-        Status status_ = Status::eUnloaded;
+        std::atomic<Status> status_{Status::eUnloaded};
         ErrorCode err_code_ = ErrorCode::eNoError;
         SafeHandle<const ResourceManager> resource_manager_;
         SafeHandle<const logging::Logger> logger_;
@@ -200,6 +202,11 @@ namespace nasral::resources
         bool gen_normals = false;
         bool gen_tangents = false;
         bool winding_ccw = false;
+        rendering::VertexFormat vertex_format = rendering::VertexFormat::eFull;
+        bool optimize = false;
+        uint32_t lod_count = 1;
+        float lod_reduction = 0.5f;
+        bool meshlets = false;
 
         MeshLoadParams& set_gen_normals(const bool i_gen_normals){
             this->gen_normals = i_gen_normals;
@@ -215,6 +222,31 @@ namespace nasral::resources
             this->winding_ccw = i_winding_ccw;
             return *this;
         }
+
+        MeshLoadParams& set_vertex_format(const rendering::VertexFormat i_vertex_format){
+            this->vertex_format = i_vertex_format;
+            return *this;
+        }
+
+        MeshLoadParams& set_optimize(const bool i_optimize){
+            this->optimize = i_optimize;
+            return *this;
+        }
+
+        MeshLoadParams& set_lod_count(const uint32_t i_lod_count){
+            this->lod_count = i_lod_count;
+            return *this;
+        }
+
+        MeshLoadParams& set_lod_reduction(const float i_lod_reduction){
+            this->lod_reduction = i_lod_reduction;
+            return *this;
+        }
+
+        MeshLoadParams& set_meshlets(const bool i_meshlets){
+            this->meshlets = i_meshlets;
+            return *this;
+        }
     };
 
     using LoadParams = std::variant<TextureLoadParams, MeshLoadParams>;
@@ -249,6 +281,7 @@ namespace nasral::resources
     {
         std::string content_dir;
         std::vector<std::tuple<Type, std::string, std::optional<LoadParams>>> initial_resources;
+        std::string fallback_material;
     };
 
     class ResourceError final : public EngineError
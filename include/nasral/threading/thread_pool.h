@@ -0,0 +1,39 @@
+#pragma once
+#include <future>
+#include <queue>
+#include <condition_variable>
+#include <nasral/core_types.h>
+
+namespace nasral::threading
+{
+    class ThreadPool
+    {
+    public:
+        typedef std::unique_ptr<ThreadPool> Ptr;
+        typedef std::function<void()> Task;
+        typedef std::function<void(size_t index)> IndexedTask;
+
+        explicit ThreadPool(size_t thread_count, std::string name = "worker");
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        [[nodiscard]] std::future<void> submit(Task task);
+        void parallel_for(size_t count, const IndexedTask& task);
+
+        [[nodiscard]] size_t size() const{
+            return workers_.size();
+        }
+
+    private:
+        void worker_loop(size_t index);
+
+        std::vector<std::thread> workers_;
+        std::queue<std::packaged_task<void()>> tasks_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        bool stopping_;
+        std::string name_;
+    };
+}
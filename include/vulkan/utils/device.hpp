@@ -97,30 +97,47 @@ namespace vk::utils
             std::vector<std::mutex> queue_mutexes;
         };
 
+        /**
+         * @brief Необязательные возможности устройства.
+         *
+         * Включаются при создании логического устройства, если поддерживаются
+         */
+        struct OptionalFeatures
+        {
+            bool multi_draw_indirect             = false;  ///< Несколько команд в одном непрямом вызове
+            bool draw_indirect_first_instance    = false;  ///< Ненулевой firstInstance в непрямых командах
+            bool draw_indirect_count             = false;  ///< Кол-во непрямых команд из буфера (Vulkan 1.2)
+            bool sampled_image_update_after_bind = false;  ///< Обновление дескрипторов изображений после привязки набора
+            bool update_unused_while_pending     = false;  ///< Обновление неиспользуемых дескрипторов во время исполнения
+        };
+
         /** @brief Конструктор по умолчанию */
         Device() = default;
 
         /**
          * @brief Создает устройство с заданными параметрами
          * @param instance Экземпляр Vulkan
-         * @param surface Поверхность для отображения
+         * @param surface Поверхность для отображения (может быть пустой для работы без представления)
          * @param req_queue_groups Запросы на создание групп очередей
          * @param req_extensions Требуемые расширения устройства
          * @param allow_integrated_device Разрешить использование интегрированного GPU
+         * @param allow_cpu_device Разрешить использование программной реализации (CPU, например lavapipe)
          * @throw std::runtime_error Если не удалось создать подходящее устройство
          */
         Device(const vk::UniqueInstance& instance,
                const vk::UniqueSurfaceKHR& surface,
                const std::vector<QueueGroupRequest>& req_queue_groups,
                const std::vector<const char*>& req_extensions,
-               const bool allow_integrated_device = false) : Device()
+               const bool allow_integrated_device = false,
+               const bool allow_cpu_device = false) : Device()
         {
             // Поиск подходящего физ устройства
             pick_physical_device(instance,
                                  surface,
                                  req_queue_groups,
                                  req_extensions,
-                                 allow_integrated_device);
+                                 allow_integrated_device,
+                                 allow_cpu_device);
 
             // Создание логического устройства
             init_logical_device(req_queue_groups,
@@ -221,6 +238,17 @@ namespace vk::utils
             return static_cast<bool>(fp.optimalTilingFeatures & vk::FormatFeatureFlagBits::eDepthStencilAttachment);
         }
 
+        /**
+         * @brief Проверяет поддержку формата для цветового вложения (без учета поверхности)
+         * @param format Проверяемый формат
+         * @return True, если формат поддерживается для цветового вложения
+         */
+        [[nodiscard]] bool supports_color_attachment(const ::vk::Format& format) const
+        {
+            const auto fp = physical_device_.getFormatProperties(format);
+            return static_cast<bool>(fp.optimalTilingFeatures & vk::FormatFeatureFlagBits::eColorAttachment);
+        }
+
         /**
          * @brief Проверяет принадлежность групп очередей к одному семейству
          * @param indices Индексы проверяемых групп
@@ -314,6 +342,14 @@ namespace vk::utils
             return queue_groups_[index];
         }
 
+        /**
+         * @brief Возвращает включенные необязательные возможности устройства
+         * @return Константная ссылка на набор возможностей
+         */
+        [[nodiscard]] const OptionalFeatures& optional_features() const {
+            return optional_features_;
+        }
+
         /**
          * @brief Проверяет поддержку расширения устройства
          * @param extension Имя проверяемого расширения
@@ -332,24 +368,40 @@ namespace vk::utils
         /**
          * @brief Выбирает подходящее физическое устройство
          * @param instance Экземпляр Vulkan
-         * @param surface Поверхность для отображения
+         * @param surface Поверхность для отображения (может быть пустой)
          * @param req_queue_groups Требуемые группы очередей
          * @param req_extensions Требуемые расширения
          * @param allow_integrated_device Разрешить интегрированное GPU
+         * @param allow_cpu_device Разрешить программную реализацию (CPU)
          * @throw std::runtime_error Если не найдено подходящее устройство
          */
         void pick_physical_device(const vk::UniqueInstance& instance,
                                   const vk::UniqueSurfaceKHR& surface,
                                   const std::vector<QueueGroupRequest>& req_queue_groups,
                                   const std::vector<const char*>& req_extensions,
-                                  bool allow_integrated_device)
+                                  bool allow_integrated_device,
+                                  bool allow_cpu_device)
         {
             // Получить список физических устройств
-            const auto physical_devices = instance->enumeratePhysicalDevices();
+            auto physical_devices = instance->enumeratePhysicalDevices();
             if (physical_devices.empty()){
                 throw std::runtime_error("Cannot find GPUs with Vulkan support");
             }
 
+            // Упорядочить устройства по предпочтению (дискретные, интегрированные, прочие, CPU)
+            const auto type_rank = [](const vk::PhysicalDeviceType type) -> int{
+                switch(type){
+                    case vk::PhysicalDeviceType::eDiscreteGpu: return 0;
+                    case vk::PhysicalDeviceType::eIntegratedGpu: return 1;
+                    case vk::PhysicalDeviceType::eCpu: return 3;
+                    default: return 2;
+                }
+            };
+            std::stable_sort(physical_devices.begin(), physical_devices.end(),
+                [&type_rank](const vk::PhysicalDevice& a, const vk::PhysicalDevice& b){
+                    return type_rank(a.getProperties().deviceType) < type_rank(b.getProperties().deviceType);
+                });
+
             // Очистить кэш семейств очередей
             available_families_.clear();
 
@@ -379,8 +431,8 @@ namespace vk::utils
 
                     for (size_t family_index = 0; family_index < available.size(); ++family_index)
                     {
-                        // Проверка поддержки представления
-                        if(req_queue_groups[i].require_present){
+                        // Проверка поддержки представления (только при наличии поверхности)
+                        if(req_queue_groups[i].require_present && surface){
                             vk::Bool32 support = false;
                             vk::Result checked = device.getSurfaceSupportKHR(
                                     static_cast<uint32_t>(family_index),
@@ -459,17 +511,23 @@ namespace vk::utils
                     continue;
                 }
 
-                // Пропустить интегрированное устройство графики (если требуется исключить)
-                if(!allow_integrated_device && device.getProperties().deviceType != vk::PhysicalDeviceType::eDiscreteGpu){
+                // Пропустить интегрированное/программное устройство (если требуется исключить)
+                const auto device_type = device.getProperties().deviceType;
+                const bool type_allowed = device_type == vk::PhysicalDeviceType::eDiscreteGpu
+                    || (allow_integrated_device && device_type != vk::PhysicalDeviceType::eCpu)
+                    || (allow_cpu_device && device_type == vk::PhysicalDeviceType::eCpu);
+                if(!type_allowed){
                     continue;
                 }
 
-                // Пропустить устройство без поддержки требуемой поверхности
-                const auto formats = device.getSurfaceFormatsKHR(surface.get());
-                const auto present_modes = device.getSurfacePresentModesKHR(surface.get());
-                if (formats.empty() || present_modes.empty())
-                {
-                    continue;
+                // Пропустить устройство без поддержки требуемой поверхности (если она используется)
+                if(surface){
+                    const auto formats = device.getSurfaceFormatsKHR(surface.get());
+                    const auto present_modes = device.getSurfacePresentModesKHR(surface.get());
+                    if (formats.empty() || present_modes.empty())
+                    {
+                        continue;
+                    }
                 }
 
                 // Выбрать устройство и остановить поиск
@@ -481,6 +539,27 @@ namespace vk::utils
             if(!physical_device_){
                 throw std::runtime_error("Cannot find suitable GPU");
             }
+
+            // Необязательные возможности выбранного устройства
+            const auto features = physical_device_.getFeatures();
+            optional_features_ = {};
+            optional_features_.multi_draw_indirect = features.multiDrawIndirect;
+            optional_features_.draw_indirect_first_instance = features.drawIndirectFirstInstance;
+
+            // Возможности descriptor indexing (наличие обязательных проверено при выборе устройства)
+            auto indexing_features = vk::PhysicalDeviceDescriptorIndexingFeaturesEXT().setPNext(nullptr);
+            auto indexing_features2 = vk::PhysicalDeviceFeatures2().setPNext(&indexing_features);
+            physical_device_.getFeatures2(&indexing_features2);
+            optional_features_.sampled_image_update_after_bind = indexing_features.descriptorBindingSampledImageUpdateAfterBind;
+            optional_features_.update_unused_while_pending = indexing_features.descriptorBindingUpdateUnusedWhilePending;
+
+            // Возможности Vulkan 1.2 (запрашиваются только у устройств с его поддержкой)
+            if (physical_device_.getProperties().apiVersion >= VK_API_VERSION_1_2){
+                auto vk12_features = vk::PhysicalDeviceVulkan12Features().setPNext(nullptr);
+                auto features2 = vk::PhysicalDeviceFeatures2().setPNext(&vk12_features);
+                physical_device_.getFeatures2(&features2);
+                optional_features_.draw_indirect_count = vk12_features.drawIndirectCount;
+            }
         }
 
         /**
@@ -518,23 +597,41 @@ namespace vk::utils
                         .setQueuePriorities(queue_priorities.back()));
             }
 
-            // Включить поддержку анизотропии, геометрического шейдера, анизотропии
-            constexpr auto features = vk::PhysicalDeviceFeatures()
+            // Включить поддержку анизотропии, геометрического шейдера, анизотропии (и необязательных возможностей)
+            const auto features = vk::PhysicalDeviceFeatures()
                     .setSamplerAnisotropy(true)
                     .setGeometryShader(true)
                     .setMultiViewport(true)
-                    .setFillModeNonSolid(true);
+                    .setFillModeNonSolid(true)
+                    .setMultiDrawIndirect(optional_features_.multi_draw_indirect)
+                    .setDrawIndirectFirstInstance(optional_features_.draw_indirect_first_instance);
 
             // Включить поддержку bindless дескрипторов
             auto indexing_features = vk::PhysicalDeviceDescriptorIndexingFeaturesEXT()
                 .setPNext(nullptr)
                 .setDescriptorBindingPartiallyBound(true)
                 .setDescriptorBindingVariableDescriptorCount(true)
+                .setDescriptorBindingSampledImageUpdateAfterBind(optional_features_.sampled_image_update_after_bind)
+                .setDescriptorBindingUpdateUnusedWhilePending(optional_features_.update_unused_while_pending)
                 .setRuntimeDescriptorArray(true);
 
+            // Для устройств Vulkan 1.2 те же возможности задаются общей структурой (обе структуры в цепочке недопустимы)
+            auto vk12_features = vk::PhysicalDeviceVulkan12Features()
+                .setPNext(nullptr)
+                .setDescriptorBindingPartiallyBound(true)
+                .setDescriptorBindingVariableDescriptorCount(true)
+                .setDescriptorBindingSampledImageUpdateAfterBind(optional_features_.sampled_image_update_after_bind)
+                .setDescriptorBindingUpdateUnusedWhilePending(optional_features_.update_unused_while_pending)
+                .setRuntimeDescriptorArray(true)
+                .setDrawIndirectCount(optional_features_.draw_indirect_count);
+
             vk::PhysicalDeviceFeatures2 features2;
             features2.setFeatures(features);
-            features2.setPNext(&indexing_features);
+            if (physical_device_.getProperties().apiVersion >= VK_API_VERSION_1_2){
+                features2.setPNext(&vk12_features);
+            }else{
+                features2.setPNext(&indexing_features);
+            }
 
             // Создать устройство
             device_ = physical_device_.createDeviceUnique(
@@ -580,5 +677,7 @@ namespace vk::utils
         std::vector<QueueGroup> queue_groups_;
         /// Кэш семейств очередей (для последующей фильтрации по флагам и прочего)
         std::vector<vk::QueueFamilyProperties> available_families_;
+        /// Включенные необязательные возможности
+        OptionalFeatures optional_features_;
     };
 }
\ No newline at end of file
@@ -43,7 +43,8 @@ namespace vk::utils
             vk::DescriptorType type = vk::DescriptorType::eUniformBuffer;
             /// Стадия шейдера
             vk::ShaderStageFlags stage_flags = vk::ShaderStageFlagBits::eVertex;
-            /// Флаги привязки (например, для bindless дескрипторов)
+            /// Флаги привязки (например, для bindless дескрипторов). С флагом eUpdateAfterBind пул и макет набора
+            /// создаются с поддержкой обновления после привязки (вместе с eUpdateUnusedWhilePending - и во время исполнения)
             vk::DescriptorBindingFlagsEXT binding_flags = {};
         };
 
@@ -91,6 +92,8 @@ namespace vk::utils
             {
                 // Общее кол-во наборов (для размеров пула)
                 uint32_t max_sets_allocations = 0;
+                // Наборы с привязками, обновляемыми после привязки набора, выделяются из пула с соответствующим флагом
+                bool update_after_bind = false;
 
                 // Описываем размер дескрипторного пула.
                 // На данном этапе нас не интересует структура самих дескрипторных наборов.
@@ -100,6 +103,8 @@ namespace vk::utils
                     for (const auto& binding : bindings){
                         max_sets_allocations += max_sets;
                         type_max_allocations[binding.type] += (max_sets * binding.count);
+                        update_after_bind = update_after_bind
+                            || static_cast<bool>(binding.binding_flags & vk::DescriptorBindingFlagBitsEXT::eUpdateAfterBind);
                     }
                 }
 
@@ -113,11 +118,16 @@ namespace vk::utils
 
                 // Создать дескрипторный пул.
                 // Учитываем допустимое количество дескрипторов и наборов, состоящих из этих дескрипторов
+                vk::DescriptorPoolCreateFlags pool_flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet;
+                if (update_after_bind){
+                    pool_flags |= vk::DescriptorPoolCreateFlagBits::eUpdateAfterBindEXT;
+                }
+
                 vk_descriptor_pool_ = vk_device_.createDescriptorPoolUnique(
                     vk::DescriptorPoolCreateInfo()
                     .setMaxSets(max_sets_allocations)
                     .setPoolSizes(pool_sizes)
-                    .setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet));
+                    .setFlags(pool_flags));
             }
 
             // Макет конвейера (материала/шейдера)
@@ -128,11 +138,15 @@ namespace vk::utils
                 for (const auto& set_layout : set_layouts){
                     std::vector<vk::DescriptorSetLayoutBinding> bindings;
                     std::vector<vk::DescriptorBindingFlagsEXT> binding_flags;
+                    vk::DescriptorSetLayoutCreateFlags layout_flags = {};
                     bindings.reserve(set_layout.bindings.size());
                     binding_flags.reserve(set_layout.bindings.size());
 
                     for (const auto& binding : set_layout.bindings){
                         binding_flags.push_back(binding.binding_flags);
+                        if (binding.binding_flags & vk::DescriptorBindingFlagBitsEXT::eUpdateAfterBind){
+                            layout_flags |= vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPoolEXT;
+                        }
                         bindings.push_back(vk::DescriptorSetLayoutBinding()
                             .setBinding(binding.binding)
                             .setDescriptorType(binding.type)
@@ -147,6 +161,7 @@ namespace vk::utils
                     vk_descriptor_set_layouts_.emplace_back(
                         vk_device_.createDescriptorSetLayoutUnique(
                         vk::DescriptorSetLayoutCreateInfo()
+                        .setFlags(layout_flags)
                         .setBindings(bindings)
                         .setPNext(&flags_info)));
 
@@ -214,6 +229,38 @@ namespace vk::utils
                 .setSetLayouts(set_layouts));
         }
 
+        /**
+         * Создает вычислительный конвейер с макетом данного объекта
+         * @param shader_module Модуль вычислительного shader'а
+         * @param cache Кеш конвейеров (опционально)
+         * @param entry_point Имя точки входа shader'а
+         * @return Unique-handle конвейера
+         * @throw std::runtime_error При ошибке создания конвейера
+         */
+        [[nodiscard]] vk::UniquePipeline create_compute_pipeline(
+            const vk::ShaderModule& shader_module,
+            const vk::PipelineCache& cache = {},
+            const char* entry_point = "main") const
+        {
+            assert(vk_device_);
+            assert(vk_pipeline_layout_);
+
+            auto result = vk_device_.createComputePipelineUnique(
+                cache,
+                vk::ComputePipelineCreateInfo()
+                .setStage(vk::PipelineShaderStageCreateInfo()
+                    .setStage(vk::ShaderStageFlagBits::eCompute)
+                    .setModule(shader_module)
+                    .setPName(entry_point))
+                .setLayout(vk_pipeline_layout_.get()));
+
+            if (result.result != vk::Result::eSuccess){
+                throw std::runtime_error("Failed to create compute pipeline!");
+            }
+
+            return std::move(result.value);
+        }
+
     protected:
         /// Handle-объект логического устройства Vulkan
         vk::Device vk_device_;
@@ -1,38 +1,636 @@
 #include "pch.h"
 #include "utils/fps_counter.hpp"
+#include "utils/cmd_args.hpp"
+#include "utils/benchmark.hpp"
 #include "utils/surface_provider.hpp"
 
 #include <nasral/engine.h>
+#include <nasral/resources/mesh.h>
 
 constexpr int kWindowWidth = 1280;
 constexpr int kWindowHeight = 720;
 constexpr auto kWindowTitle = "Demo";
+constexpr unsigned kHeadlessFrames = 1000;
+constexpr unsigned kBenchmarkFrames = 200;
+constexpr unsigned kBenchmarkWarmupMs = 3000;
+constexpr unsigned kBenchmarkNodes = 10000;
+constexpr unsigned kBenchmarkMaterials = 50;
+constexpr unsigned kBenchmarkTextureMaterials = 256;
+constexpr auto kTestMesh = "meshes/chair/chair.obj";
 
 namespace nrl = nasral;
 namespace res = nasral::resources;
 
+/**
+ * Изменение параметров загрузки тестовой геометрии
+ * @param config Конфигурация
+ * @param update Функция изменения параметров
+ */
+void update_test_mesh_params(nrl::Engine::Config& config, const std::function<void(res::MeshLoadParams&)>& update)
+{
+    for (auto& [type, path, params] : config.resources.initial_resources){
+        if (type == res::Type::eMesh && path == kTestMesh){
+            auto mesh_params = params.has_value() ? std::get<res::MeshLoadParams>(params.value()) : res::MeshLoadParams();
+            update(mesh_params);
+            params = mesh_params;
+        }
+    }
+}
+
+/**
+ * Прогон вариантов бенчмарка (время прогрева и кол-во кадров замера задаются аргументами командной строки)
+ * @param config Конфигурация бенчмарка
+ * @param args Аргументы командной строки
+ * @param title Заголовок бенчмарка
+ * @param columns Заголовки столбцов таблицы (через табуляцию)
+ * @param warmup_ms Время прогрева по умолчанию
+ * @return Прогон вариантов
+ */
+utils::BenchmarkSweep make_sweep(
+    const nrl::Engine::Config& config,
+    const utils::CmdArgs& args,
+    const std::string& title,
+    const std::string& columns,
+    const unsigned warmup_ms = kBenchmarkWarmupMs)
+{
+    return {config, args.value_uint("warmup", warmup_ms), args.value_uint("frames", kBenchmarkFrames), title, columns};
+}
+
+/**
+ * Масштабирование записи команд: время записи в зависимости от кол-ва потоков
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_recording(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    // Без отсечения - записываются все узлы
+    config.test.node_count = args.value_uint("nodes", kBenchmarkNodes);
+    config.rendering.frustum_culling = false;
+
+    // Кол-во потоков: 0 (основной буфер), 1, 2, 4 ... до кол-ва аппаратных потоков
+    std::vector<unsigned> thread_counts = {0};
+    const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 1; t <= max_threads; t *= 2) thread_counts.push_back(t);
+    if (thread_counts.back() != max_threads) thread_counts.push_back(max_threads);
+
+    auto sweep = make_sweep(config, args,
+        "Recording benchmark (" + std::to_string(config.test.node_count) + " draws)",
+        "threads\trecord ms\tframe ms\tdraws");
+
+    for (const unsigned threads : thread_counts)
+    {
+        double record_ms = 0.0;
+        uint64_t draws = 0;
+        sweep.run(std::to_string(threads),
+            [&](nrl::Engine::Config& c){ c.rendering.recording_threads = threads; },
+            [&](std::ostream& os, const utils::BenchmarkResult& r){
+                os << record_ms / r.frames << "\t" << r.frame_ms << "\t" << draws / r.frames;
+            },
+            [&](const nrl::Engine& engine, double){
+                record_ms += engine.renderer()->frame_stats().record_time_ms;
+                draws += engine.renderer()->frame_stats().draw_calls;
+            });
+    }
+}
+
+/**
+ * Способы отрисовки: кол-во вызовов и время кадра для прямых, instanced и непрямых вызовов
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_draw_paths(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    // Без отсечения - рисуются все узлы
+    config.test.node_count = args.value_uint("nodes", kBenchmarkNodes);
+    config.rendering.frustum_culling = false;
+
+    auto sweep = make_sweep(config, args,
+        "Draw paths benchmark (" + std::to_string(config.test.node_count) + " nodes)",
+        "path\trecord ms\tframe ms\tdraws");
+
+    const std::vector<std::pair<std::string, std::pair<bool, bool>>> paths = {
+        {"direct", {false, false}},
+        {"instanced", {true, false}},
+        {"indirect", {true, true}}
+    };
+
+    for (const auto& [path, flags] : paths)
+    {
+        double record_ms = 0.0;
+        uint64_t draws = 0;
+        sweep.run(path,
+            [&](nrl::Engine::Config& c){
+                c.test.instanced = flags.first;
+                c.rendering.indirect_draws = flags.second;
+            },
+            [&](std::ostream& os, const utils::BenchmarkResult& r){
+                os << record_ms / r.frames << "\t" << r.frame_ms << "\t" << draws / r.frames;
+            },
+            [&](const nrl::Engine& engine, double){
+                record_ms += engine.renderer()->frame_stats().record_time_ms;
+                draws += engine.renderer()->frame_stats().draw_calls;
+            });
+    }
+}
+
+/**
+ * Отсечение по пирамиде видимости: время отсечения, кол-во видимых/отсеченных узлов и время кадра
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_culling(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    config.test.node_count = args.value_uint("nodes", kBenchmarkNodes);
+
+    auto sweep = make_sweep(config, args,
+        "Culling benchmark (" + std::to_string(config.test.node_count) + " nodes)",
+        "culling\tcull ms\tframe ms\tvisible\tculled\tdraws");
+
+    for (const bool culling : {false, true})
+    {
+        double cull_ms = 0.0;
+        sweep.run(culling ? "on" : "off",
+            [&](nrl::Engine::Config& c){ c.rendering.frustum_culling = culling; },
+            [&](std::ostream& os, const utils::BenchmarkResult& r){
+                os << cull_ms / r.frames << "\t" << r.frame_ms << "\t"
+                   << r.last.objects_visible << "\t" << r.last.objects_culled << "\t" << r.last.draw_calls;
+            },
+            [&](const nrl::Engine& engine, double){
+                cull_ms += engine.renderer()->frame_stats().cull_time_ms;
+            });
+    }
+}
+
+/**
+ * Отсечение на GPU: кол-во видимых объектов и время кадра при отсечении на CPU, на GPU (с Hi-Z) и обоих видах
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_gpu_culling(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    // Плотная сцена из нескольких слоев, перекрывающих друг друга (отсечение на GPU требует непрямой отрисовки)
+    config.test.node_count = args.value_uint("nodes", kBenchmarkNodes);
+    config.test.layers = args.value_uint("layers", 16);
+    config.test.instanced = true;
+    config.rendering.indirect_draws = true;
+
+    auto sweep = make_sweep(config, args,
+        "GPU culling benchmark (" + std::to_string(config.test.node_count) + " nodes, " + std::to_string(config.test.layers) + " layers)",
+        "culling\tframe ms\tcpu visible\tgpu candidates\tgpu visible");
+
+    const std::vector<std::pair<std::string, std::pair<bool, bool>>> modes = {
+        {"cpu", {true, false}},
+        {"gpu", {false, true}},
+        {"cpu+gpu", {true, true}}
+    };
+
+    for (const auto& [mode, flags] : modes)
+    {
+        sweep.run(mode,
+            [&](nrl::Engine::Config& c){
+                c.rendering.frustum_culling = flags.first;
+                c.rendering.gpu_culling = flags.second;
+            },
+            [](std::ostream& os, const utils::BenchmarkResult& r){
+                os << r.frame_ms << "\t" << r.last.objects_visible << "\t"
+                   << r.last.gpu_cull_candidates << "\t" << r.last.gpu_cull_visible;
+            });
+    }
+}
+
+/**
+ * Нагрузка на uniform-данные: все трансформации перезаписываются каждый кадр (узлы тестовой сцены вращаются),
+ * время кадра и объем передаваемых в области кадра данных в зависимости от размещения буферов и кол-ва активных кадров
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_uniform_stress(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    // Без отсечения - рисуются все узлы
+    config.test.node_count = args.value_uint("nodes", kBenchmarkNodes);
+    config.rendering.frustum_culling = false;
+
+    auto sweep = make_sweep(config, args,
+        "Uniform stress benchmark (" + std::to_string(config.test.node_count) + " transforms per frame)",
+        "memory\tframes in flight\tframe ms\tworst ms\tuploaded KB");
+
+    for (const bool device_local : {false, true})
+    {
+        for (const uint32_t frames_in_flight : {1u, 2u, 3u})
+        {
+            uint64_t uploaded = 0;
+            sweep.run(std::string(device_local ? "device" : "host") + "\t" + std::to_string(frames_in_flight),
+                [&](nrl::Engine::Config& c){
+                    c.rendering.device_local_uniforms = device_local;
+                    c.rendering.max_frames_in_flight = frames_in_flight;
+                },
+                [&](std::ostream& os, const utils::BenchmarkResult& r){
+                    os << r.frame_ms << "\t" << r.worst_frame_ms << "\t" << static_cast<double>(uploaded) / r.frames / 1024.0;
+                },
+                [&](const nrl::Engine& engine, double){
+                    uploaded += engine.renderer()->frame_stats().uniform_bytes_uploaded;
+                });
+        }
+    }
+}
+
+/**
+ * Загрузка материалов во время работы: время кадра и наибольший скачок времени кадра основного потока,
+ * пока конвейеры материалов создаются в основном потоке либо пулом потоков (без прогрева, кеш конвейеров не загружается)
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_pipeline_streaming(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    // Каждый вариант материала - отдельный ресурс (и конвейер), по узлу на вариант
+    const unsigned materials = args.value_uint("materials", kBenchmarkMaterials);
+    const std::string path = std::string("materials/phong/material")
+        + (config.test.vertex_tangents ? "_tangent" : "")
+        + (config.test.instanced ? "_instanced" : "")
+        + ".xml";
+    for (unsigned v = 0; v < materials; ++v){
+        config.resources.initial_resources.emplace_back(res::Type::eMaterial, path + ":v" + std::to_string(v), std::nullopt);
+    }
+    config.test.material_variants = materials;
+    config.test.node_count = args.value_uint("nodes", materials);
+    config.rendering.pipeline_cache_file.clear();
+
+    // Кол-во потоков: 0 (основной поток), 1, 2, 4 ... до кол-ва аппаратных потоков
+    std::vector<unsigned> thread_counts = {0};
+    const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 1; t <= max_threads; t *= 2) thread_counts.push_back(t);
+
+    auto sweep = make_sweep(config, args,
+        "Pipeline streaming benchmark (" + std::to_string(materials) + " materials)",
+        "threads\tframe ms\tworst ms\tlast pipeline ms\tpipelines",
+        0);
+
+    for (const unsigned threads : thread_counts)
+    {
+        // Время от начала замера до кадра, в котором был создан последний конвейер
+        double elapsed_ms = 0.0;
+        double last_pipeline_ms = 0.0;
+        uint32_t pipelines = 0;
+        sweep.run(std::to_string(threads),
+            [&](nrl::Engine::Config& c){ c.rendering.pipeline_compile_threads = threads; },
+            [&](std::ostream& os, const utils::BenchmarkResult& r){
+                os << r.frame_ms << "\t" << r.worst_frame_ms << "\t" << last_pipeline_ms << "\t" << pipelines;
+            },
+            [&](const nrl::Engine& engine, const double ms){
+                elapsed_ms += ms;
+                if (engine.renderer()->pipelines_created() != pipelines){
+                    pipelines = engine.renderer()->pipelines_created();
+                    last_pipeline_ms = elapsed_ms;
+                }
+            });
+    }
+}
+
+/**
+ * Стоимость геометрического шейдера: время кадра с базисом TBN из геометрического шейдера и из касательных вершин,
+ * для сцены из нескольких крупных узлов (нагрузка на фрагментную стадию) и для большого кол-ва узлов (нагрузка на вершины)
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_geometry_shader(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    // Без отсечения - рисуются все узлы
+    config.rendering.frustum_culling = false;
+
+    auto sweep = make_sweep(config, args,
+        "Geometry shader benchmark",
+        "scene\tnodes\tlayers\ttangents\tframe ms\tworst ms");
+
+    // Несколько узлов на весь кадр в перекрывающих друг друга слоях и сетка из множества мелких узлов
+    const std::vector<std::pair<std::string, std::pair<uint32_t, uint32_t>>> scenes = {
+        {"fragment", {args.value_uint("nodes", 4), args.value_uint("layers", 4)}},
+        {"vertex", {kBenchmarkNodes, 1}}
+    };
+
+    for (const auto& [scene, size] : scenes)
+    {
+        for (const bool vertex_tangents : {false, true})
+        {
+            const auto label = scene + "\t" + std::to_string(size.first) + "\t" + std::to_string(size.second) + "\t"
+                + (vertex_tangents ? "vertex" : "geometry");
+            sweep.run(label,
+                [&](nrl::Engine::Config& c){
+                    c.test.node_count = size.first;
+                    c.test.layers = size.second;
+                    c.test.vertex_tangents = vertex_tangents;
+                },
+                [](std::ostream& os, const utils::BenchmarkResult& r){
+                    os << r.frame_ms << "\t" << r.worst_frame_ms;
+                });
+        }
+    }
+}
+
+/**
+ * Формат вершин: размер буфера вершин тестовой геометрии и время кадра для полного и упакованных форматов
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_vertex_format(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    // Без отсечения - рисуются все узлы (нагрузка на выборку вершин)
+    config.test.node_count = args.value_uint("nodes", kBenchmarkNodes);
+    config.rendering.frustum_culling = false;
+
+    auto sweep = make_sweep(config, args,
+        "Vertex format benchmark (" + std::to_string(config.test.node_count) + " nodes)",
+        "format\tvertex KB\tframe ms\tworst ms");
+
+    for (size_t i = 0; i < static_cast<size_t>(nrl::rendering::VertexFormat::TOTAL); ++i)
+    {
+        // Формат задается параметрами загрузки тестовой геометрии
+        const auto format = static_cast<nrl::rendering::VertexFormat>(i);
+        vk::DeviceSize vertex_bytes = 0;
+        sweep.run(nrl::rendering::kVertexFormatNames[i],
+            [&](nrl::Engine::Config& c){
+                update_test_mesh_params(c, [&](res::MeshLoadParams& params){
+                    params.set_vertex_format(format);
+                });
+            },
+            [&](std::ostream& os, const utils::BenchmarkResult& r){
+                os << static_cast<double>(vertex_bytes) / 1024.0 << "\t" << r.frame_ms << "\t" << r.worst_frame_ms;
+            },
+            [&](const nrl::Engine& engine, double){
+                const auto* manager = engine.resource_manager();
+                if (const auto index = manager->res_index(kTestMesh); index.has_value()){
+                    const auto* mesh = dynamic_cast<const res::Mesh*>(manager->get_resource(index.value()));
+                    vertex_bytes = mesh != nullptr ? mesh->vertex_buffer_size() : 0;
+                }
+            });
+    }
+}
+
+/**
+ * Оптимизация геометрии: время кадра без оптимизации и с упорядочиванием для кеша вершин, перерисовки и выборки вершин
+ * (ACMR/ATVR до и после оптимизации выводятся в журнал движка)
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_mesh_optimization(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    // Без отсечения - рисуются все узлы (нагрузка на обработку вершин)
+    config.test.node_count = args.value_uint("nodes", kBenchmarkNodes);
+    config.rendering.frustum_culling = false;
+
+    auto sweep = make_sweep(config, args,
+        "Mesh optimization benchmark (" + std::to_string(config.test.node_count) + " nodes)",
+        "optimized\tframe ms\tworst ms");
+
+    for (const bool optimize : {false, true})
+    {
+        sweep.run(optimize ? "yes" : "no",
+            [&](nrl::Engine::Config& c){
+                update_test_mesh_params(c, [&](res::MeshLoadParams& params){
+                    params.set_optimize(optimize);
+                });
+            },
+            [](std::ostream& os, const utils::BenchmarkResult& r){
+                os << r.frame_ms << "\t" << r.worst_frame_ms;
+            });
+    }
+}
+
+/**
+ * Уровни детализации: кол-во треугольников в очереди и время кадра только с полной геометрией и с цепочкой LOD
+ * (кол-во треугольников уровней выводится в журнал движка)
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_lod(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    // Без отсечения - рисуются все узлы (большинство мелкие на экране)
+    config.test.node_count = args.value_uint("nodes", kBenchmarkNodes);
+    config.rendering.frustum_culling = false;
+
+    auto sweep = make_sweep(config, args,
+        "LOD benchmark (" + std::to_string(config.test.node_count) + " nodes)",
+        "lods\ttriangles\tframe ms\tworst ms");
+
+    for (const uint32_t lod_count : {1u, static_cast<uint32_t>(MAX_MESH_LODS)})
+    {
+        sweep.run(std::to_string(lod_count),
+            [&](nrl::Engine::Config& c){
+                update_test_mesh_params(c, [&](res::MeshLoadParams& params){
+                    params.set_lod_count(lod_count);
+                });
+            },
+            [](std::ostream& os, const utils::BenchmarkResult& r){
+                os << r.last.triangles_queued << "\t" << r.frame_ms << "\t" << r.worst_frame_ms;
+            });
+    }
+}
+
+/**
+ * Кластеры геометрии: время кадра и кол-во проверенных и видимых кластеров при отсечении на GPU только объектов
+ * и объектов вместе с их кластерами (по пирамиде видимости и конусу нормалей)
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_meshlets(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    // Отсечение кластеров выполняется проходом отсечения на GPU (требует непрямой отрисовки)
+    config.test.node_count = args.value_uint("nodes", kBenchmarkNodes);
+    config.test.instanced = true;
+    config.rendering.indirect_draws = true;
+    config.rendering.gpu_culling = true;
+
+    auto sweep = make_sweep(config, args,
+        "Meshlet culling benchmark (" + std::to_string(config.test.node_count) + " nodes)",
+        "meshlets\tframe ms\tworst ms\tmeshlets tested\tmeshlets visible");
+
+    for (const bool meshlets : {false, true})
+    {
+        sweep.run(meshlets ? "yes" : "no",
+            [&](nrl::Engine::Config& c){
+                update_test_mesh_params(c, [&](res::MeshLoadParams& params){
+                    params.set_meshlets(meshlets);
+                });
+                c.rendering.meshlet_culling = meshlets;
+            },
+            [](std::ostream& os, const utils::BenchmarkResult& r){
+                os << r.frame_ms << "\t" << r.worst_frame_ms << "\t" << r.last.meshlets_tested << "\t" << r.last.meshlets_visible;
+            });
+    }
+}
+
+/**
+ * Кластеры освещения: время кадра при обходе всех активных источников и только источников кластера фрагмента
+ * в зависимости от кол-ва источников (источники с ограниченным радиусом распределены по объему сцены)
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_lights(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    config.test.node_count = args.value_uint("nodes", kBenchmarkNodes);
+    config.test.layers = args.value_uint("layers", 4);
+
+    auto sweep = make_sweep(config, args,
+        "Clustered lighting benchmark (" + std::to_string(config.test.node_count) + " nodes, " + std::to_string(config.test.layers) + " layers)",
+        "lights\tclustered\tframe ms\tworst ms\tassignments\tmax per cluster\tcluster ms");
+
+    for (const uint32_t light_count : {1u, 10u, 100u, 1000u})
+    {
+        for (const bool clustered : {false, true})
+        {
+            sweep.run(std::to_string(light_count) + "\t" + (clustered ? "yes" : "no"),
+                [&](nrl::Engine::Config& c){
+                    c.test.light_count = light_count;
+                    c.rendering.clustered_lighting = clustered;
+                },
+                [](std::ostream& os, const utils::BenchmarkResult& r){
+                    os << r.frame_ms << "\t" << r.worst_frame_ms << "\t" << r.last.light_assignments << "\t"
+                       << r.last.lights_per_cluster_max << "\t" << r.last.light_cluster_time_ms;
+                });
+        }
+    }
+}
+
+/**
+ * Замена текстур материалов: время кадра и кол-во записей в таблицу текстур, когда каждый материал меняет
+ * основную текстуру каждый кадр (новые элементы таблицы всех материалов записываются одним вызовом)
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void bench_texture_swap(nrl::Engine::Config config, const utils::CmdArgs& args)
+{
+    // Материал на узел (у каждого материала своя пара текстур)
+    config.test.texture_materials = args.value_uint("materials", kBenchmarkTextureMaterials);
+    config.test.node_count = args.value_uint("nodes", config.test.texture_materials);
+
+    auto sweep = make_sweep(config, args,
+        "Texture swap benchmark (" + std::to_string(config.test.texture_materials) + " materials)",
+        "swaps\tframe ms\tworst ms\tdescriptor writes\tdescriptor updates");
+
+    for (const bool swaps : {false, true})
+    {
+        uint64_t writes = 0;
+        uint64_t updates = 0;
+        sweep.run(swaps ? "yes" : "no",
+            [&](nrl::Engine::Config& c){ c.test.texture_swaps = swaps; },
+            [&](std::ostream& os, const utils::BenchmarkResult& r){
+                os << r.frame_ms << "\t" << r.worst_frame_ms << "\t"
+                   << static_cast<double>(writes) / r.frames << "\t" << static_cast<double>(updates) / r.frames;
+            },
+            [&](const nrl::Engine& engine, double){
+                writes += engine.renderer()->frame_stats().descriptor_writes;
+                updates += engine.renderer()->frame_stats().descriptor_updates;
+            });
+    }
+}
+
+/**
+ * Запуск бенчмарка по имени
+ * @param name Имя бенчмарка
+ * @param config Базовая конфигурация
+ * @param args Аргументы командной строки
+ */
+void run_benchmark(const std::string& name, const nrl::Engine::Config& config, const utils::CmdArgs& args)
+{
+    if (name == "recording"){
+        bench_recording(config, args);
+    }else if (name == "draw-paths"){
+        bench_draw_paths(config, args);
+    }else if (name == "culling"){
+        bench_culling(config, args);
+    }else if (name == "gpu-culling"){
+        bench_gpu_culling(config, args);
+    }else if (name == "uniform-stress"){
+        bench_uniform_stress(config, args);
+    }else if (name == "pipeline-streaming"){
+        bench_pipeline_streaming(config, args);
+    }else if (name == "geometry-shader"){
+        bench_geometry_shader(config, args);
+    }else if (name == "vertex-format"){
+        bench_vertex_format(config, args);
+    }else if (name == "mesh-optimization"){
+        bench_mesh_optimization(config, args);
+    }else if (name == "lod"){
+        bench_lod(config, args);
+    }else if (name == "meshlets"){
+        bench_meshlets(config, args);
+    }else if (name == "lights"){
+        bench_lights(config, args);
+    }else if (name == "texture-swap"){
+        bench_texture_swap(config, args);
+    }else{
+        throw std::runtime_error("Unknown benchmark: " + name);
+    }
+}
+
 /**
  * Точка входа
  * @param argc Кол-во аргументов
  * @param argv Аргументы
  * @return Код выхода
+ *
+ * @details Поддерживаемые аргументы:
+ * --headless           Рендеринг без окна (внеэкранные кадры), например, на CI с lavapipe
+ * --frames <N>         Кол-во кадров в режиме headless
+ * --no-validation      Отключить слои валидации
+ * --threads <N>        Кол-во потоков записи команд
+ * --nodes <N>          Кол-во узлов тестовой сцены
+ * --instanced          Использовать instanced-варианты материалов
+ * --indirect           Непрямая отрисовка (включает instanced-варианты материалов)
+ * --no-culling         Отключить отсечение по пирамиде видимости
+ * --gpu-culling        Отсечение на GPU по пирамиде видимости и глубине прошлого кадра (включает непрямую отрисовку)
+ * --layers <N>         Кол-во слоев сетки тестовой сцены по глубине
+ * --no-gs              Материалы с касательными из вершин (без геометрического шейдера)
+ * --vertex-format <F>  Формат вершин тестовой геометрии: Full, Packed, PackedQuantized
+ * --optimize-meshes    Оптимизация тестовой геометрии (кеш вершин, перерисовка, выборка вершин)
+ * --mesh-lods <N>      Кол-во уровней детализации тестовой геометрии (упрощение, выбор по экранному размеру)
+ * --meshlets           Кластеры тестовой геометрии и их отсечение на GPU (включает отсечение на GPU)
+ * --lights <N>         Кол-во источников света тестовой сцены (кроме первых двух - с ограниченным радиусом)
+ * --clustered-lights   Распределение источников света по кластерам пространства вида
+ * --no-pipeline-cache  Не загружать и не сохранять кеш конвейеров (content/cache)
+ * --gpu-profile <file> Замер времени областей кадра на GPU, итоги сохраняются в файл (по умолчанию gpu_profile.txt)
+ * --trace <file>       Запись зон CPU, трассировка сохраняется в файл Chrome trace_event JSON (по умолчанию trace.json)
+ * --bench <name>       Запуск бенчмарка (всегда headless): recording, draw-paths, culling, gpu-culling, uniform-stress,
+ *                      pipeline-streaming, geometry-shader, vertex-format, mesh-optimization, lod, meshlets,
+ *                      lights, texture-swap
+ * --warmup <ms>        Время прогрева бенчмарка
+ * --materials <N>      Кол-во загружаемых вариантов материала (бенчмарк pipeline-streaming) либо материалов,
+ *                      меняющих текстуры (бенчмарк texture-swap)
+ * --compile <N>        Кол-во потоков создания конвейеров материалов (0 - в основном потоке)
  */
-int main([[maybe_unused]] int argc, [[maybe_unused]] const char * argv[])
+int main(const int argc, const char * argv[])
 {
     try
     {
-        // Инициализация GLFW
-        if (glfwInit() != GLFW_TRUE){
-            throw std::runtime_error("Failed to initialize GLFW");
-        }
+        // Аргументы командной строки
+        const utils::CmdArgs args(argc, argv);
+        const bool headless = args.has("headless") || args.has("bench");
 
-        // Для Vulkan не нужны hints
-        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        // Окно (не создается в режиме headless)
+        GLFWwindow* window = nullptr;
 
-        // Создать окно
-        GLFWwindow* window = glfwCreateWindow(kWindowWidth, kWindowHeight, kWindowTitle, nullptr, nullptr);
-        if (window == nullptr){
-            throw std::runtime_error("Failed to create GLFW window");
+        if (!headless)
+        {
+            // Инициализация GLFW
+            if (glfwInit() != GLFW_TRUE){
+                throw std::runtime_error("Failed to initialize GLFW");
+            }
+
+            // Для Vulkan не нужны hints
+            glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+
+            // Создать окно
+            window = glfwCreateWindow(kWindowWidth, kWindowHeight, kWindowTitle, nullptr, nullptr);
+            if (window == nullptr){
+                throw std::runtime_error("Failed to create GLFW window");
+            }
+        }
+
+        // Формат вершин тестовой геометрии
+        const auto vertex_format = nrl::enum_of<nrl::rendering::VertexFormat>(
+            args.value("vertex-format", "Full"),
+            nrl::rendering::kVertexFormatNames);
+        if (!vertex_format.has_value()){
+            throw std::runtime_error("Unknown vertex format: " + args.value("vertex-format"));
         }
 
         // Конфигурация
@@ -42,9 +640,17 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] const char * argv[])
             config.log.file = "engine.log";
             config.log.console_out = true;
 
+            // Профилирование (зоны CPU, трассировка в формате Chrome trace_event)
+            config.profiling.enabled = args.has("trace");
+            config.profiling.trace_file = args.value("trace", "trace.json");
+
             // Ресурсы
             config.resources.content_dir = "../../content/";
             config.resources.initial_resources = {
+                // Материал-заглушка (используется, пока конвейеры других материалов создаются)
+                { res::Type::eShader, "materials/dummy/shader.vert.spv", std::nullopt},
+                { res::Type::eShader, "materials/dummy/shader.frag.spv", std::nullopt},
+                { res::Type::eMaterial, "materials/dummy/material.xml", std::nullopt},
                 // Материал без текстуры (цветные вершины)
                 { res::Type::eShader, "materials/vertex-colored/shader.vert.spv", std::nullopt},
                 { res::Type::eShader, "materials/vertex-colored/shader.frag.spv", std::nullopt},
@@ -58,16 +664,40 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] const char * argv[])
                 { res::Type::eShader, "materials/phong/shader.frag.spv", std::nullopt},
                 { res::Type::eShader, "materials/phong/shader.geom.spv", std::nullopt},
                 { res::Type::eMaterial, "materials/phong/material.xml", std::nullopt},
+                // Phong материал (instanced-вариант)
+                { res::Type::eShader, "materials/phong/shader_instanced.vert.spv", std::nullopt},
+                { res::Type::eMaterial, "materials/phong/material_instanced.xml", std::nullopt},
+                // Phong материал (касательные из вершин, без геометрического шейдера)
+                { res::Type::eShader, "materials/phong/shader_tangent.vert.spv", std::nullopt},
+                { res::Type::eMaterial, "materials/phong/material_tangent.xml", std::nullopt},
+                { res::Type::eShader, "materials/phong/shader_tangent_instanced.vert.spv", std::nullopt},
+                { res::Type::eMaterial, "materials/phong/material_tangent_instanced.xml", std::nullopt},
                 // PBR материал
                 { res::Type::eShader, "materials/pbr/shader.vert.spv", std::nullopt},
                 { res::Type::eShader, "materials/pbr/shader.frag.spv", std::nullopt},
                 { res::Type::eShader, "materials/pbr/shader.geom.spv", std::nullopt},
                 { res::Type::eMaterial, "materials/pbr/material.xml", std::nullopt},
+                // PBR материал (instanced-вариант)
+                { res::Type::eShader, "materials/pbr/shader_instanced.vert.spv", std::nullopt},
+                { res::Type::eMaterial, "materials/pbr/material_instanced.xml", std::nullopt},
+                // PBR материал (касательные из вершин, без геометрического шейдера)
+                { res::Type::eShader, "materials/pbr/shader_tangent.vert.spv", std::nullopt},
+                { res::Type::eMaterial, "materials/pbr/material_tangent.xml", std::nullopt},
+                { res::Type::eShader, "materials/pbr/shader_tangent_instanced.vert.spv", std::nullopt},
+                { res::Type::eMaterial, "materials/pbr/material_tangent_instanced.xml", std::nullopt},
+                // Отсечение на GPU (вычислительные shader'ы)
+                { res::Type::eShader, "materials/gpu-culling/cull.comp.spv", std::nullopt},
+                { res::Type::eShader, "materials/gpu-culling/pyramid.comp.spv", std::nullopt},
+                { res::Type::eShader, "materials/gpu-culling/meshlets.comp.spv", std::nullopt},
                 // Mesh для теста (мяч)
                 // { res::Type::eMesh, "meshes/football/fb.obj", std::nullopt},
                 // { res::Type::eMesh, "meshes/football/fb_deflated.obj", std::nullopt},
                 // Mesh для теста (стул)
-                { res::Type::eMesh, "meshes/chair/chair.obj", std::nullopt},
+                { res::Type::eMesh, kTestMesh, res::MeshLoadParams()
+                    .set_vertex_format(vertex_format.value())
+                    .set_optimize(args.has("optimize-meshes"))
+                    .set_lod_count(args.value_uint("mesh-lods", 1))
+                    .set_meshlets(args.has("meshlets"))},
                 // Текстуры (мяч)
                 // { res::Type::eTexture, "textures/football/fb_diff_1k.png", std::nullopt},
                 // { res::Type::eTexture, "textures/football/fb_nor_gl_1k.png", std::nullopt},
@@ -82,22 +712,48 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] const char * argv[])
                 { res::Type::eTexture, "textures/chair/chair_rough_1k.png", std::nullopt},
                 { res::Type::eTexture, "textures/chair/chair_spec_1k.png", std::nullopt},
             };
+            config.resources.fallback_material = "materials/dummy/material.xml";
 
             // Рендеринг
             config.rendering.app_name = "engine-demo";
             config.rendering.engine_name = "nasral-engine";
-            config.rendering.surface_provider = std::make_shared<utils::GlfwSurfaceProvider>(window);
+            config.rendering.surface_provider = headless ? nullptr : std::make_shared<utils::GlfwSurfaceProvider>(window);
             config.rendering.clear_color = {0.0f, 0.0f, 0.0f, 1.0f};
-            config.rendering.pfn_vk_get_proc_addr = glfwGetInstanceProcAddress;
-            config.rendering.rendering_resolution = {}; // На текущий момент не используется
+            config.rendering.pfn_vk_get_proc_addr = headless ? vkGetInstanceProcAddr : glfwGetInstanceProcAddress;
+            config.rendering.rendering_resolution = glm::uvec2(kWindowWidth, kWindowHeight); // Используется в режиме headless
             config.rendering.color_format = vk::Format::eB8G8R8A8Unorm;
             config.rendering.depth_stencil_format = vk::Format::eD32SfloatS8Uint;
             config.rendering.color_space = vk::ColorSpaceKHR::eSrgbNonlinear;
             config.rendering.present_mode = vk::PresentModeKHR::eImmediate;
             config.rendering.use_opengl_style = true;
-            config.rendering.use_validation_layers = true;
+            config.rendering.use_validation_layers = !args.has("no-validation");
             config.rendering.max_frames_in_flight = 3;
             config.rendering.swap_chain_image_count = 4;
+            config.rendering.headless = headless;
+            config.rendering.recording_threads = args.value_uint("threads", 0);
+            config.rendering.indirect_draws = args.has("indirect") || args.has("gpu-culling") || args.has("meshlets");
+            config.rendering.frustum_culling = !args.has("no-culling");
+            config.rendering.gpu_culling = args.has("gpu-culling") || args.has("meshlets");
+            config.rendering.meshlet_culling = args.has("meshlets");
+            config.rendering.clustered_lighting = args.has("clustered-lights");
+            config.rendering.pipeline_cache_file = args.has("no-pipeline-cache") ? "" : config.resources.content_dir + "cache/pipelines.bin";
+            config.rendering.pipeline_compile_threads = args.value_uint("compile", 2);
+            config.rendering.gpu_profiling = args.has("gpu-profile");
+            config.rendering.gpu_profile_file = args.value("gpu-profile", "gpu_profile.txt");
+
+            // Тестовая сцена
+            config.test.node_count = args.value_uint("nodes", 2);
+            config.test.instanced = args.has("instanced") || args.has("indirect") || args.has("gpu-culling") || args.has("meshlets");
+            config.test.layers = args.value_uint("layers", 1);
+            config.test.vertex_tangents = args.has("no-gs");
+            config.test.light_count = args.value_uint("lights", 2);
+        }
+
+        // Бенчмарки
+        if (args.has("bench")){
+            config.log.console_out = false;
+            run_benchmark(args.value("bench"), config, args);
+            return EXIT_SUCCESS;
         }
 
         // Инициализировать движок
@@ -108,6 +764,49 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] const char * argv[])
 
         // Таймер
         utils::FpsCounter fps_counter;
+
+        // Режим headless - фиксированное кол-во кадров без окна
+        if (headless)
+        {
+            const unsigned frames = args.value_uint("frames", kHeadlessFrames);
+            const auto started = std::chrono::steady_clock::now();
+
+            for (unsigned i = 0; i < frames; ++i)
+            {
+                // Обновление FPS счетчика
+                fps_counter.update();
+
+                // Обновление движка
+                engine.update(fps_counter.delta());
+            }
+
+            // Итоговое время (с учетом завершения последнего кадра на GPU)
+            engine.renderer()->cmd_wait_for_frame();
+            const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+            std::cout << "Headless: " << frames << " frames, "
+                      << elapsed << " ms total, "
+                      << (frames > 0 ? elapsed / frames : 0.0) << " ms/frame" << std::endl;
+
+            // Статистика последнего кадра
+            const auto& stats = engine.renderer()->frame_stats();
+            std::cout << "Last frame: " << stats.draw_calls << " draws (" << stats.instances << " instances, " << stats.instances_overflow << " overflowed), "
+                      << stats.pipeline_binds << " pipeline binds (" << stats.pipeline_binds_saved << " saved), "
+                      << stats.vertex_buffer_binds << " vertex buffer binds (" << stats.vertex_buffer_binds_saved << " saved), "
+                      << stats.objects_visible << " visible (" << stats.objects_culled << " culled), "
+                      << stats.gpu_cull_visible << " of " << stats.gpu_cull_candidates << " visible after GPU culling, "
+                      << stats.uniform_bytes_uploaded << " uniform bytes uploaded"
+                      << std::endl;
+
+            // Замеры GPU (последний кадр с прочитанными результатами)
+            for (const auto& timing : engine.renderer()->gpu_timings()){
+                std::cout << "GPU: " << std::string(timing.depth * 2, ' ') << timing.name << " " << timing.time_ms << " ms" << std::endl;
+            }
+
+            // Завершение работы с движком
+            engine.shutdown();
+            return EXIT_SUCCESS;
+        }
+
         fps_counter.set_fps_refresh_fn([&window](const unsigned fps){
             std::string title = kWindowTitle;
             title.append(" (").append(std::to_string(fps)).append(" FPS)");
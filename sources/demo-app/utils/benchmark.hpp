@@ -0,0 +1,140 @@
+#pragma once
+#include "fps_counter.hpp"
+
+namespace utils
+{
+    class Benchmark
+    {
+    public:
+        typedef std::function<void(const nasral::Engine& engine, double frame_ms)> FrameFn;
+
+        Benchmark(nasral::Engine::Config config, const unsigned warmup_ms, const unsigned frames)
+        : config_(std::move(config))
+        , warmup_ms_(warmup_ms)
+        , frames_(frames)
+        , worst_frame_ms_(0.0)
+        {}
+
+        ~Benchmark() = default;
+
+        double run(const FrameFn& on_frame = nullptr)
+        {
+            nasral::Engine engine;
+            if (!engine.initialize(config_)){
+                throw std::runtime_error("Failed to initialize engine.");
+            }
+
+            FpsCounter fps_counter;
+
+            // Прогрев (загрузка ресурсов и создание конвейеров происходят асинхронно)
+            const auto warmup_until = steady_clock::now() + milliseconds(warmup_ms_);
+            while (steady_clock::now() < warmup_until)
+            {
+                fps_counter.update();
+                engine.update(fps_counter.delta());
+            }
+            engine.renderer()->cmd_wait_for_frame();
+
+            // Замер
+            double total_ms = 0.0;
+            worst_frame_ms_ = 0.0;
+            for (unsigned i = 0; i < frames_; ++i)
+            {
+                const auto started = steady_clock::now();
+                fps_counter.update();
+                engine.update(fps_counter.delta());
+                const double frame_ms = duration<double, std::milli>(steady_clock::now() - started).count();
+
+                total_ms += frame_ms;
+                worst_frame_ms_ = std::max(worst_frame_ms_, frame_ms);
+                if (on_frame) on_frame(engine, frame_ms);
+            }
+            engine.renderer()->cmd_wait_for_frame();
+            engine.shutdown();
+
+            return frames_ > 0 ? total_ms / frames_ : 0.0;
+        }
+
+        [[nodiscard]] nasral::Engine::Config& config()
+        {
+            return config_;
+        }
+
+        [[nodiscard]] unsigned frames() const
+        {
+            return frames_;
+        }
+
+        [[nodiscard]] double worst_frame_ms() const
+        {
+            return worst_frame_ms_;
+        }
+
+    protected:
+        nasral::Engine::Config  config_;
+        unsigned                warmup_ms_;
+        unsigned                frames_;
+        double                  worst_frame_ms_;
+    };
+
+    // Итоги прогона варианта бенчмарка
+    struct BenchmarkResult
+    {
+        double frame_ms = 0.0;                          // Среднее время кадра (мс)
+        double worst_frame_ms = 0.0;                    // Наибольшее время кадра (мс)
+        unsigned frames = 1;                            // Кол-во кадров замера (не меньше 1, для усреднения)
+        nasral::rendering::FrameStats last = {};        // Статистика последнего кадра
+    };
+
+    /**
+     * Прогон вариантов конфигурации бенчмарка с выводом таблицы (строка на вариант)
+     *
+     * @details Функция варианта изменяет общую конфигурацию (изменения сохраняются для следующих вариантов),
+     * функция отчета выводит столбцы строки после подписи варианта
+     */
+    class BenchmarkSweep
+    {
+    public:
+        typedef std::function<void(nasral::Engine::Config& config)> ConfigureFn;
+        typedef std::function<void(std::ostream& os, const BenchmarkResult& result)> ReportFn;
+
+        BenchmarkSweep(nasral::Engine::Config config, const unsigned warmup_ms, const unsigned frames,
+                       const std::string& title, const std::string& columns)
+        : config_(std::move(config))
+        , warmup_ms_(warmup_ms)
+        , frames_(frames)
+        {
+            std::cout << title << std::endl;
+            std::cout << columns << std::endl;
+        }
+
+        ~BenchmarkSweep() = default;
+
+        BenchmarkResult run(const std::string& label,
+                            const ConfigureFn& configure,
+                            const ReportFn& report,
+                            const Benchmark::FrameFn& on_frame = nullptr)
+        {
+            if (configure) configure(config_);
+            Benchmark benchmark(config_, warmup_ms_, frames_);
+
+            BenchmarkResult result;
+            result.frame_ms = benchmark.run([&](const nasral::Engine& engine, const double frame_ms){
+                result.last = engine.renderer()->frame_stats();
+                if (on_frame) on_frame(engine, frame_ms);
+            });
+            result.worst_frame_ms = benchmark.worst_frame_ms();
+            result.frames = std::max(1u, benchmark.frames());
+
+            std::cout << label << "\t";
+            if (report) report(std::cout, result);
+            std::cout << std::endl;
+            return result;
+        }
+
+    protected:
+        nasral::Engine::Config  config_;
+        unsigned                warmup_ms_;
+        unsigned                frames_;
+    };
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+namespace utils
+{
+    class CmdArgs
+    {
+    public:
+        CmdArgs(const int argc, const char* argv[])
+        {
+            // Аргументы вида "--name value" либо "--name" (флаг)
+            for (int i = 1; i < argc; ++i)
+            {
+                std::string arg = argv[i];
+                if (arg.rfind("--", 0) != 0) continue;
+                arg = arg.substr(2);
+
+                if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0){
+                    args_[arg] = argv[++i];
+                }else{
+                    args_[arg] = "";
+                }
+            }
+        }
+
+        ~CmdArgs() = default;
+
+        [[nodiscard]] bool has(const std::string& name) const
+        {
+            return args_.find(name) != args_.end();
+        }
+
+        [[nodiscard]] std::string value(const std::string& name, const std::string& def = "") const
+        {
+            const auto it = args_.find(name);
+            return it != args_.end() && !it->second.empty() ? it->second : def;
+        }
+
+        [[nodiscard]] unsigned value_uint(const std::string& name, const unsigned def = 0) const
+        {
+            const auto str = value(name);
+            if (str.empty()) return def;
+
+            // Значение должно быть целым неотрицательным числом целиком, иначе используется значение по умолчанию
+            try{
+                size_t parsed = 0;
+                const auto result = std::stoul(str, &parsed);
+                if (str.front() >= '0' && str.front() <= '9' && parsed == str.size()
+                    && static_cast<unsigned>(result) == result)
+                {
+                    return static_cast<unsigned>(result);
+                }
+            }catch(const std::logic_error&){}
+
+            std::cerr << "Invalid value \"" << str << "\" for --" << name << ", using " << def << std::endl;
+            return def;
+        }
+
+    protected:
+        std::unordered_map<std::string, std::string> args_;
+    };
+}
@@ -14,14 +14,25 @@ namespace nasral
             logger_ = std::make_unique<logging::Logger>(config.log);
             logger()->info("Logger initialized.");
 
+            // Зоны CPU записываются с начала инициализации (трассировка сохраняется при завершении)
+            profiling::configure(config.profiling);
+            profiling::set_thread_name("main");
+            trace_file_ = config.profiling.enabled ? config.profiling.trace_file : "";
+            if (config.profiling.enabled){
+                logger()->info("CPU profiling enabled.");
+            }
+
             renderer_ = std::make_unique<rendering::Renderer>(this, config.rendering);
             logger()->info("Renderer initialized.");
 
             resource_manager_ = std::make_unique<resources::ResourceManager>(this, config.resources);
             logger()->info("Resource manager initialized.");
 
-            init_test_scene();
-            logger()->info("Test scene initialized.");
+            // Отсечение на GPU использует вычислительные shader'ы из ресурсов
+            renderer_->init_gpu_culling(resource_manager_.get());
+
+            init_test_scene(config.test);
+            logger()->info("Test scene initialized (" + std::to_string(config.test.node_count) + " nodes).");
 
             return true;
         }
@@ -50,9 +61,23 @@ namespace nasral
         assert(renderer_ != nullptr);
 
         try{
+            profiling::Zone zone("Engine::update");
+
             // Обновление данных материалов (ubo, дескрипторы текстур)
             renderer_->materials_update_unsafe();
 
+            // Замена основных текстур материалов (варианты текстур чередуются каждый кадр)
+            if (test_texture_swaps_){
+                test_texture_parity_ ^= 1u;
+                for (size_t i = 0; i < test_texture_materials_.size(); ++i){
+                    const auto& ref = test_texture_refs_[i * 2 + test_texture_parity_];
+                    renderer_->material_instance_unsafe(test_texture_materials_[i]).set_texture(
+                        rendering::TextureType::eAlbedoColor,
+                        ref.path().data(),
+                        true);
+                }
+            }
+
             // Обновление данных источников света (ubo)
             for (auto& light : test_light_sources_){
                 light.update();
@@ -69,12 +94,18 @@ namespace nasral
             // Обновление данных камеры (ubo)
             renderer_->update_cam_ubo(0, camera_uniforms_);
 
-            // Рендеринг
+            // Отсечение объектов вне пирамиды видимости камеры
+            renderer_->cull_objects(camera_uniforms_.projection * camera_uniforms_.view);
+
+            // Рендеринг (узлы добавляются в очередь, которая сортируется и записывается, возможно несколькими потоками)
             renderer_->cmd_begin_frame();
             renderer_->cmd_bind_frame_descriptors();
             for (auto& node : test_scene_nodes_){
                 node.render();
             }
+            renderer_->cmd_begin_gpu_scope("scene");
+            renderer_->cmd_draw_queue();
+            renderer_->cmd_end_gpu_scope();
             renderer_->cmd_end_frame();
 
             // Обновление состояния ресурсов
@@ -87,14 +118,20 @@ namespace nasral
 
     void Engine::shutdown() noexcept{
         try{
-            if (!test_scene_nodes_.empty()){
+            if (!test_scene_nodes_.empty() || !test_texture_refs_.empty()){
                 renderer_->cmd_wait_for_frame();
                 test_scene_nodes_.clear();
                 test_light_sources_.clear();
+                test_texture_materials_.clear();
+                test_texture_refs_.clear();
                 resource_manager_->finalize();
                 logger()->info("Test scene destroyed.");
             }
 
+            if (renderer_){
+                renderer_->release_gpu_culling();
+            }
+
             if (resource_manager_){
                 resource_manager_.reset();
                 logger()->info("Resource manager destroyed.");
@@ -105,6 +142,13 @@ namespace nasral
                 logger()->info("Renderer destroyed.");
             }
 
+            // Потоки загрузки и записи завершены - зоны больше не пишутся
+            if (!trace_file_.empty()){
+                profiling::save_trace(trace_file_);
+                logger()->info("CPU trace saved (" + trace_file_ + ").");
+                trace_file_.clear();
+            }
+
             if (logger_){
                 logger()->info("Destroying logger.");
                 logger_.reset();
@@ -117,7 +161,7 @@ namespace nasral
 
     /* ТОЛЬКО ДЛЯ ТЕСТИРОВАНИЯ */
 
-    void Engine::init_test_scene()
+    void Engine::init_test_scene(const TestSceneConfig& config)
     {
         // Камера (пока статична)
         const auto aspect = renderer_->get_rendering_aspect();
@@ -125,26 +169,60 @@ namespace nasral
         camera_uniforms_.view = glm::translate(glm::mat4(1.0f), -glm::vec3(0.0f, 0.0f, 2.5f));
         camera_uniforms_.projection = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 100.0f);
 
-        // Материалы
-        const auto chair_phong_idx = renderer_->material_acquire(
-            rendering::MaterialType::ePhong,
-            "materials/phong/material.xml", {
-                "textures/chair/chair_diff_1k.png:v0",
-                "textures/chair/chair_nor_gl_1k.png",
-                "textures/chair/chair_spec_1k.png"
+        // Материалы (варианты с касательными вершин не используют геометрический шейдер)
+        const auto material_path = [&](const std::string& dir){
+            return "materials/" + dir + "/material"
+                + (config.vertex_tangents ? "_tangent" : "")
+                + (config.instanced ? "_instanced" : "")
+                + ".xml";
+        };
+
+        const std::string phong_path = material_path("phong");
+        const auto acquire_phong = [&](const std::string& path, const std::string& albedo = "textures/chair/chair_diff_1k.png:v0"){
+            const auto index = renderer_->material_acquire(
+                rendering::MaterialType::ePhong,
+                path, {
+                    albedo,
+                    "textures/chair/chair_nor_gl_1k.png",
+                    "textures/chair/chair_spec_1k.png"
+                });
+
+            auto& material = renderer_->material_instance_unsafe(index);
+            material.set_settings(rendering::MaterialPhongUniforms{
+                glm::vec4(0.7f, 0.7f, 0.7f, 1.0f),
+                glm::vec4(0.0f, 0.0f, 0.0f, 0.0f),
+                32.0f,
+                0.5f
             });
+            return index;
+        };
 
-        auto& chair_phong_mat = renderer_->material_instance_unsafe(chair_phong_idx);
-        chair_phong_mat.set_settings(rendering::MaterialPhongUniforms{
-            glm::vec4(0.7f, 0.7f, 0.7f, 1.0f),
-            glm::vec4(0.0f, 0.0f, 0.0f, 0.0f),
-            32.0f,
-            0.5f
-        });
+        const auto chair_phong_idx = acquire_phong(phong_path);
+
+        // Варианты Phong материала (отдельные ресурсы и конвейеры, загружаются вместе со сценой)
+        std::vector<uint32_t> phong_variants;
+        phong_variants.reserve(config.material_variants);
+        for (uint32_t v = 0; v < config.material_variants; ++v){
+            phong_variants.push_back(acquire_phong(phong_path + ":v" + std::to_string(v)));
+        }
+
+        // Материалы со встроенными текстурами (пара вариантов на материал, ссылки сцены удерживают оба варианта загруженными)
+        test_texture_swaps_ = config.texture_swaps;
+        test_texture_materials_.reserve(config.texture_materials);
+        test_texture_refs_.reserve(config.texture_materials * 2);
+        for (uint32_t m = 0; m < config.texture_materials; ++m){
+            for (uint32_t v = m * 2; v < m * 2 + 2; ++v){
+                const auto path = resources::builtin_res_path(resources::BuiltinResources::eCheckerboardTexture) + ":v" + std::to_string(v);
+                resource_manager_->add_unsafe(resources::Type::eTexture, path);
+                auto& ref = test_texture_refs_.emplace_back(resource_manager_->make_ref(resources::Type::eTexture, path));
+                ref.request();
+            }
+            test_texture_materials_.push_back(acquire_phong(phong_path, test_texture_refs_[m * 2].path().data()));
+        }
 
         const auto chair_pbr_idx = renderer_->material_acquire(
             rendering::MaterialType::ePbr,
-            "materials/pbr/material.xml", {
+            material_path("pbr"), {
                 "textures/chair/chair_diff_1k.png:v1",
                 "textures/chair/chair_nor_gl_1k.png",
                 "textures/chair/chair_rough_1k.png",
@@ -160,36 +238,76 @@ namespace nasral
             1.0f
         });
 
-        // Узлы сцены
-        test_scene_nodes_.reserve(2);
-        test_scene_nodes_.emplace_back(this);
-        test_scene_nodes_.emplace_back(this);
-
-        // Параметры узла
-        test_scene_nodes_[0].set_position({-0.6f, -0.2f, 0.0f});
-        test_scene_nodes_[0].set_scale({1.5f, 1.5f, 1.5f});
-        test_scene_nodes_[0].set_material(chair_phong_idx);
-        test_scene_nodes_[0].set_mesh(rendering::MeshInstance(resource_manager_.get(), "meshes/chair/chair.obj"));
-        test_scene_nodes_[0].request_resources();
-
-        test_scene_nodes_[1].set_position({0.6f, -0.2f, 0.0f});
-        test_scene_nodes_[1].set_scale({1.5f, 1.5f, 1.5f});
-        test_scene_nodes_[1].set_material(chair_pbr_idx);
-        test_scene_nodes_[1].set_mesh(rendering::MeshInstance(resource_manager_.get(), "meshes/chair/chair.obj"));
-        test_scene_nodes_[1].request_resources();
-
-        // Освещение
-        test_light_sources_.reserve(2);
-        test_light_sources_.emplace_back(this);
-        test_light_sources_.emplace_back(this);
-
-        test_light_sources_[0].set_position({0.0, 2.0f, 3.0f});
-        test_light_sources_[0].set_color({1.0f, 1.0f, 1.0f});
-        test_light_sources_[0].set_intensity(4.0f);
-
-        test_light_sources_[1].set_position({0.0f, -2.0f, 3.0f});
-        test_light_sources_[1].set_color({1.0f, 1.0f, 1.0f});
-        test_light_sources_[1].set_intensity(3.0f);
+        // Узлы сцены (сетка, материалы чередуются, слои сетки уходят вглубь сцены)
+        const uint32_t node_count = config.node_count;
+        const uint32_t layers = std::max(config.layers, 1u);
+        const uint32_t per_layer = (node_count + layers - 1) / layers;
+        const auto columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(per_layer))));
+        const auto rows = columns > 0 ? (per_layer + columns - 1) / columns : 0;
+        test_scene_nodes_.reserve(node_count);
+
+        for (uint32_t i = 0; i < node_count; ++i){
+            const auto layer = static_cast<float>(i / per_layer);
+            const auto column = static_cast<float>(i % per_layer % columns);
+            const auto row = static_cast<float>(i % per_layer / columns);
+            auto& node = test_scene_nodes_.emplace_back(this);
+
+            // Параметры узла
+            node.set_position({
+                (column - static_cast<float>(columns - 1) * 0.5f) * 1.2f,
+                (row - static_cast<float>(rows - 1) * 0.5f) * 1.2f - 0.2f,
+                -layer * 1.2f});
+            node.set_scale({1.5f, 1.5f, 1.5f});
+            if (!test_texture_materials_.empty()){
+                node.set_material(test_texture_materials_[i % test_texture_materials_.size()]);
+            }else if (!phong_variants.empty()){
+                node.set_material(phong_variants[i % phong_variants.size()]);
+            }else{
+                node.set_material(i % 2 == 0 ? chair_phong_idx : chair_pbr_idx);
+            }
+            node.set_mesh(rendering::MeshInstance(resource_manager_.get(), "meshes/chair/chair.obj"));
+            node.request_resources();
+        }
+
+        // Освещение (основные источники без ограничения радиуса)
+        const uint32_t light_count = config.light_count;
+        test_light_sources_.reserve(light_count);
+        for (uint32_t i = 0; i < light_count; ++i){
+            test_light_sources_.emplace_back(this);
+        }
+
+        if (light_count > 0){
+            test_light_sources_[0].set_position({0.0, 2.0f, 3.0f});
+            test_light_sources_[0].set_color({1.0f, 1.0f, 1.0f});
+            test_light_sources_[0].set_intensity(4.0f);
+        }
+
+        if (light_count > 1){
+            test_light_sources_[1].set_position({0.0f, -2.0f, 3.0f});
+            test_light_sources_[1].set_color({1.0f, 1.0f, 1.0f});
+            test_light_sources_[1].set_intensity(3.0f);
+        }
+
+        // Остальные источники с ограниченным радиусом (случайно в объеме сетки узлов, воспроизводимо)
+        std::mt19937 random(42);
+        std::uniform_real_distribution unit(0.0f, 1.0f);
+        const glm::vec3 volume_min(
+            -static_cast<float>(columns) * 0.6f,
+            -static_cast<float>(rows) * 0.6f - 0.2f,
+            -static_cast<float>(layers) * 1.2f);
+        const glm::vec3 volume_max(
+            static_cast<float>(columns) * 0.6f,
+            static_cast<float>(rows) * 0.6f - 0.2f,
+            1.0f);
+
+        for (uint32_t i = 2; i < light_count; ++i){
+            auto& light = test_light_sources_[i];
+            const glm::vec3 t(unit(random), unit(random), unit(random));
+            light.set_position(volume_min + (volume_max - volume_min) * t);
+            light.set_color({0.5f + unit(random) * 0.5f, 0.5f + unit(random) * 0.5f, 0.5f + unit(random) * 0.5f});
+            light.set_intensity(2.0f);
+            light.set_radius(config.light_radius);
+        }
     }
 
     Engine::TestNode::TestNode(const Engine* engine)
@@ -217,8 +335,9 @@ namespace nasral
     void Engine::TestNode::update(){
         auto& renderer = engine_->renderer_;
 
-        // Если параметры узла были обновлены
-        if (spatial_settings_.updated){
+        // Если параметры узла были обновлены (либо загружена геометрия с новыми ограничивающими объемами)
+        const bool mesh_changed = mesh_.check_changes(rendering::MeshInstance::eMeshChanged, false, true);
+        if (spatial_settings_.updated || mesh_changed){
             rendering::ObjectTransformUniforms uniforms{};
             auto& model = uniforms.model;
             auto& normals = uniforms.normals;
@@ -229,22 +348,34 @@ namespace nasral
             model = glm::scale(model, spatial_settings_.scale);
             normals = glm::transpose(glm::inverse(glm::mat3(model)));
             renderer->update_obj_ubo(obj_index_, uniforms);
+
+            // Ограничивающая сфера (в пространстве модели, мировая сфера вычисляется renderer'ом)
+            renderer->update_obj_bounds(obj_index_, mesh_.mesh_bounds().sphere, model);
+
             spatial_settings_.updated = false;
         }
+
+        // Материал должен иметь конвейер для формата вершин загруженной геометрии
+        if (mesh_.mesh_render_handles()){
+            renderer->material_instance_unsafe(material_index_).use_vertex_format(mesh_.mesh_render_handles().vertex_format);
+        }
     }
 
     void Engine::TestNode::render() const{
         auto& renderer = engine_->renderer_;
         const auto& material = engine_->renderer_->material_instance_unsafe(material_index_);
+        const auto& mesh = mesh_.mesh_render_handles();
+        if (!mesh || !renderer->is_obj_visible(obj_index_)) return;
 
-        if (!mesh_.mesh_render_handles()
-            || !material.mat_render_handles())
-        {
-            return;
-        }
+        // Конвейер материала для формата вершин геометрии
+        const auto mat_handles = material.mat_render_handles(mesh.vertex_format);
+        if (!mat_handles) return;
+
+        // Расстояние до камеры (для сортировки от ближних к дальним)
+        const auto& camera_position = glm::vec3(engine_->camera_uniforms_.position);
+        const float depth = glm::length(spatial_settings_.position - camera_position);
 
-        renderer->cmd_bind_material(material.mat_render_handles(), material_index_);
-        renderer->cmd_draw_mesh(mesh_.mesh_render_handles(), obj_index_);
+        renderer->queue_draw(mat_handles, material_index_, mesh, obj_index_, depth);
     }
 
     void Engine::TestNode::set_position(const glm::vec3& position){
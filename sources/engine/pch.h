@@ -24,6 +24,7 @@
 #include <set>
 #include <map>
 #include <atomic>
+#include <random>
 
 // Математика
 #include <glm/glm.hpp>
@@ -0,0 +1,215 @@
+#include "pch.h"
+#include <nasral/profiling/profiler.h>
+
+namespace nasral::profiling
+{
+    namespace
+    {
+        // Завершенная зона (время - в наносекундах от начала записи)
+        struct Event
+        {
+            const char* name = nullptr;
+            int64_t start_ns = 0;
+            int64_t end_ns = 0;
+            uint32_t tid = 0;
+            char detail[Zone::kDetailSize] = {};
+        };
+
+        // Кольцевой буфер зон (пишет только поток-владелец, head - общее кол-во записанных зон)
+        struct ThreadBuffer
+        {
+            std::vector<Event> events;
+            std::atomic<uint64_t> head{0};
+        };
+
+        // Буферы всех потоков (буферы завершенных потоков переиспользуются новыми, их зоны сохраняются)
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            std::vector<std::shared_ptr<ThreadBuffer>> free_buffers;
+            std::vector<std::pair<uint32_t, std::string>> thread_names;
+            std::atomic<bool> enabled{false};
+            std::atomic<uint32_t> next_tid{1};
+            size_t capacity = 65536;
+            std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+        };
+
+        Registry& registry(){
+            static Registry r;
+            return r;
+        }
+
+        // Состояние потока (при завершении потока буфер возвращается в реестр)
+        struct ThreadState
+        {
+            std::shared_ptr<ThreadBuffer> buffer;
+            uint32_t tid = 0;
+            std::string name;
+
+            ~ThreadState(){
+                if (!buffer) return;
+                auto& r = registry();
+                std::lock_guard lock(r.mutex);
+                r.free_buffers.push_back(std::move(buffer));
+            }
+
+            uint32_t id(){
+                if (tid == 0) tid = registry().next_tid.fetch_add(1, std::memory_order_relaxed);
+                return tid;
+            }
+
+            ThreadBuffer& acquire_buffer(){
+                if (buffer) return *buffer;
+                auto& r = registry();
+                std::lock_guard lock(r.mutex);
+                if (!r.free_buffers.empty()){
+                    buffer = std::move(r.free_buffers.back());
+                    r.free_buffers.pop_back();
+                }else{
+                    buffer = std::make_shared<ThreadBuffer>();
+                    buffer->events.resize(r.capacity);
+                    r.buffers.push_back(buffer);
+                }
+                return *buffer;
+            }
+        };
+
+        thread_local ThreadState t_state;
+
+        int64_t now_ns(){
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - registry().origin).count();
+        }
+
+        // Строка JSON (кавычки, обратные косые черты и управляющие символы экранируются)
+        void write_json_string(std::ostream& os, const std::string_view& str){
+            os << '"';
+            for (const char c : str){
+                switch (c){
+                case '"': os << "\\\""; break;
+                case '\\': os << "\\\\"; break;
+                case '\n': os << "\\n"; break;
+                case '\t': os << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) os << ' ';
+                    else os << c;
+                }
+            }
+            os << '"';
+        }
+    }
+
+    Zone::Zone(const char* name, const std::string_view detail) noexcept
+        : name_(name)
+        , start_ns_(0)
+        , active_(registry().enabled.load(std::memory_order_relaxed))
+        , detail_{}
+    {
+        if (!active_) return;
+        // Усечение не разрывает многобайтовый символ UTF-8 (продолжающие байты - 10xxxxxx)
+        auto size = std::min(detail.size(), kDetailSize - 1);
+        while (size > 0 && size < detail.size() && (static_cast<unsigned char>(detail[size]) & 0xC0) == 0x80){
+            --size;
+        }
+        std::memcpy(detail_, detail.data(), size);
+        start_ns_ = now_ns();
+    }
+
+    Zone::~Zone(){
+        end();
+    }
+
+    void Zone::end() noexcept{
+        if (!active_) return;
+        active_ = false;
+
+        try{
+            auto& buffer = t_state.acquire_buffer();
+            const auto head = buffer.head.load(std::memory_order_relaxed);
+            auto& event = buffer.events[head % buffer.events.size()];
+            event.name = name_;
+            event.start_ns = start_ns_;
+            event.end_ns = now_ns();
+            event.tid = t_state.id();
+            std::memcpy(event.detail, detail_, kDetailSize);
+            buffer.head.store(head + 1, std::memory_order_release);
+        }catch(...){
+            // Буфер потока не выделен - зона не записывается
+        }
+    }
+
+    void configure(const ProfilingConfig& config){
+        auto& r = registry();
+        {
+            std::lock_guard lock(r.mutex);
+            r.capacity = std::max<size_t>(config.zones_per_thread, 1);
+        }
+        r.enabled.store(config.enabled, std::memory_order_relaxed);
+    }
+
+    void set_thread_name(const std::string& name){
+        if (!is_enabled() || t_state.name == name) return;
+        t_state.name = name;
+
+        auto& r = registry();
+        std::lock_guard lock(r.mutex);
+        r.thread_names.emplace_back(t_state.id(), name);
+    }
+
+    bool is_enabled() noexcept{
+        return registry().enabled.load(std::memory_order_relaxed);
+    }
+
+    void save_trace(const std::string& path){
+        const std::filesystem::path fp(path);
+        if (fp.has_parent_path()){
+            std::filesystem::create_directories(fp.parent_path());
+        }
+
+        std::ofstream file(fp, std::ios::trunc);
+        if (!file.is_open()){
+            throw std::runtime_error("Can't open file " + fp.string());
+        }
+
+        // Буферы читаются без остановки потоков (сохранять следует, когда потоки не пишут зоны)
+        auto& r = registry();
+        std::lock_guard lock(r.mutex);
+
+        file.setf(std::ios::fixed);
+        file.precision(3);
+        file << "{\"traceEvents\":[\n";
+
+        bool first = true;
+        for (const auto& [tid, name] : r.thread_names){
+            file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":";
+            write_json_string(file, name);
+            file << "}}";
+            first = false;
+        }
+
+        // Зоны - события с длительностью (время в микросекундах)
+        for (const auto& buffer : r.buffers){
+            const auto head = buffer->head.load(std::memory_order_acquire);
+            const auto capacity = buffer->events.size();
+            const auto count = std::min<uint64_t>(head, capacity);
+            for (uint64_t i = head - count; i < head; ++i){
+                const auto& event = buffer->events[i % capacity];
+                file << (first ? "" : ",\n") << "{\"name\":";
+                write_json_string(file, event.name);
+                file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.tid
+                     << ",\"ts\":" << static_cast<double>(event.start_ns) / 1000.0
+                     << ",\"dur\":" << static_cast<double>(event.end_ns - event.start_ns) / 1000.0;
+                if (event.detail[0] != '\0'){
+                    file << ",\"args\":{\"detail\":";
+                    write_json_string(file, event.detail);
+                    file << "}";
+                }
+                file << "}";
+                first = false;
+            }
+        }
+
+        file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+}
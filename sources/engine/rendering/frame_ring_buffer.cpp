@@ -0,0 +1,173 @@
+#include "pch.h"
+#include <nasral/rendering/frame_ring_buffer.h>
+#include <nasral/rendering/renderer.h>
+
+namespace nasral::rendering
+{
+    FrameRingBuffer::FrameRingBuffer(
+        const Renderer* renderer,
+        const vk::DeviceSize stride,
+        const uint32_t capacity,
+        const uint32_t frames,
+        const vk::BufferUsageFlags usage,
+        const vk::DeviceSize offset_alignment,
+        const bool device_local)
+        : renderer_(renderer)
+        , stride_(stride)
+        , region_size_(0)
+        , usage_(usage)
+        , offset_alignment_(offset_alignment)
+        , device_local_(device_local)
+        , capacity_(capacity)
+        , allocated_(0)
+        , shadow_(stride * capacity, 0)
+        , used_(0)
+        , dirty_(frames)
+        , dirty_flags_(frames, std::vector<uint8_t>(capacity, 0))
+    {
+        assert(stride_ > 0);
+        assert(capacity_ > 0);
+        assert(frames > 0);
+
+        allocate();
+    }
+
+    void FrameRingBuffer::reserve(const uint32_t capacity){
+        if (capacity <= capacity_) return;
+
+        // Растет только копия CPU - буферы кадров могут читаться GPU, они перевыделяются отдельно (reallocate)
+        capacity_ = capacity;
+        shadow_.resize(stride_ * capacity_, 0);
+        for (auto& flags : dirty_flags_){
+            flags.resize(capacity_, 0);
+        }
+    }
+
+    bool FrameRingBuffer::reallocate(std::vector<vk::utils::Buffer::Ptr>& retired){
+        if (allocated_ == capacity_) return false;
+
+        // Старые буферы могут читаться активными кадрами, они освобождаются вызывающей стороной
+        retired.push_back(std::move(buffer_));
+        if (staging_) retired.push_back(std::move(staging_));
+        allocate();
+
+        // Области новых буферов пусты - все записанные элементы переносятся в каждую из них
+        for (size_t f = 0; f < dirty_.size(); ++f){
+            dirty_[f].clear();
+            for (uint32_t i = 0; i < used_; ++i){
+                dirty_[f].push_back(i);
+            }
+            std::fill_n(dirty_flags_[f].begin(), used_, 1);
+        }
+        return true;
+    }
+
+    void FrameRingBuffer::allocate(){
+        const auto& device = renderer_->vk_device();
+        const auto frames = dirty_.size();
+        region_size_ = size_align(stride_ * capacity_, offset_alignment_);
+        allocated_ = capacity_;
+
+        if (device_local_){
+            // Буфер в памяти устройства (GPU читает его каждый кадр), заполняется копированием из промежуточного
+            buffer_ = std::make_unique<vk::utils::Buffer>(
+                device,
+                region_size_ * frames,
+                usage_ | vk::BufferUsageFlagBits::eTransferDst,
+                vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+            staging_ = std::make_unique<vk::utils::Buffer>(
+                device,
+                region_size_ * frames,
+                vk::BufferUsageFlagBits::eTransferSrc,
+                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+            staging_->map_unsafe();
+        }else{
+            buffer_ = std::make_unique<vk::utils::Buffer>(
+                device,
+                region_size_ * frames,
+                usage_,
+                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+            // Области всех кадров начинают с одинакового (нулевого) содержимого
+            std::memset(buffer_->map_unsafe(), 0, region_size_ * frames);
+        }
+
+        for (auto& dirty : dirty_){
+            dirty.reserve(capacity_);
+        }
+        copy_regions_.reserve(capacity_);
+    }
+
+    void FrameRingBuffer::update(const uint32_t index, const void* data, const vk::DeviceSize size){
+        assert(index < capacity_);
+        assert(size <= stride_);
+        assert(data != nullptr);
+        if (index >= capacity_) return;
+
+        // Запись только в копию CPU - области кадров могут читаться GPU
+        std::memcpy(shadow_.data() + stride_ * index, data, size);
+        used_ = std::max(used_, index + 1);
+
+        // Элемент должен попасть в область каждого кадра при её следующем заполнении
+        for (size_t f = 0; f < dirty_.size(); ++f){
+            if (!dirty_flags_[f][index]){
+                dirty_flags_[f][index] = 1;
+                dirty_[f].push_back(index);
+            }
+        }
+    }
+
+    vk::DeviceSize FrameRingBuffer::flush(const size_t frame_index, const vk::CommandBuffer& cmd_buffer){
+        assert(frame_index < dirty_.size());
+        auto& dirty = dirty_[frame_index];
+        if (dirty.empty()) return 0;
+
+        // Элементы за пределами выделенных буферов остаются измененными до их перевыделения
+        const auto pending = std::partition(dirty.begin(), dirty.end(), [this](const uint32_t index){ return index < allocated_; });
+        const auto count = to<size_t>(std::distance(dirty.begin(), pending));
+        const auto used = std::min(used_, allocated_);
+        if (count == 0) return 0;
+
+        // Данные кадра пишутся в его область (промежуточного буфера, если основной в памяти устройства)
+        auto& flags = dirty_flags_[frame_index];
+        const auto offset = region_offset(frame_index);
+        auto* region = static_cast<uint8_t*>((staging_ ? staging_ : buffer_)->mapped_ptr(offset));
+        copy_regions_.clear();
+
+        // Если изменена значительная часть элементов - одно копирование всей занятой области дешевле поэлементного
+        vk::DeviceSize bytes = 0;
+        if (count * 4 >= used){
+            bytes = stride_ * used;
+            std::memcpy(region, shadow_.data(), bytes);
+            std::fill_n(flags.begin(), used, 0);
+            copy_regions_.emplace_back(offset, offset, bytes);
+        }else{
+            // Упорядоченные элементы позволяют объединить смежные в один отрезок копирования
+            std::sort(dirty.begin(), pending);
+            for (auto it = dirty.begin(); it != pending; ++it){
+                const auto index = *it;
+                const auto element_offset = stride_ * index;
+                std::memcpy(region + element_offset, shadow_.data() + element_offset, stride_);
+                flags[index] = 0;
+
+                if (!copy_regions_.empty() && copy_regions_.back().srcOffset + copy_regions_.back().size == offset + element_offset){
+                    copy_regions_.back().size += stride_;
+                }else{
+                    copy_regions_.emplace_back(offset + element_offset, offset + element_offset, stride_);
+                }
+            }
+            bytes = stride_ * count;
+        }
+        dirty.erase(dirty.begin(), pending);
+
+        // Перенос измененных отрезков в память устройства (одна команда копирования на буфер)
+        if (staging_){
+            assert(cmd_buffer);
+            cmd_buffer.copyBuffer(staging_->vk_buffer(), buffer_->vk_buffer(), copy_regions_);
+        }
+
+        return bytes;
+    }
+}
@@ -0,0 +1,166 @@
+#include "pch.h"
+#include <nasral/rendering/frustum_culler.h>
+#include <bitset>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define NASRAL_CULL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NASRAL_CULL_SSE
+#endif
+
+namespace nasral::rendering
+{
+    // Ширина блока отсечения (объектов за итерацию)
+    constexpr size_t kCullBlockWidth = 8;
+
+    FrustumCuller::FrustumCuller(const size_t capacity)
+        : count_(0)
+    {
+        reserve(capacity);
+    }
+
+    void FrustumCuller::reserve(const size_t capacity){
+        // Емкость кратна ширине блока, хвост заполнен неактивными объектами
+        const size_t aligned = (capacity + kCullBlockWidth - 1) / kCullBlockWidth * kCullBlockWidth;
+        if (aligned <= r_.size()) return;
+        x_.resize(aligned, 0.0f);
+        y_.resize(aligned, 0.0f);
+        z_.resize(aligned, 0.0f);
+        r_.resize(aligned, -1.0f);
+        visible_.resize(aligned, 0);
+    }
+
+    void FrustumCuller::set_sphere(const uint32_t index, const glm::vec4& sphere){
+        assert(index < r_.size());
+        x_[index] = sphere.x;
+        y_[index] = sphere.y;
+        z_[index] = sphere.z;
+        r_[index] = std::max(sphere.w, 0.0f);
+        count_ = std::max(count_, (index / kCullBlockWidth + 1) * kCullBlockWidth);
+    }
+
+    void FrustumCuller::reset(const uint32_t index){
+        assert(index < r_.size());
+        r_[index] = -1.0f;
+        visible_[index] = 0;
+    }
+
+    void FrustumCuller::reset_all(){
+        std::fill(r_.begin(), r_.end(), -1.0f);
+        std::fill(visible_.begin(), visible_.end(), 0);
+        count_ = 0;
+    }
+
+    void FrustumCuller::cull(const glm::mat4& view_proj){
+        const auto started = std::chrono::steady_clock::now();
+
+        stats_ = {};
+        cull_range(extract_planes(view_proj), 0, count_);
+
+        stats_.cull_time_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - started).count();
+    }
+
+    std::array<glm::vec4, 6> FrustumCuller::extract_planes(const glm::mat4& view_proj){
+        // Строки матрицы (glm хранит матрицы по столбцам)
+        const auto row = [&view_proj](const int i){
+            return glm::vec4(view_proj[0][i], view_proj[1][i], view_proj[2][i], view_proj[3][i]);
+        };
+
+        // Плоскости пирамиды видимости (Gribb/Hartmann), нормали направлены внутрь
+        // Ближняя плоскость для глубины [-1, 1] - для [0, 1] она лишь немного консервативнее
+        std::array planes{
+            row(3) + row(0),    // Левая
+            row(3) - row(0),    // Правая
+            row(3) + row(1),    // Нижняя
+            row(3) - row(1),    // Верхняя
+            row(3) + row(2),    // Ближняя
+            row(3) - row(2)     // Дальняя
+        };
+
+        // Нормализация (расстояние до плоскости сравнивается с радиусом сферы)
+        for (auto& plane : planes){
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return planes;
+    }
+
+    void FrustumCuller::cull_range(const std::array<glm::vec4, 6>& planes, const size_t begin, const size_t end){
+        assert(begin % kCullBlockWidth == 0 && end % kCullBlockWidth == 0);
+        uint32_t visible = 0;
+        uint32_t active = 0;
+
+#if defined(NASRAL_CULL_AVX)
+        // AVX - 8 сфер за итерацию
+        const __m256 zero = _mm256_setzero_ps();
+        for (size_t i = begin; i < end; i += 8){
+            const __m256 x = _mm256_loadu_ps(&x_[i]);
+            const __m256 y = _mm256_loadu_ps(&y_[i]);
+            const __m256 z = _mm256_loadu_ps(&z_[i]);
+            const __m256 r = _mm256_loadu_ps(&r_[i]);
+            const __m256 neg_r = _mm256_sub_ps(zero, r);
+
+            // Сфера видима, если она не целиком за одной из плоскостей (расстояние >= -радиус)
+            __m256 inside = _mm256_cmp_ps(r, zero, _CMP_GE_OQ);
+            const int active_bits = _mm256_movemask_ps(inside);
+            for (const auto& p : planes){
+                __m256 d = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(p.x)), _mm256_set1_ps(p.w));
+                d = _mm256_add_ps(d, _mm256_mul_ps(y, _mm256_set1_ps(p.y)));
+                d = _mm256_add_ps(d, _mm256_mul_ps(z, _mm256_set1_ps(p.z)));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, neg_r, _CMP_GE_OQ));
+            }
+
+            const int bits = _mm256_movemask_ps(inside);
+            for (size_t k = 0; k < 8; ++k){
+                visible_[i + k] = static_cast<uint8_t>((bits >> k) & 1);
+            }
+            visible += to<uint32_t>(std::bitset<8>(bits).count());
+            active += to<uint32_t>(std::bitset<8>(active_bits).count());
+        }
+#elif defined(NASRAL_CULL_SSE)
+        // SSE - 4 сферы за итерацию
+        const __m128 zero = _mm_setzero_ps();
+        for (size_t i = begin; i < end; i += 4){
+            const __m128 x = _mm_loadu_ps(&x_[i]);
+            const __m128 y = _mm_loadu_ps(&y_[i]);
+            const __m128 z = _mm_loadu_ps(&z_[i]);
+            const __m128 r = _mm_loadu_ps(&r_[i]);
+            const __m128 neg_r = _mm_sub_ps(zero, r);
+
+            // Сфера видима, если она не целиком за одной из плоскостей (расстояние >= -радиус)
+            __m128 inside = _mm_cmpge_ps(r, zero);
+            const int active_bits = _mm_movemask_ps(inside);
+            for (const auto& p : planes){
+                __m128 d = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(p.x)), _mm_set1_ps(p.w));
+                d = _mm_add_ps(d, _mm_mul_ps(y, _mm_set1_ps(p.y)));
+                d = _mm_add_ps(d, _mm_mul_ps(z, _mm_set1_ps(p.z)));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(d, neg_r));
+            }
+
+            const int bits = _mm_movemask_ps(inside);
+            for (size_t k = 0; k < 4; ++k){
+                visible_[i + k] = static_cast<uint8_t>((bits >> k) & 1);
+            }
+            visible += to<uint32_t>(std::bitset<4>(bits).count());
+            active += to<uint32_t>(std::bitset<4>(active_bits).count());
+        }
+#else
+        // Без SIMD - по одной сфере
+        for (size_t i = begin; i < end; ++i){
+            const bool is_active = r_[i] >= 0.0f;
+            bool inside = is_active;
+            for (const auto& p : planes){
+                inside = inside && (p.x * x_[i] + p.y * y_[i] + p.z * z_[i] + p.w >= -r_[i]);
+            }
+            visible_[i] = static_cast<uint8_t>(inside);
+            visible += inside ? 1 : 0;
+            active += is_active ? 1 : 0;
+        }
+#endif
+
+        stats_.visible += visible;
+        stats_.culled += active - visible;
+    }
+}
@@ -0,0 +1,563 @@
+#include "pch.h"
+#include <nasral/rendering/gpu_culler.h>
+#include <nasral/rendering/frustum_culler.h>
+#include <nasral/rendering/gpu_profiler.h>
+#include <nasral/rendering/renderer.h>
+#include <nasral/resources/resource_manager.h>
+#include <nasral/resources/shader.h>
+
+namespace nasral::rendering
+{
+    // Размеры рабочих групп вычислительных shader'ов
+    constexpr uint32_t kCullGroupSize = 64;
+    constexpr uint32_t kPyramidGroupSize = 8;
+
+    // Push-константы прохода отсечения
+    struct CullPushConstants
+    {
+        uint32_t candidate_base = 0;
+        uint32_t candidate_count = 0;
+        uint32_t occlusion = 0;
+        uint32_t reserved = 0;
+    };
+
+    // Push-константы прохода отсечения кластеров (рабочая группа на кандидата)
+    struct MeshletPushConstants
+    {
+        uint32_t candidate_base = 0;
+        uint32_t candidate_count = 0;
+        uint32_t meshlet_count = 0;
+        uint32_t command_capacity = 0;
+        uint32_t instance_base = 0;
+        uint32_t reserved[3] = {};
+    };
+
+    // Push-константы построения уровня пирамиды
+    struct PyramidPushConstants
+    {
+        uint32_t src_width = 0;
+        uint32_t src_height = 0;
+        uint32_t dst_width = 0;
+        uint32_t dst_height = 0;
+    };
+
+    GpuCuller::GpuCuller(const Renderer* renderer, resources::ResourceManager* manager)
+        : renderer_(renderer)
+        , cull_shader_res_(manager, resources::Type::eShader, "materials/gpu-culling/cull.comp.spv")
+        , meshlet_shader_res_(manager, resources::Type::eShader, "materials/gpu-culling/meshlets.comp.spv")
+        , pyramid_shader_res_(manager, resources::Type::eShader, "materials/gpu-culling/pyramid.comp.spv")
+        , capacity_(renderer->draw_capacity())
+        , pyramid_valid_(false)
+        , view_proj_(glm::identity<glm::mat4>())
+        , pyramid_view_proj_(glm::identity<glm::mat4>())
+        , camera_position_(0.0f)
+    {
+        const auto& vd = renderer_->vk_device();
+        const auto frames = renderer_->config().max_frames_in_flight;
+        frames_.resize(frames);
+
+        // Параметры отсечения (область на каждый активный кадр)
+        const auto ubo_alignment = vd->physical_device().getProperties().limits.minUniformBufferOffsetAlignment;
+        vk_ubo_culling_ = std::make_unique<vk::utils::Buffer>(
+            vd,
+            size_align(sizeof(GpuCullingUniforms), ubo_alignment) * frames,
+            vk::BufferUsageFlagBits::eUniformBuffer,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+        vk_ubo_culling_->map_unsafe();
+        init_candidates();
+
+        // Командные буферы вычислительного прохода (исполняются перед основным буфером кадра)
+        auto& pool = vd->queue_group(to<size_t>(Renderer::CommandGroup::eGraphicsAndPresent)).command_pools[0];
+        vk_command_buffers_ = vd->logical_device().allocateCommandBuffersUnique(
+            vk::CommandBufferAllocateInfo()
+            .setCommandPool(pool.get())
+            .setLevel(vk::CommandBufferLevel::ePrimary)
+            .setCommandBufferCount(frames));
+
+        // Пирамида глубины и дескрипторы (зависят от размеров кадровых буферов)
+        refresh_framebuffers();
+
+        // Запрос вычислительных shader'ов, конвейеры создаются по готовности
+        cull_shader_res_.set_callback([this](resources::IResource* resource){
+            const auto* shader = dynamic_cast<resources::Shader*>(resource);
+            if (shader && shader->status() == resources::Status::eLoaded){
+                vk_cull_pipeline_ = renderer_->create_compute_pipeline(UniformLayoutType::eGpuCulling, shader->vk_shader_module());
+            }
+        });
+        cull_shader_res_.request();
+
+        // Отсечение кластеров нужно только при включенной опции (shader не запрашивается без необходимости)
+        if (renderer_->config().meshlet_culling){
+            meshlet_shader_res_.set_callback([this](resources::IResource* resource){
+                const auto* shader = dynamic_cast<resources::Shader*>(resource);
+                if (shader && shader->status() == resources::Status::eLoaded){
+                    vk_meshlet_pipeline_ = renderer_->create_compute_pipeline(UniformLayoutType::eGpuCulling, shader->vk_shader_module());
+                }
+            });
+            meshlet_shader_res_.request();
+        }
+
+        pyramid_shader_res_.set_callback([this](resources::IResource* resource){
+            const auto* shader = dynamic_cast<resources::Shader*>(resource);
+            if (shader && shader->status() == resources::Status::eLoaded){
+                vk_pyramid_pipeline_ = renderer_->create_compute_pipeline(UniformLayoutType::eGpuCulling, shader->vk_shader_module());
+            }
+        });
+        pyramid_shader_res_.request();
+    }
+
+    GpuCuller::~GpuCuller(){
+        cull_shader_res_.release();
+        meshlet_shader_res_.release();
+        pyramid_shader_res_.release();
+    }
+
+    void GpuCuller::refresh_framebuffers(){
+        // Старые наборы ссылаются на представления, которые будут пересозданы
+        vk_dsets_pyramid_depth_.clear();
+        vk_dsets_pyramid_levels_.clear();
+        vk_pyramid_levels_.clear();
+        vk_depth_views_.clear();
+
+        init_pyramid();
+        init_descriptors();
+
+        // Пирамида будет построена заново по глубине следующего кадра
+        pyramid_valid_ = false;
+    }
+
+    void GpuCuller::reserve(const uint32_t capacity, std::vector<vk::utils::Buffer::Ptr>& retired){
+        if (capacity <= capacity_) return;
+
+        // Старые буферы могут читаться активными кадрами, они освобождаются вызывающей стороной
+        capacity_ = capacity;
+        retired.push_back(std::move(vk_candidates_));
+        retired.push_back(std::move(vk_meshlet_candidates_));
+        init_candidates();
+
+        // Задания активных кадров относятся к замененным буферам (результаты их отсечения не читаются)
+        reset_frames();
+    }
+
+    void GpuCuller::reset_frames(){
+        for (auto& work : frames_){
+            work = {};
+        }
+    }
+
+    void GpuCuller::set_view(const glm::mat4& view_proj, const glm::vec3& camera_position){
+        view_proj_ = view_proj;
+        camera_position_ = camera_position;
+    }
+
+    void GpuCuller::set_frame_candidates(
+        const size_t frame_index,
+        const uint32_t candidate_count,
+        const uint32_t command_count,
+        const std::vector<MeshletBatch>& meshlet_batches)
+    {
+        assert(frame_index < frames_.size());
+        assert(candidate_count <= capacity_);
+        assert(meshlet_batches.size() <= MAX_MESHLET_BATCHES);
+        frames_[frame_index].candidate_count = candidate_count;
+        frames_[frame_index].command_count = command_count;
+        frames_[frame_index].meshlet_batches = meshlet_batches;
+    }
+
+    void GpuCuller::read_back(const size_t frame_index){
+        assert(frame_index < frames_.size());
+
+        // Кадр с этим индексом завершен - счетчики экземпляров его команд заполнены вычислительным проходом
+        const auto& work = frames_[frame_index];
+        const auto* commands = static_cast<const vk::DrawIndexedIndirectCommand*>(
+            renderer_->vk_indirect_commands().mapped_ptr()) + frame_index * capacity_;
+        const auto* counts = static_cast<const uint32_t*>(
+            renderer_->vk_indirect_counts().mapped_ptr()) + frame_index * capacity_;
+
+        stats_ = {};
+        stats_.candidates = work.candidate_count;
+
+        // Команды пакетов с кластерами (по команде на видимый кластер) не относятся к экземплярам объектов
+        auto batch = work.meshlet_batches.begin();
+        for (uint32_t i = 0; i < work.command_count; ++i){
+            if (batch != work.meshlet_batches.end() && i == batch->first_command){
+                stats_.meshlets_tested += batch->candidate_count * batch->meshlet_count;
+                stats_.meshlets_visible += std::min(counts[i], batch->command_capacity);
+                i += batch->command_capacity - 1;
+                ++batch;
+                continue;
+            }
+            stats_.visible += commands[i].instanceCount;
+        }
+    }
+
+    vk::CommandBuffer GpuCuller::cmd_cull(const size_t frame_index, GpuProfiler* profiler){
+        assert(frame_index < frames_.size());
+        const auto& work = frames_[frame_index];
+        if (!is_ready() || (work.candidate_count == 0 && work.meshlet_batches.empty())) return VK_NULL_HANDLE;
+
+        const auto& ul = renderer_->vk_uniform_layout(UniformLayoutType::eGpuCulling);
+        const auto& pl = ul.vk_pipeline_layout();
+
+        // Параметры отсечения кадра (пирамида построена по глубине предыдущего кадра)
+        GpuCullingUniforms uniforms{};
+        uniforms.view_proj = view_proj_;
+        uniforms.prev_view_proj = pyramid_view_proj_;
+        const auto planes = FrustumCuller::extract_planes(view_proj_);
+        std::copy(planes.begin(), planes.end(), uniforms.planes);
+        const auto& base = pyramid_extents_.front();
+        uniforms.pyramid = glm::vec4(
+            to<float>(base.width),
+            to<float>(base.height),
+            to<float>(pyramid_extents_.size()),
+            renderer_->config().use_opengl_style ? -1.0f : 1.0f);
+        uniforms.camera_position = glm::vec4(camera_position_, 1.0f);
+
+        const auto ubo_alignment = renderer_->vk_device()->physical_device().getProperties().limits.minUniformBufferOffsetAlignment;
+        vk_ubo_culling_->update_mapped(
+            size_align(sizeof(GpuCullingUniforms), ubo_alignment) * frame_index,
+            sizeof(GpuCullingUniforms),
+            &uniforms);
+
+        CullPushConstants push{};
+        push.candidate_base = to<uint32_t>(frame_index) * capacity_;
+        push.candidate_count = work.candidate_count;
+        push.occlusion = pyramid_valid_ ? 1u : 0u;
+
+        // Запись команд. Каждый видимый кандидат добавляется в экземпляры своей команды
+        auto& cmd_buffer = vk_command_buffers_[frame_index];
+        cmd_buffer->reset();
+        cmd_buffer->begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        if (profiler){
+            profiler->set_cmd_buffer(cmd_buffer.get());
+            profiler->cmd_begin_scope("gpu culling");
+        }
+        cmd_buffer->bindDescriptorSets(vk::PipelineBindPoint::eCompute, pl, 0, {vk_dsets_cull_[frame_index].get()}, {});
+        if (work.candidate_count > 0){
+            cmd_buffer->bindPipeline(vk::PipelineBindPoint::eCompute, vk_cull_pipeline_.get());
+            cmd_buffer->pushConstants(pl, vk::ShaderStageFlagBits::eCompute, 0, sizeof(push), &push);
+            cmd_buffer->dispatch((work.candidate_count + kCullGroupSize - 1) / kCullGroupSize, 1, 1);
+        }
+
+        // Кластеры пакетов: видимые кластеры каждого объекта дописываются в команды пакета (кол-во - в счетчике пакета).
+        // Экземпляр команды кластера указывает сразу на объект (область тождественных индексов после областей кадров)
+        if (!work.meshlet_batches.empty() && vk_meshlet_pipeline_){
+            const auto dset_base = frame_index * MAX_MESHLET_BATCHES;
+            std::vector<vk::DescriptorBufferInfo> buffer_infos;
+            std::vector<vk::WriteDescriptorSet> writes;
+            buffer_infos.reserve(work.meshlet_batches.size());
+            writes.reserve(work.meshlet_batches.size());
+
+            // Наборы кадра не используются (предыдущий кадр с этим индексом завершен)
+            for (size_t b = 0; b < work.meshlet_batches.size(); ++b){
+                buffer_infos.emplace_back(vk::DescriptorBufferInfo()
+                    .setBuffer(work.meshlet_batches[b].meshlet_buffer)
+                    .setOffset(0)
+                    .setRange(VK_WHOLE_SIZE));
+                writes.emplace_back(vk::WriteDescriptorSet()
+                    .setDstSet(vk_dsets_meshlets_[dset_base + b].get())
+                    .setDstBinding(0)
+                    .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                    .setDescriptorCount(1)
+                    .setPBufferInfo(&buffer_infos.back()));
+            }
+            renderer_->vk_device()->logical_device().updateDescriptorSets(writes, {});
+
+            cmd_buffer->bindPipeline(vk::PipelineBindPoint::eCompute, vk_meshlet_pipeline_.get());
+            for (size_t b = 0; b < work.meshlet_batches.size(); ++b){
+                const auto& batch = work.meshlet_batches[b];
+
+                MeshletPushConstants meshlet_push{};
+                meshlet_push.candidate_base = to<uint32_t>(frame_index) * capacity_ + batch.first_candidate;
+                meshlet_push.candidate_count = batch.candidate_count;
+                meshlet_push.meshlet_count = batch.meshlet_count;
+                meshlet_push.command_capacity = batch.command_capacity;
+                meshlet_push.instance_base = to<uint32_t>(frames_.size()) * capacity_;
+
+                cmd_buffer->bindDescriptorSets(vk::PipelineBindPoint::eCompute, pl, 2, {vk_dsets_meshlets_[dset_base + b].get()}, {});
+                cmd_buffer->pushConstants(pl, vk::ShaderStageFlagBits::eCompute, 0, sizeof(meshlet_push), &meshlet_push);
+                cmd_buffer->dispatch(batch.candidate_count, 1, 1);
+            }
+        }
+
+        // Команды и индексы экземпляров читаются при непрямой отрисовке основного буфера кадра
+        const auto barrier = vk::MemoryBarrier()
+            .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+            .setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eShaderRead);
+
+        cmd_buffer->pipelineBarrier(
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexShader,
+            {},
+            {barrier},
+            {},
+            {});
+
+        if (profiler){
+            profiler->cmd_end_scope();
+        }
+        cmd_buffer->end();
+        return cmd_buffer.get();
+    }
+
+    void GpuCuller::cmd_build_pyramid(const vk::CommandBuffer& cmd_buffer, const size_t framebuffer_index){
+        if (!is_ready()) return;
+        assert(framebuffer_index < vk_dsets_pyramid_depth_.size());
+
+        const auto& ul = renderer_->vk_uniform_layout(UniformLayoutType::eGpuCulling);
+        const auto& pl = ul.vk_pipeline_layout();
+        const auto& depth = renderer_->vk_framebuffer(framebuffer_index).attachments()[1];
+        const auto depth_extent = renderer_->vk_framebuffer(framebuffer_index).extent();
+
+        // Глубина кадра доступна для чтения, прошлое содержимое пирамиды не нужно
+        const std::array image_barriers{
+            vk::ImageMemoryBarrier()
+            .setSrcAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+            .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
+            .setOldLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal)
+            .setNewLayout(vk::ImageLayout::eDepthStencilReadOnlyOptimal)
+            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setImage(depth->image())
+            .setSubresourceRange({vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil, 0, 1, 0, 1}),
+            vk::ImageMemoryBarrier()
+            .setSrcAccessMask(vk::AccessFlagBits::eShaderRead)
+            .setDstAccessMask(vk::AccessFlagBits::eShaderWrite)
+            .setOldLayout(vk::ImageLayout::eUndefined)
+            .setNewLayout(vk::ImageLayout::eGeneral)
+            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setImage(vk_pyramid_->image())
+            .setSubresourceRange({vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, 1})
+        };
+
+        cmd_buffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eLateFragmentTests | vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eComputeShader,
+            {},
+            {},
+            {},
+            image_barriers);
+
+        // Каждый уровень - максимум глубины покрываемой области предыдущего уровня (нулевой - по вложению глубины)
+        cmd_buffer.bindPipeline(vk::PipelineBindPoint::eCompute, vk_pyramid_pipeline_.get());
+        for (size_t level = 0; level < pyramid_extents_.size(); ++level){
+            const auto& src = level == 0 ? depth_extent : pyramid_extents_[level - 1];
+            const auto& dst = pyramid_extents_[level];
+            const auto& dset = level == 0 ? vk_dsets_pyramid_depth_[framebuffer_index] : vk_dsets_pyramid_levels_[level - 1];
+
+            PyramidPushConstants push{};
+            push.src_width = src.width;
+            push.src_height = src.height;
+            push.dst_width = dst.width;
+            push.dst_height = dst.height;
+
+            cmd_buffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pl, 1, {dset.get()}, {});
+            cmd_buffer.pushConstants(pl, vk::ShaderStageFlagBits::eCompute, 0, sizeof(push), &push);
+            cmd_buffer.dispatch(
+                (dst.width + kPyramidGroupSize - 1) / kPyramidGroupSize,
+                (dst.height + kPyramidGroupSize - 1) / kPyramidGroupSize,
+                1);
+
+            // Уровень читается при построении следующего уровня (последний - при отсечении следующего кадра)
+            const auto barrier = vk::MemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+            cmd_buffer.pipelineBarrier(
+                vk::PipelineStageFlagBits::eComputeShader,
+                vk::PipelineStageFlagBits::eComputeShader,
+                {},
+                {barrier},
+                {},
+                {});
+        }
+
+        // Следующий кадр проверяет перекрытие относительно камеры этого кадра
+        pyramid_view_proj_ = view_proj_;
+        pyramid_valid_ = true;
+    }
+
+    void GpuCuller::init_candidates(){
+        const auto& vd = renderer_->vk_device();
+        const auto frames = frames_.size();
+
+        // Кандидаты на отсечение (заполняются при построении пакетов непрямой отрисовки)
+        vk_candidates_ = std::make_unique<vk::utils::Buffer>(
+            vd,
+            sizeof(Candidate) * capacity_ * frames,
+            vk::BufferUsageFlagBits::eStorageBuffer,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+        // Кандидаты на отсечение кластеров (объекты пакетов, кластеры которых отсекаются по отдельности)
+        vk_meshlet_candidates_ = std::make_unique<vk::utils::Buffer>(
+            vd,
+            sizeof(Candidate) * capacity_ * frames,
+            vk::BufferUsageFlagBits::eStorageBuffer,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+        vk_candidates_->map_unsafe();
+        vk_meshlet_candidates_->map_unsafe();
+    }
+
+    void GpuCuller::init_pyramid(){
+        const auto& vd = renderer_->vk_device();
+        const auto extent = renderer_->get_rendering_resolution();
+
+        // Размеры нулевого уровня - ближайшая меньшая степень двойки (каждый следующий уровень ровно вдвое меньше)
+        const auto floor_pow2 = [](const uint32_t v){
+            uint32_t r = 1;
+            while (r * 2 <= v) r *= 2;
+            return r;
+        };
+
+        const vk::Extent2D base(floor_pow2(extent.width), floor_pow2(extent.height));
+        vk_pyramid_ = std::make_unique<vk::utils::Image>(
+            vd,
+            vk::utils::Image::Type::e2D,
+            vk::Format::eR32Sfloat,
+            vk::Extent3D(base.width, base.height, 1),
+            vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled,
+            vk::ImageTiling::eOptimal,
+            vk::ImageAspectFlagBits::eColor,
+            vk::MemoryPropertyFlagBits::eDeviceLocal,
+            vk::ImageLayout::eUndefined,
+            vk::SampleCountFlagBits::e1,
+            0u);
+
+        // Представления отдельных уровней (запись уровня и чтение предыдущего)
+        pyramid_extents_.clear();
+        for (uint32_t level = 0; level < vk_pyramid_->mip_levels(); ++level){
+            pyramid_extents_.emplace_back(std::max(base.width >> level, 1u), std::max(base.height >> level, 1u));
+            vk_pyramid_levels_.emplace_back(vd->logical_device().createImageViewUnique(
+                vk::ImageViewCreateInfo()
+                .setImage(vk_pyramid_->image())
+                .setViewType(vk::ImageViewType::e2D)
+                .setFormat(vk::Format::eR32Sfloat)
+                .setSubresourceRange({vk::ImageAspectFlagBits::eColor, level, 1, 0, 1})));
+        }
+
+        // Представления глубины вложений (вложение глубины-трафарета читается только по аспекту глубины)
+        for (size_t i = 0; i < renderer_->vk_framebuffer_count(); ++i){
+            const auto& depth = renderer_->vk_framebuffer(i).attachments()[1];
+            vk_depth_views_.emplace_back(vd->logical_device().createImageViewUnique(
+                vk::ImageViewCreateInfo()
+                .setImage(depth->image())
+                .setViewType(vk::ImageViewType::e2D)
+                .setFormat(renderer_->config().depth_stencil_format)
+                .setSubresourceRange({vk::ImageAspectFlagBits::eDepth, 0, 1, 0, 1})));
+        }
+    }
+
+    void GpuCuller::init_descriptors(){
+        const auto& vd = renderer_->vk_device();
+        const auto& ul = renderer_->vk_uniform_layout(UniformLayoutType::eGpuCulling);
+        const auto& sampler = renderer_->vk_texture_sampler(TextureSamplerType::eNearestClamp);
+        const auto frames = frames_.size();
+
+        // Наборы отсечения не зависят от кадровых буферов, кроме пирамиды (выделяются один раз)
+        if (vk_dsets_cull_.empty()){
+            vk_dsets_cull_ = ul.allocate_sets(0, frames);
+            vk_dsets_meshlets_ = ul.allocate_sets(2, MAX_MESHLET_BATCHES * frames);
+        }
+        vk_dsets_pyramid_depth_ = ul.allocate_sets(1, vk_depth_views_.size());
+        if (vk_pyramid_levels_.size() > 1){
+            vk_dsets_pyramid_levels_ = ul.allocate_sets(1, vk_pyramid_levels_.size() - 1);
+        }
+
+        // ВНИМАНИЕ! Зарезервировать память перед использованием (записи ссылаются на элементы массивов)
+        std::vector<vk::WriteDescriptorSet> writes;
+        std::vector<vk::DescriptorImageInfo> image_infos;
+        writes.reserve((vk_depth_views_.size() + vk_pyramid_levels_.size()) * 2);
+        image_infos.reserve((vk_depth_views_.size() + vk_pyramid_levels_.size()) * 2);
+
+        const auto write_image = [&](const vk::DescriptorSet& set, const uint32_t binding, const vk::DescriptorType type,
+                                     const vk::ImageView& view, const vk::ImageLayout layout){
+            image_infos.emplace_back(vk::DescriptorImageInfo()
+                .setSampler(type == vk::DescriptorType::eCombinedImageSampler ? sampler : vk::Sampler())
+                .setImageView(view)
+                .setImageLayout(layout));
+            writes.emplace_back(vk::WriteDescriptorSet()
+                .setDstSet(set)
+                .setDstBinding(binding)
+                .setDescriptorType(type)
+                .setDescriptorCount(1)
+                .setPImageInfo(&image_infos.back()));
+        };
+
+        // set = 1: нулевой уровень пирамиды строится по глубине кадрового буфера
+        for (size_t i = 0; i < vk_depth_views_.size(); ++i){
+            const auto& set = vk_dsets_pyramid_depth_[i].get();
+            write_image(set, 0, vk::DescriptorType::eCombinedImageSampler, vk_depth_views_[i].get(), vk::ImageLayout::eDepthStencilReadOnlyOptimal);
+            write_image(set, 1, vk::DescriptorType::eStorageImage, vk_pyramid_levels_[0].get(), vk::ImageLayout::eGeneral);
+        }
+
+        // set = 1: остальные уровни строятся по предыдущему уровню
+        for (size_t level = 1; level < vk_pyramid_levels_.size(); ++level){
+            const auto& set = vk_dsets_pyramid_levels_[level - 1].get();
+            write_image(set, 0, vk::DescriptorType::eCombinedImageSampler, vk_pyramid_levels_[level - 1].get(), vk::ImageLayout::eGeneral);
+            write_image(set, 1, vk::DescriptorType::eStorageImage, vk_pyramid_levels_[level].get(), vk::ImageLayout::eGeneral);
+        }
+
+        vd->logical_device().updateDescriptorSets(writes, {});
+
+        // set = 0: параметры кадра, объекты, кандидаты, команды, экземпляры, пирамида глубины, кандидаты кластеров и счетчики
+        for (size_t i = 0; i < frames; ++i){
+            update_frame_descriptors(i);
+        }
+    }
+
+    void GpuCuller::update_frame_descriptors(const size_t frame_index){
+        assert(frame_index < vk_dsets_cull_.size());
+        const auto& vd = renderer_->vk_device();
+        const auto& sampler = renderer_->vk_texture_sampler(TextureSamplerType::eNearestClamp);
+        const auto ubo_alignment = vd->physical_device().getProperties().limits.minUniformBufferOffsetAlignment;
+        const auto& transforms = renderer_->vk_objects_transforms();
+        const auto& bounds = renderer_->vk_objects_bounds();
+
+        // ВНИМАНИЕ! Зарезервировать память перед использованием (записи ссылаются на элементы массивов)
+        std::vector<vk::WriteDescriptorSet> writes;
+        std::vector<vk::DescriptorBufferInfo> buffer_infos;
+        writes.reserve(9);
+        buffer_infos.reserve(8);
+
+        const auto& set = vk_dsets_cull_[frame_index].get();
+        const auto write_buffer = [&](const uint32_t binding, const vk::DescriptorType type,
+                                      const vk::Buffer& buffer, const vk::DeviceSize offset, const vk::DeviceSize range){
+            buffer_infos.emplace_back(vk::DescriptorBufferInfo()
+                .setBuffer(buffer)
+                .setOffset(offset)
+                .setRange(range));
+            writes.emplace_back(vk::WriteDescriptorSet()
+                .setDstSet(set)
+                .setDstBinding(binding)
+                .setDescriptorType(type)
+                .setDescriptorCount(1)
+                .setPBufferInfo(&buffer_infos.back()));
+        };
+
+        const auto pyramid_info = vk::DescriptorImageInfo()
+            .setSampler(sampler)
+            .setImageView(vk_pyramid_->image_view())
+            .setImageLayout(vk::ImageLayout::eGeneral);
+
+        write_buffer(0, vk::DescriptorType::eUniformBuffer, vk_ubo_culling_->vk_buffer(),
+            size_align(sizeof(GpuCullingUniforms), ubo_alignment) * frame_index, sizeof(GpuCullingUniforms));
+        write_buffer(1, vk::DescriptorType::eStorageBuffer, transforms.vk_buffer(), transforms.region_offset(frame_index), transforms.region_size());
+        write_buffer(2, vk::DescriptorType::eStorageBuffer, bounds.vk_buffer(), bounds.region_offset(frame_index), bounds.region_size());
+        write_buffer(3, vk::DescriptorType::eStorageBuffer, vk_candidates_->vk_buffer(), 0, VK_WHOLE_SIZE);
+        write_buffer(4, vk::DescriptorType::eStorageBuffer, renderer_->vk_indirect_commands().vk_buffer(), 0, VK_WHOLE_SIZE);
+        write_buffer(5, vk::DescriptorType::eStorageBuffer, renderer_->vk_instance_indices().vk_buffer(), 0, VK_WHOLE_SIZE);
+        writes.emplace_back(vk::WriteDescriptorSet()
+            .setDstSet(set)
+            .setDstBinding(6)
+            .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+            .setDescriptorCount(1)
+            .setPImageInfo(&pyramid_info));
+        write_buffer(7, vk::DescriptorType::eStorageBuffer, vk_meshlet_candidates_->vk_buffer(), 0, VK_WHOLE_SIZE);
+        write_buffer(8, vk::DescriptorType::eStorageBuffer, renderer_->vk_indirect_counts().vk_buffer(), 0, VK_WHOLE_SIZE);
+
+        vd->logical_device().updateDescriptorSets(writes, {});
+    }
+}
@@ -0,0 +1,173 @@
+#include "pch.h"
+#include <nasral/rendering/gpu_profiler.h>
+#include <nasral/rendering/renderer.h>
+
+namespace nasral::rendering
+{
+    GpuProfiler::GpuProfiler(const Renderer* renderer, const uint32_t max_scopes)
+        : renderer_(renderer)
+        , max_scopes_(std::max(max_scopes, 1u))
+        , timestamp_period_(0.0)
+        , timestamp_mask_(0)
+        , frame_index_(0)
+        , timings_frame_(0)
+    {
+        const auto& vd = renderer_->vk_device();
+        const auto frames = renderer_->config().max_frames_in_flight;
+        frames_.resize(frames);
+
+        // Временные метки поддерживаются не всеми семействами очередей (0 значащих бит - замеры не выполняются)
+        const auto& group = vd->queue_group(to<size_t>(Renderer::CommandGroup::eGraphicsAndPresent));
+        const auto families = vd->physical_device().getQueueFamilyProperties();
+        const auto valid_bits = families[group.family_index.value()].timestampValidBits;
+        if (valid_bits == 0) return;
+
+        timestamp_period_ = static_cast<double>(vd->physical_device().getProperties().limits.timestampPeriod);
+        timestamp_mask_ = valid_bits >= 64 ? std::numeric_limits<uint64_t>::max() : (uint64_t{1} << valid_bits) - 1;
+        results_.resize(max_scopes_ * 2);
+
+        for (uint32_t i = 0; i < frames; ++i){
+            vk_query_pools_.push_back(vd->logical_device().createQueryPoolUnique(
+                vk::QueryPoolCreateInfo()
+                .setQueryType(vk::QueryType::eTimestamp)
+                .setQueryCount(max_scopes_ * 2)));
+        }
+    }
+
+    void GpuProfiler::read_back(const size_t frame_index){
+        assert(frame_index < frames_.size());
+        auto& frame = frames_[frame_index];
+        if (!is_supported() || !frame.submitted || frame.scopes.empty()) return;
+        frame.submitted = false;
+
+        // Кадр с этим индексом завершен - результаты доступны без ожидания (иначе кадр пропускается)
+        const auto count = to<uint32_t>(frame.scopes.size() * 2);
+        const auto result = renderer_->vk_device()->logical_device().getQueryPoolResults(
+            vk_query_pools_[frame_index].get(),
+            0,
+            count,
+            sizeof(uint64_t) * count,
+            results_.data(),
+            sizeof(uint64_t),
+            vk::QueryResultFlagBits::e64);
+        if (result != vk::Result::eSuccess) return;
+
+        timings_.clear();
+        timings_frame_ = frame.frame;
+        for (size_t i = 0; i < frame.scopes.size(); ++i){
+            const auto& scope = frame.scopes[i];
+            const uint64_t ticks = (results_[i * 2 + 1] - results_[i * 2]) & timestamp_mask_;
+            const double ms = static_cast<double>(ticks) * timestamp_period_ / 1000000.0;
+            timings_.push_back({scope.name, scope.depth, ms});
+
+            auto [it, inserted] = summary_indices_.try_emplace(scope.name, summaries_.size());
+            if (inserted){
+                summaries_.push_back({scope.name, scope.depth});
+            }
+            auto& summary = summaries_[it->second];
+            summary.count++;
+            summary.total_ms += ms;
+            summary.min_ms = std::min(summary.min_ms, ms);
+            summary.max_ms = std::max(summary.max_ms, ms);
+        }
+    }
+
+    void GpuProfiler::reset_frames(){
+        // Области кадров, которые больше не будут завершены (результаты их запросов не читаются)
+        for (auto& frame : frames_){
+            frame = {};
+        }
+        cmd_buffer_ = VK_NULL_HANDLE;
+    }
+
+    void GpuProfiler::cmd_begin_frame(const vk::CommandBuffer& cmd_buffer, const size_t frame_index){
+        assert(frame_index < frames_.size());
+        if (!is_supported()) return;
+
+        auto& frame = frames_[frame_index];
+        frame.scopes.clear();
+        frame.stack.clear();
+        frame.frame = renderer_->current_frame();
+        frame.submitted = false;
+
+        // Запросы сбрасываются вне прохода рендеринга, в начале первого исполняемого буфера команд кадра
+        cmd_buffer_ = cmd_buffer;
+        frame_index_ = frame_index;
+        cmd_buffer_.resetQueryPool(vk_query_pools_[frame_index].get(), 0, max_scopes_ * 2);
+    }
+
+    void GpuProfiler::set_cmd_buffer(const vk::CommandBuffer& cmd_buffer){
+        if (!is_supported() || !cmd_buffer_) return;
+
+        // Области кадра могут начинаться и завершаться в разных буферах одной отправки (в порядке исполнения буферов)
+        cmd_buffer_ = cmd_buffer;
+    }
+
+    void GpuProfiler::cmd_end_frame(){
+        if (!is_supported() || !cmd_buffer_) return;
+
+        // Незакрытые области завершаются вместе с кадром
+        while (!frames_[frame_index_].stack.empty()){
+            cmd_end_scope();
+        }
+
+        frames_[frame_index_].submitted = true;
+        cmd_buffer_ = VK_NULL_HANDLE;
+    }
+
+    void GpuProfiler::cmd_begin_scope(const std::string& name){
+        if (!is_supported() || !cmd_buffer_) return;
+
+        auto& frame = frames_[frame_index_];
+        if (frame.scopes.size() >= max_scopes_){
+            frame.stack.emplace_back(std::nullopt);
+            return;
+        }
+
+        const auto index = to<uint32_t>(frame.scopes.size());
+        frame.scopes.push_back({name, to<uint32_t>(frame.stack.size())});
+        frame.stack.emplace_back(index);
+        cmd_buffer_.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, vk_query_pools_[frame_index_].get(), index * 2);
+    }
+
+    void GpuProfiler::cmd_end_scope(){
+        if (!is_supported() || !cmd_buffer_) return;
+
+        auto& frame = frames_[frame_index_];
+        if (frame.stack.empty()) return;
+
+        const auto index = frame.stack.back();
+        frame.stack.pop_back();
+        if (index.has_value()){
+            cmd_buffer_.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, vk_query_pools_[frame_index_].get(), index.value() * 2 + 1);
+        }
+    }
+
+    void GpuProfiler::save(const std::string& path) const{
+        const std::filesystem::path fp(path);
+        if (fp.has_parent_path()){
+            std::filesystem::create_directories(fp.parent_path());
+        }
+
+        std::ofstream file(fp, std::ios::trunc);
+        if (!file.is_open()){
+            throw std::runtime_error("Can't open file " + fp.string());
+        }
+
+        // Итоги по областям (вложенные области с отступом) и области последнего прочитанного кадра
+        file.setf(std::ios::fixed);
+        file.precision(3);
+        file << "scope\tframes\tavg ms\tmin ms\tmax ms\n";
+        for (const auto& s : summaries_){
+            file << std::string(s.depth * 2, ' ') << s.name << "\t" << s.count << "\t"
+                 << s.total_ms / static_cast<double>(std::max<uint64_t>(s.count, 1)) << "\t"
+                 << s.min_ms << "\t" << s.max_ms << "\n";
+        }
+
+        file << "\nframe " << timings_frame_ << "\n";
+        file << "scope\tms\n";
+        for (const auto& t : timings_){
+            file << std::string(t.depth * 2, ' ') << t.name << "\t" << t.time_ms << "\n";
+        }
+    }
+}
@@ -0,0 +1,180 @@
+#include "pch.h"
+#include <nasral/rendering/light_clusterer.h>
+
+namespace nasral::rendering
+{
+    LightClusterer::LightClusterer(const size_t capacity)
+        : spheres_(capacity, glm::vec4(0.0f))
+        , ranges_(kClusterCount, glm::uvec2(0))
+        , cursors_(kClusterCount, 0)
+    {
+        indices_.reserve(MAX_LIGHT_CLUSTER_INDICES);
+        light_ranges_.reserve(capacity);
+    }
+
+    void LightClusterer::reserve(const size_t capacity){
+        if (capacity <= spheres_.size()) return;
+        spheres_.resize(capacity, glm::vec4(0.0f));
+        light_ranges_.reserve(capacity);
+    }
+
+    void LightClusterer::set_light(const uint32_t index, const glm::vec4& sphere){
+        assert(index < spheres_.size());
+        spheres_[index] = glm::vec4(glm::vec3(sphere), std::max(sphere.w, 0.0f));
+    }
+
+    void LightClusterer::build(
+        const std::vector<uint32_t>& active_ids,
+        const glm::mat4& view,
+        const glm::mat4& projection,
+        const glm::uvec2& extent,
+        const bool opengl_style)
+    {
+        const auto started = std::chrono::steady_clock::now();
+
+        stats_ = {};
+        header_ = {};
+        light_ranges_.clear();
+        indices_.clear();
+        std::fill(ranges_.begin(), ranges_.end(), glm::uvec2(0));
+
+        // Ближняя и дальняя плоскости перспективной проекции (глубина [-1, 1] в стиле OpenGL, иначе [0, 1])
+        const float p22 = projection[2][2];
+        const float p32 = projection[3][2];
+        const float near = opengl_style ? p32 / (p22 - 1.0f) : p32 / p22;
+        const float far = p32 / (p22 + 1.0f);
+
+        // Без перспективы кластеры не строятся (фрагменты обходят все активные источники)
+        if (projection[2][3] == 0.0f || !(near > 0.0f) || !(far > near) || extent.x == 0 || extent.y == 0){
+            stats_.build_time_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - started).count();
+            return;
+        }
+
+        // Слои равномерны по логарифму глубины (кластеры вдали не вытягиваются вдоль оси взгляда)
+        const float slice_scale = static_cast<float>(LIGHT_CLUSTERS_Z) / std::log(far / near);
+        const float slice_bias = -slice_scale * std::log(near);
+        const glm::uvec2 tile(
+            (extent.x + LIGHT_CLUSTERS_X - 1) / LIGHT_CLUSTERS_X,
+            (extent.y + LIGHT_CLUSTERS_Y - 1) / LIGHT_CLUSTERS_Y);
+
+        header_.grid = glm::uvec4(tile, 1u, 0u);
+        header_.slices = glm::vec4(slice_scale, slice_bias, near, far);
+
+        const auto slice = [&](const float depth){
+            const float s = std::floor(std::log(std::max(depth, near)) * slice_scale + slice_bias);
+            return static_cast<uint32_t>(std::clamp(s, 0.0f, static_cast<float>(LIGHT_CLUSTERS_Z - 1)));
+        };
+
+        // Ячейка экрана по координате NDC (ось Y кадрового буфера направлена вниз, в стиле OpenGL - вверх)
+        const float y_sign = opengl_style ? -1.0f : 1.0f;
+        const auto cell = [](const float ndc, const uint32_t size, const uint32_t tile_size, const uint32_t count){
+            const float px = (ndc * 0.5f + 0.5f) * static_cast<float>(size);
+            const float c = std::floor(px / static_cast<float>(tile_size));
+            return static_cast<uint32_t>(std::clamp(c, 0.0f, static_cast<float>(count - 1)));
+        };
+
+        // Диапазоны кластеров источников (по ограничивающим сферам в пространстве вида)
+        for (const auto id : active_ids){
+            if (id >= spheres_.size()) continue;
+            const auto& sphere = spheres_[id];
+
+            LightRange range{};
+            range.index = id;
+            range.max = glm::uvec3(LIGHT_CLUSTERS_X - 1, LIGHT_CLUSTERS_Y - 1, LIGHT_CLUSTERS_Z - 1);
+
+            // Источник без ограничения радиуса освещает все кластеры
+            if (sphere.w > 0.0f){
+                const glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(sphere), 1.0f));
+                const float depth = -center.z;
+                const float radius = sphere.w;
+                if (depth + radius < near || depth - radius > far) continue;
+
+                range.min.z = slice(depth - radius);
+                range.max.z = slice(depth + radius);
+
+                // Сфера целиком перед ближней плоскостью - прямоугольник экрана по проекциям углов описанного куба
+                if (depth - radius > near){
+                    glm::vec2 ndc_min(std::numeric_limits<float>::max());
+                    glm::vec2 ndc_max(std::numeric_limits<float>::lowest());
+                    for (int i = 0; i < 8; ++i){
+                        const glm::vec3 corner = center + radius * glm::vec3(
+                            (i & 1) != 0 ? 1.0f : -1.0f,
+                            (i & 2) != 0 ? 1.0f : -1.0f,
+                            (i & 4) != 0 ? 1.0f : -1.0f);
+                        const glm::vec4 clip = projection * glm::vec4(corner, 1.0f);
+                        const glm::vec2 ndc = glm::vec2(clip.x, clip.y * y_sign) / clip.w;
+                        ndc_min = glm::min(ndc_min, ndc);
+                        ndc_max = glm::max(ndc_max, ndc);
+                    }
+
+                    // Вне экрана
+                    if (ndc_max.x < -1.0f || ndc_min.x > 1.0f || ndc_max.y < -1.0f || ndc_min.y > 1.0f) continue;
+
+                    range.min.x = cell(ndc_min.x, extent.x, tile.x, LIGHT_CLUSTERS_X);
+                    range.max.x = cell(ndc_max.x, extent.x, tile.x, LIGHT_CLUSTERS_X);
+                    range.min.y = cell(ndc_min.y, extent.y, tile.y, LIGHT_CLUSTERS_Y);
+                    range.max.y = cell(ndc_max.y, extent.y, tile.y, LIGHT_CLUSTERS_Y);
+                }
+            }
+
+            light_ranges_.push_back(range);
+        }
+
+        // Обход кластеров диапазона (индекс кластера - (слой * высота + строка) * ширина + столбец)
+        const auto for_each_cluster = [](const LightRange& range, const auto& fn){
+            for (uint32_t z = range.min.z; z <= range.max.z; ++z){
+                for (uint32_t y = range.min.y; y <= range.max.y; ++y){
+                    const uint32_t row = (z * LIGHT_CLUSTERS_Y + y) * LIGHT_CLUSTERS_X;
+                    for (uint32_t x = range.min.x; x <= range.max.x; ++x){
+                        fn(row + x);
+                    }
+                }
+            }
+        };
+
+        // Кол-во источников каждого кластера
+        for (const auto& range : light_ranges_){
+            for_each_cluster(range, [&](const uint32_t cluster){ ranges_[cluster].y++; });
+        }
+
+        // Отрезки кластеров в общем списке (при переполнении списка последние кластеры усекаются)
+        uint32_t offset = 0;
+        for (auto& range : ranges_){
+            const uint32_t count = std::min(range.y, MAX_LIGHT_CLUSTER_INDICES - offset);
+            stats_.overflow = stats_.overflow || count < range.y;
+            stats_.max_per_cluster = std::max(stats_.max_per_cluster, count);
+            range = glm::uvec2(offset, count);
+            offset += count;
+        }
+
+        // Индексы источников (в порядке активных источников внутри каждого кластера)
+        indices_.resize(offset);
+        std::fill(cursors_.begin(), cursors_.end(), 0);
+        for (const auto& range : light_ranges_){
+            for_each_cluster(range, [&](const uint32_t cluster){
+                auto& cursor = cursors_[cluster];
+                if (cursor < ranges_[cluster].y){
+                    indices_[ranges_[cluster].x + cursor++] = range.index;
+                }
+            });
+        }
+
+        stats_.lights = to<uint32_t>(light_ranges_.size());
+        stats_.assignments = offset;
+        stats_.build_time_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - started).count();
+    }
+
+    void LightClusterer::write(void* dst) const{
+        assert(dst != nullptr);
+
+        // Заголовок, отрезки всех кластеров и занятая часть списка индексов
+        auto* bytes = static_cast<uint8_t*>(dst);
+        std::memcpy(bytes, &header_, sizeof(LightClusterHeader));
+        bytes += sizeof(LightClusterHeader);
+        std::memcpy(bytes, ranges_.data(), sizeof(glm::uvec2) * ranges_.size());
+        bytes += sizeof(glm::uvec2) * kClusterCount;
+        std::memcpy(bytes, indices_.data(), sizeof(uint32_t) * indices_.size());
+    }
+}
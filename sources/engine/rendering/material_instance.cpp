@@ -51,6 +51,7 @@ namespace nasral::rendering
         other.material_ref_.type(),
         std::string(other.material_ref_.path().data()))
     , material_handles_({})
+    , vertex_formats_(other.vertex_formats_)
     , texture_samplers_({})
     {
         for (size_t i = 0; i < static_cast<size_t>(TextureType::TOTAL); ++i) {
@@ -82,6 +83,8 @@ namespace nasral::rendering
             std::string(other.material_ref_.path().data()));
 
         material_handles_ = {};
+        vertex_formats_ = other.vertex_formats_;
+        variants_pending_ = 0;
 
         for (size_t i = 0; i < static_cast<size_t>(TextureType::TOTAL); ++i) {
             texture_refs_[i] = other.texture_refs_[i];
@@ -99,6 +102,7 @@ namespace nasral::rendering
 
     void MaterialInstance::set_material(const MaterialType type, const std::string& path, const bool request){
         material_handles_ = {};
+        variants_pending_ = 0;
         material_ref_.release();
         mark_changed(eShadersChanged);
 
@@ -116,6 +120,9 @@ namespace nasral::rendering
         ref.release();
         mark_changed(eTextureChanged);
 
+        // Набор заданных текстур изменился - конвейеры материала (для всех используемых форматов вершин) выбираются заново
+        variants_pending_ = material_handles_[to<uint32_t>(VertexFormat::eFull)] ? vertex_formats_ : 0;
+
         if (path.empty()){
             ref.set_path(resources::builtin_res_path(builtin_tex_for_type(type)));
         }else{
@@ -155,6 +162,7 @@ namespace nasral::rendering
 
     void MaterialInstance::release_resources(){
         material_handles_ = {};
+        variants_pending_ = 0;
         material_ref_.release();
 
         for (size_t i = 0; i < static_cast<size_t>(TextureType::TOTAL); ++i){
@@ -165,8 +173,54 @@ namespace nasral::rendering
         settings_ = std::nullopt;
     }
 
-    const Handles::Material& MaterialInstance::mat_render_handles() const{
-        return material_handles_;
+    Handles::Material MaterialInstance::mat_render_handles(const VertexFormat format) const{
+        // Пока конвейер материала создается - материал-заглушка менеджера ресурсов (если задан)
+        const auto& handles = material_handles_[to<uint32_t>(format)];
+        if (!handles && material_ref_.manager().get() != nullptr){
+            return material_ref_.manager()->fallback_material(format);
+        }
+        return handles;
+    }
+
+    void MaterialInstance::update_render_handles(){
+        if (variants_pending_ == 0) return;
+
+        // Варианты конвейера по заданным текстурам и форматам вершин
+        const auto* material = dynamic_cast<const resources::Material*>(material_ref_.resource());
+        if (material == nullptr) return;
+
+        const auto features = texture_features();
+        for (uint32_t i = 0; i < to<uint32_t>(VertexFormat::TOTAL); ++i){
+            if ((variants_pending_ & (1u << i)) == 0) continue;
+
+            // До создания варианта полного формата используется основной конвейер материала,
+            // для упакованных форматов - прежний вариант (либо материал-заглушка)
+            const auto format = static_cast<VertexFormat>(i);
+            const auto variant = material->variant_handles(features, format);
+            if (variant.has_value()){
+                variants_pending_ &= ~(1u << i);
+            }
+
+            const auto handles = format == VertexFormat::eFull
+                ? variant.value_or(material->render_handles())
+                : variant.value_or(material_handles_[i]);
+
+            if (handles.pipeline != material_handles_[i].pipeline){
+                material_handles_[i] = handles;
+                mark_changed(eShadersChanged);
+            }
+        }
+    }
+
+    void MaterialInstance::use_vertex_format(const VertexFormat format){
+        const uint32_t bit = 1u << to<uint32_t>(format);
+        if (vertex_formats_ & bit) return;
+
+        // Конвейер для формата выбирается при обновлении (после загрузки материала)
+        vertex_formats_ |= bit;
+        if (material_handles_[to<uint32_t>(VertexFormat::eFull)]){
+            variants_pending_ |= bit;
+        }
     }
 
     const Handles::Texture& MaterialInstance::tex_render_handles(const TextureType type) const{
@@ -177,6 +231,18 @@ namespace nasral::rendering
         return texture_samplers_[static_cast<uint32_t>(type)];
     }
 
+    uint32_t MaterialInstance::texture_features() const{
+        // Текстура задана, если вместо неё не используется встроенная текстура по умолчанию
+        uint32_t features = 0;
+        for (size_t i = 0; i < static_cast<size_t>(TextureType::TOTAL); ++i){
+            const auto builtin = resources::builtin_res_path(builtin_tex_for_type(static_cast<TextureType>(i)));
+            if (texture_refs_[i].path().view() != builtin){
+                features |= 1u << i;
+            }
+        }
+        return features;
+    }
+
     const std::optional<MaterialUniforms>& MaterialInstance::settings() const{
         return settings_;
     }
@@ -205,7 +271,10 @@ namespace nasral::rendering
             const auto* material = dynamic_cast<resources::Material*>(resource);
             if (material && resource->status() == resources::Status::eLoaded){
                 assert(material->material_type() == material_type_);
-                material_handles_ = material->render_handles();
+                // Основной конвейер - для полного формата вершин, остальные используемые форматы требуют вариантов
+                const uint32_t full = 1u << to<uint32_t>(VertexFormat::eFull);
+                material_handles_[to<uint32_t>(VertexFormat::eFull)] = material->render_handles();
+                variants_pending_ = vertex_formats_ & (material->has_texture_features() ? ~0u : ~full);
                 mark_changed(eShadersChanged);
             }
         });
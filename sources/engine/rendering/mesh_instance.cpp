@@ -14,6 +14,7 @@ namespace nasral::rendering
             const auto* mesh = dynamic_cast<resources::Mesh*>(resource);
             if (mesh && resource->status() == resources::Status::eLoaded){
                 mesh_handles_ = mesh->render_handles();
+                mesh_bounds_ = mesh->bounds();
                 mark_changed(eMeshChanged);
             }
         });
@@ -25,6 +26,7 @@ namespace nasral::rendering
         other.mesh_ref_.type(),
         std::string(other.mesh_ref_.path().data()))
     , mesh_handles_({})
+    , mesh_bounds_({})
     {
         other.unbind_callbacks();
         other.release_resources();
@@ -44,6 +46,7 @@ namespace nasral::rendering
             std::string(other.mesh_ref_.path().data()));
 
         mesh_handles_ = {};
+        mesh_bounds_ = {};
 
         other.unbind_callbacks();
         other.release_resources();
@@ -53,6 +56,7 @@ namespace nasral::rendering
 
     void MeshInstance::set_mesh(const std::string& path, const bool request){
         mesh_handles_ = {};
+        mesh_bounds_ = {};
         mesh_ref_.release();
         mark_changed(eMeshChanged);
 
@@ -75,11 +79,16 @@ namespace nasral::rendering
         return mesh_handles_;
     }
 
+    const Bounds& MeshInstance::mesh_bounds() const{
+        return mesh_bounds_;
+    }
+
     void MeshInstance::bind_callbacks(){
         mesh_ref_.set_callback([this](resources::IResource* resource){
             const auto* mesh = dynamic_cast<resources::Mesh*>(resource);
             if (mesh && resource->status() == resources::Status::eLoaded){
                 mesh_handles_ = mesh->render_handles();
+                mesh_bounds_ = mesh->bounds();
                 mark_changed(eMeshChanged);
             }
         });
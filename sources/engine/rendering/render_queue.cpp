@@ -0,0 +1,127 @@
+#include "pch.h"
+#include <nasral/rendering/render_queue.h>
+
+namespace nasral::rendering
+{
+    namespace
+    {
+        // Младшие разряды идентификатора геометрии - уровень детализации (пакеты одного уровня геометрии идут подряд)
+        constexpr uint32_t kLodBits = 2;
+        static_assert(MAX_MESH_LODS <= (1u << kLodBits), "LOD index must fit into mesh key bits");
+
+        // Кол-во различимых идентификаторов конвейеров и геометрии в ключе
+        constexpr size_t kMaxPipelineIds = std::numeric_limits<uint16_t>::max();
+        constexpr size_t kMaxMeshIds = std::numeric_limits<uint16_t>::max() >> kLodBits;
+    }
+
+    void RenderQueue::push(
+        const Handles::Material& material,
+        const uint32_t mat_index,
+        const Handles::Mesh& mesh,
+        const uint32_t obj_index,
+        const float depth)
+    {
+        keys_.push_back(make_key(pipeline_id(material.pipeline), mat_index, mesh_id(mesh.vertex_buffer, mesh.lod), depth));
+        packets_.push_back({material, mesh, mat_index, obj_index});
+    }
+
+    void RenderQueue::sort(){
+        const auto count = to<uint32_t>(packets_.size());
+        order_.resize(count);
+        order_swap_.resize(count);
+        keys_sorted_.assign(keys_.begin(), keys_.end());
+        keys_swap_.resize(count);
+
+        for (uint32_t i = 0; i < count; ++i){
+            order_[i] = i;
+        }
+
+        if (count < 2) return;
+
+        // Разряды, которые отличаются хотя бы у одного ключа (остальные проходы можно пропустить)
+        uint64_t varying = 0;
+        for (const auto key : keys_sorted_){
+            varying |= key ^ keys_sorted_[0];
+        }
+
+        // Поразрядная сортировка (LSD, 8 проходов по 8 бит), устойчивая - порядок добавления сохраняется
+        for (uint32_t shift = 0; shift < 64; shift += 8)
+        {
+            if (((varying >> shift) & 0xFF) == 0) continue;
+
+            std::array<uint32_t, 256> offsets{};
+            for (const auto key : keys_sorted_){
+                offsets[(key >> shift) & 0xFF]++;
+            }
+
+            uint32_t sum = 0;
+            for (auto& offset : offsets){
+                const auto bucket = offset;
+                offset = sum;
+                sum += bucket;
+            }
+
+            for (uint32_t i = 0; i < count; ++i){
+                const auto dst = offsets[(keys_sorted_[i] >> shift) & 0xFF]++;
+                keys_swap_[dst] = keys_sorted_[i];
+                order_swap_[dst] = order_[i];
+            }
+
+            std::swap(keys_sorted_, keys_swap_);
+            std::swap(order_, order_swap_);
+        }
+    }
+
+    void RenderQueue::clear(){
+        packets_.clear();
+        keys_.clear();
+        order_.clear();
+
+        // Идентификаторы сохраняются между кадрами, при переполнении назначаются заново
+        // (только между кадрами - ключи добавленных пакетов ссылаются на текущие идентификаторы)
+        if (pipeline_ids_.size() >= kMaxPipelineIds){
+            pipeline_ids_.clear();
+        }
+        if (mesh_ids_.size() >= kMaxMeshIds){
+            mesh_ids_.clear();
+        }
+    }
+
+    uint16_t RenderQueue::pipeline_id(const vk::Pipeline& pipeline){
+        // Если за кадр идентификаторы закончились - новые конвейеры делят последний (группировка только ухудшается)
+        if (const auto it = pipeline_ids_.find(static_cast<VkPipeline>(pipeline)); it != pipeline_ids_.end()){
+            return it->second;
+        }
+        if (pipeline_ids_.size() >= kMaxPipelineIds){
+            return to<uint16_t>(kMaxPipelineIds);
+        }
+        const auto id = to<uint16_t>(pipeline_ids_.size());
+        pipeline_ids_.emplace(static_cast<VkPipeline>(pipeline), id);
+        return id;
+    }
+
+    uint16_t RenderQueue::mesh_id(const vk::Buffer& vertex_buffer, const uint32_t lod){
+        // Если за кадр идентификаторы закончились - новая геометрия делит последний (группировка только ухудшается)
+        uint32_t id = kMaxMeshIds;
+        if (const auto it = mesh_ids_.find(static_cast<VkBuffer>(vertex_buffer)); it != mesh_ids_.end()){
+            id = it->second;
+        }else if (mesh_ids_.size() < kMaxMeshIds){
+            id = to<uint32_t>(mesh_ids_.size());
+            mesh_ids_.emplace(static_cast<VkBuffer>(vertex_buffer), to<uint16_t>(id));
+        }
+        return static_cast<uint16_t>((id << kLodBits) | (lod & ((1u << kLodBits) - 1)));
+    }
+
+    uint64_t RenderQueue::make_key(const uint16_t pipeline, const uint32_t mat_index, const uint16_t mesh, const float depth){
+        // Глубина положительна, поэтому старшие 16 бит её представления монотонны (ближние объекты раньше)
+        uint32_t depth_bits = 0;
+        const float clamped = std::max(depth, 0.0f);
+        std::memcpy(&depth_bits, &clamped, sizeof(depth_bits));
+
+        // [конвейер:16][материал:16][геометрия:14, LOD:2][глубина:16]
+        return (static_cast<uint64_t>(pipeline) << 48)
+            | (static_cast<uint64_t>(mat_index & 0xFFFF) << 32)
+            | (static_cast<uint64_t>(mesh) << 16)
+            | static_cast<uint64_t>(depth_bits >> 16);
+    }
+}
@@ -1,16 +1,37 @@
 #include "pch.h"
 #include <nasral/rendering/renderer.h>
 #include <nasral/engine.h>
+#include <nasral/profiling/profiler.h>
 
 namespace nasral::rendering
 {
+    thread_local Renderer::RecordingContext* Renderer::active_context_ = nullptr;
+
     Renderer::Renderer(const Engine *engine, RenderingConfig config)
         : engine_(engine)
         , config_(std::move(config))
         , is_rendering_(false)
         , surface_refresh_required_(false)
+        , pipeline_cache_warm_(false)
+        , pipelines_created_(0)
+        , pipelines_create_time_us_(0)
+        , instance_cursor_(0)
+        , light_clusters_region_(0)
+        , draw_capacity_(std::max(config_.object_capacity, 1u))
+        , buffers_generation_(0)
+        , frame_buffers_generation_(config_.max_frames_in_flight, 0)
         , current_frame_(0)
         , available_image_index_(0)
+        , recording_batches_(0)
+        , frustum_culler_(draw_capacity_)
+        , light_clusterer_(std::max(config_.light_capacity, 1u))
+        , camera_position_(0.0f)
+        , camera_projection_scale_(1.0f)
+        , camera_view_(glm::identity<glm::mat4>())
+        , camera_projection_(glm::identity<glm::mat4>())
+        , object_capacity_(draw_capacity_)
+        , light_capacity_(std::max(config_.light_capacity, 1u))
+        , material_capacity_(std::max(config_.material_capacity, 1u))
     {
         logger()->info("Initializing renderer...");
 
@@ -24,21 +45,32 @@ namespace nasral::rendering
             init_vk_debug_callback();
             logger()->info("Vulkan: Debug callback created.");
 
-            init_vk_surface();
-            logger()->info("Vulkan: Surface created.");
+            if (!config_.headless){
+                init_vk_surface();
+                logger()->info("Vulkan: Surface created.");
+            }
 
             init_vk_device();
             const auto device_name = vk_device_->physical_device().getProperties().deviceName;
             const auto device_name_str = std::string(device_name.data(), strlen(device_name.data()));
             logger()->info("Vulkan: Device initialized (" + device_name_str + ").");
 
+            init_vk_pipeline_cache();
+            logger()->info(std::string("Vulkan: Pipeline cache created (") + (pipeline_cache_warm_ ? "warm" : "cold") + ").");
+
+            compile_pool_ = std::make_unique<threading::ThreadPool>(config_.pipeline_compile_threads, "pipeline compile");
+            logger()->info("Pipeline compile pool created (" + std::to_string(config_.pipeline_compile_threads) + " threads).");
+
             init_vk_render_passes();
             logger()->info("Vulkan: Render passes created.");
 
-            init_vk_swap_chain();
-            logger()->info("Vulkan: Swap chain created.");
-
-            init_vk_framebuffers();
+            if (!config_.headless){
+                init_vk_swap_chain();
+                logger()->info("Vulkan: Swap chain created.");
+                init_vk_framebuffers();
+            }else{
+                init_vk_offscreen_framebuffers();
+            }
             const auto extent = vk_framebuffers_[0]->extent();
             const std::string extent_str = std::to_string(extent.width) + "x" + std::to_string(extent.height);
             logger()->info("Vulkan: Frame buffers created (" + extent_str + ").");
@@ -52,15 +84,31 @@ namespace nasral::rendering
             init_vk_uniforms();
             logger()->info("Vulkan: Uniform buffers allocated.");
 
+            init_vk_texture_table();
+            logger()->info("Vulkan: Texture table created (" + std::to_string(config_.texture_table_size) + " textures).");
+
             init_vk_command_buffers();
             logger()->info("Vulkan: Command buffers created.");
 
+            init_vk_recording_pools();
+            logger()->info("Vulkan: Recording pools created (" + std::to_string(config_.recording_threads) + " threads).");
+
             init_vk_sync_objects();
             logger()->info("Vulkan: Sync primitives created.");
 
             init_index_pools();
             logger()->info("Index pools initialized.");
 
+            // Без поддержки временных меток очередью графики замеры не выполняются (области игнорируются)
+            if (config_.gpu_profiling){
+                gpu_profiler_ = std::make_unique<GpuProfiler>(this, config_.gpu_profiler_scopes);
+                if (gpu_profiler_->is_supported()){
+                    logger()->info("Vulkan: GPU profiler created (" + std::to_string(config_.gpu_profiler_scopes) + " scopes per frame).");
+                }else{
+                    logger()->warning("Vulkan: Timestamps are not supported by graphics queue. GPU profiling is disabled.");
+                }
+            }
+
             is_rendering_ = true;
         }
         catch (const std::exception& e) {
@@ -72,9 +120,39 @@ namespace nasral::rendering
     {
         is_rendering_ = false;
         cmd_wait_for_frame();
+
+        // Итог создания конвейеров за время работы (для сравнения запусков с холодным и прогретым кешем)
+        {
+            std::ostringstream ss;
+            ss.setf(std::ios::fixed);
+            ss.precision(2);
+            ss << "Vulkan: " << pipelines_created_.load() << " pipelines created in "
+               << static_cast<double>(pipelines_create_time_us_.load()) / 1000.0 << " ms ("
+               << (pipeline_cache_warm_ ? "warm" : "cold") << " cache).";
+            logger()->info(ss.str());
+        }
+
+        // Сохранить кеш конвейеров для следующего запуска
+        try{
+            save_vk_pipeline_cache();
+        }catch(const std::exception& e){
+            logger()->warning("Vulkan: Can't save pipeline cache (" + std::string(e.what()) + ").");
+        }
+
+        // Сохранить итоги замеров GPU
+        if (gpu_profiler_ && gpu_profiler_->is_supported() && !config_.gpu_profile_file.empty()){
+            try{
+                save_gpu_profile(config_.gpu_profile_file);
+                logger()->info("Vulkan: GPU profile saved (" + config_.gpu_profile_file + ").");
+            }catch(const std::exception& e){
+                logger()->warning("Vulkan: Can't save GPU profile (" + std::string(e.what()) + ").");
+            }
+        }
     }
 
     void Renderer::cmd_begin_frame(){
+        profiling::Zone zone("Renderer::cmd_begin_frame");
+
         // Если требуется обновить поверхность и связанные с ней кадровые буферы
         if (surface_refresh_required_.exchange(false, std::memory_order_acquire)){
             refresh_vk_surface();
@@ -98,25 +176,52 @@ namespace nasral::rendering
 
         // Ожидаем завершения кадра с текущим индексом (на случай если он еще не готов)
         // Функция блокирует поток при ожидании барьера
+        profiling::Zone fence_zone("wait frame fence");
         (void)vk_device_->logical_device().waitForFences(
             1u,
             &vk_frame_fence_[frame_index].get(),
             VK_TRUE,
             std::numeric_limits<uint64_t>::max());
+        fence_zone.end();
 
         // Сброс барьера кадра
         (void)vk_device_->logical_device().resetFences(
             1u,
             &vk_frame_fence_[frame_index].get());
 
-        // Получить доступное изображение swap-chain
+        // Кадр с текущим индексом завершен - результаты его отсечения на GPU доступны
+        if (gpu_culler_){
+            gpu_culler_->read_back(frame_index);
+        }
+
+        // Замеры GPU кадра с текущим индексом готовы (прочитаны через max_frames_in_flight кадров после записи)
+        if (gpu_profiler_){
+            gpu_profiler_->read_back(frame_index);
+        }
+
+        // Буферы, емкость которых выросла, перевыделяются (наборы кадра переключаются на новые буферы)
+        grow_frame_buffers(frame_index);
+
+        // Набор таблицы текстур кадра не используется - записать накопленные для него элементы
+        texture_writes_apply_unsafe(frame_index);
+
+        // Область кластеров освещения текущего кадра свободна - источники распределяются для текущей камеры
+        build_light_clusters(frame_index);
+
+        // Получить доступное изображение swap-chain (в режиме headless - внеэкранный кадр с индексом текущего кадра)
         // Функция блокирует поток до получения доступного изображения.
-        const auto result = vk_device_->logical_device().acquireNextImageKHR(
-            vk_swap_chain_.get(),
-            std::numeric_limits<uint64_t>::max(),
-            vk_render_available_semaphore_[frame_index].get(),
-            VK_NULL_HANDLE,
-            &available_image_index_);
+        auto result = vk::Result::eSuccess;
+        if (config_.headless){
+            available_image_index_ = to<uint32_t>(frame_index);
+        }else{
+            profiling::Zone acquire_zone("acquireNextImageKHR");
+            result = vk_device_->logical_device().acquireNextImageKHR(
+                vk_swap_chain_.get(),
+                std::numeric_limits<uint64_t>::max(),
+                vk_render_available_semaphore_[frame_index].get(),
+                VK_NULL_HANDLE,
+                &available_image_index_);
+        }
 
         // Если изображение было получено
         if (result == vk::Result::eSuccess){
@@ -124,9 +229,36 @@ namespace nasral::rendering
             auto& cmd_buffer = vk_command_buffers_[frame_index];
             auto& frame_buffer = vk_framebuffers_[available_image_index_]->vk_framebuffer();
 
+            // Сбросить пулы потоков записи (кадр с текущим индексом завершен, его вторичные буферы свободны)
+            if (recording_pool_){
+                for (const auto& pool : vk_recording_pools_[frame_index]){
+                    vk_device_->logical_device().resetCommandPool(pool.get());
+                }
+                vk_recorded_buffers_.clear();
+                recording_batches_ = 0;
+            }
+
+            // Область индексов экземпляров текущего кадра заполняется заново
+            instance_cursor_.store(0, std::memory_order_relaxed);
+
             // Начать работу с буфером команд
             cmd_buffer->reset();
             cmd_buffer->begin(vk::CommandBufferBeginInfo());
+            recording_contexts_[0].reset_state();
+
+            // Буфер копирования данных кадра исполняется первым (команды копирования записываются в конце кадра)
+            auto& upload_buffer = vk_upload_command_buffers_[frame_index];
+            upload_buffer->reset();
+            upload_buffer->begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+            // Область замера кадра начинается в первом исполняемом буфере (включает копирование и отсечение),
+            // область прохода рендеринга - в основном буфере (метки пишутся вне прохода, допустимо и для вторичных буферов)
+            if (gpu_profiler_){
+                gpu_profiler_->cmd_begin_frame(upload_buffer.get(), frame_index);
+                gpu_profiler_->cmd_begin_scope("frame");
+                gpu_profiler_->set_cmd_buffer(cmd_buffer.get());
+                gpu_profiler_->cmd_begin_scope("render pass");
+            }
 
             // Убедиться, что все необходимые storage buffer'ы доступны
             /*
@@ -157,7 +289,7 @@ namespace nasral::rendering
                     vk::Offset2D(0, 0),
                     vk::Extent2D(width, height)))
                 .setClearValues(clear_values),
-                vk::SubpassContents::eInline);
+                recording_pool_ ? vk::SubpassContents::eSecondaryCommandBuffers : vk::SubpassContents::eInline);
         }
         // Возможно требуется пересоздание swap-chain
         else if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR){
@@ -166,6 +298,8 @@ namespace nasral::rendering
     }
 
     void Renderer::cmd_end_frame(){
+        profiling::Zone zone("Renderer::cmd_end_frame");
+
         // Если рендеринг отключен
         if (!is_rendering_) return;
 
@@ -175,8 +309,51 @@ namespace nasral::rendering
         // Получить буфер команд
         auto& cmd_buffer = vk_command_buffers_[frame_index];
 
+        // Исполнить вторичные буферы, записанные потоками записи
+        if (!vk_recorded_buffers_.empty()){
+            cmd_buffer->executeCommands(vk_recorded_buffers_);
+            vk_recorded_buffers_.clear();
+        }
+
         // Завершение прохода (неявное преобразование кадра в VK_IMAGE_LAYOUT_PRESENT_SRC_KHR для представления)
         cmd_buffer->endRenderPass();
+        if (gpu_profiler_){
+            gpu_profiler_->cmd_end_scope();
+        }
+
+        // Перенести изменения данных (камера, объекты, материалы, источники света) в области текущего кадра.
+        // Барьер кадра пройден, GPU эти области не читает, прочие кадры продолжают читать свои области.
+        // Копирование в буферы памяти устройства исполняется перед остальными командами кадра
+        std::vector<vk::CommandBuffer> submit_buffers;
+        if (const auto upload_buffer = cmd_upload_frame_uniforms(frame_index)){
+            submit_buffers.push_back(upload_buffer);
+        }
+
+        // Отсечение на GPU: вычислительный проход исполняется перед основным буфером кадра,
+        // пирамида глубины строится по глубине этого кадра (для отсечения следующего)
+        if (gpu_culler_){
+            if (const auto cull_buffer = gpu_culler_->cmd_cull(frame_index, gpu_profiler_.get())){
+                submit_buffers.push_back(cull_buffer);
+            }
+            if (gpu_profiler_){
+                gpu_profiler_->set_cmd_buffer(cmd_buffer.get());
+                gpu_profiler_->cmd_begin_scope("depth pyramid");
+            }
+            gpu_culler_->cmd_build_pyramid(cmd_buffer.get(), available_image_index_);
+            if (gpu_profiler_){
+                gpu_profiler_->cmd_end_scope();
+            }
+        }
+        submit_buffers.push_back(cmd_buffer.get());
+
+        // Завершить область кадра в основном буфере (и незакрытые области пользователя)
+        if (gpu_profiler_){
+            gpu_profiler_->set_cmd_buffer(cmd_buffer.get());
+            gpu_profiler_->cmd_end_frame();
+        }
+
+        // Собрать статистику кадра
+        collect_frame_stats();
 
         // Завершения командного буфера
         cmd_buffer->end();
@@ -199,19 +376,29 @@ namespace nasral::rendering
         // Отправить командные буферы на исполнение
         const auto& group = vk_device_->queue_group(to<size_t>(CommandGroup::eGraphicsAndPresent));
         auto& queue = group.queues[0];
+        profiling::Zone submit_zone("queue submit");
+
+        // В режиме headless показа нет - о завершении кадра сигнализирует только барьер кадра
+        if (config_.headless){
+            queue.submit(vk::SubmitInfo().setCommandBuffers(submit_buffers), vk_frame_fence_[frame_index].get());
+            current_frame_++;
+            return;
+        }
 
         // Подача команд рендеринга в очередь
         queue.submit(vk::SubmitInfo()
-            .setCommandBuffers(cmd_buffer.get())
+            .setCommandBuffers(submit_buffers)
             .setWaitSemaphores(wait_semaphores)
             .setWaitDstStageMask(wait_stages)
             .setSignalSemaphores(signal_semaphores),
             vk_frame_fence_[frame_index].get());
+        submit_zone.end();
 
         // В случае ошибки показа - вероятно требуется пересоздание swap-chain
         try
         {
             // Подача команд показа в очередь
+            profiling::Zone present_zone("queue present");
             const auto result = queue.presentKHR(vk::PresentInfoKHR()
                 .setSwapchains(vk_swap_chain_.get())
                 .setWaitSemaphores(signal_semaphores)
@@ -238,8 +425,9 @@ namespace nasral::rendering
         // Текущий индекс кадра
         const auto frame_index = current_frame_ % static_cast<size_t>(config_.max_frames_in_flight);
 
-        // Получить буфер команд
-        auto& cmd_buffer = vk_command_buffers_[frame_index];
+        // Получить контекст и буфер команд (основной либо вторичный буфер потока записи)
+        auto& context = recording_context();
+        auto& cmd_buffer = context.cmd_buffer;
 
         // Размеры области рендеринга
         const auto& extent = vk_framebuffers_[frame_index]->extent();
@@ -268,42 +456,59 @@ namespace nasral::rendering
 
         // Получить макет конвейера
         const auto& ul = vk_uniform_layouts_[to<size_t>(UniformLayoutType::eBasicRasterization)];
-        static const auto& pl = ul->vk_pipeline_layout();
+        const auto& pl = ul->vk_pipeline_layout();
+
+        // Передать индекс материала через push constant (если он отличается от текущего)
+        if (context.mat_index != mat_index){
+            cmd_buffer.pushConstants(
+                pl,
+                vk::ShaderStageFlagBits::eVertex|vk::ShaderStageFlagBits::eFragment,
+                0,
+                sizeof(uint32_t),
+                &mat_index);
+            context.mat_index = mat_index;
+        }
 
-        // Передать индекс материала через push constant
-        cmd_buffer->pushConstants(
-            pl,
-            vk::ShaderStageFlagBits::eVertex|vk::ShaderStageFlagBits::eFragment,
-            0,
-            sizeof(uint32_t),
-            &mat_index);
+        // Запись команд. Привязать конвейер (если он отличается от текущего)
+        if (context.pipeline != handles.pipeline){
+            cmd_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, handles.pipeline);
+            context.pipeline = handles.pipeline;
+            context.stats.pipeline_binds++;
+        }else{
+            context.stats.pipeline_binds_saved++;
+        }
+        context.instanced = handles.instanced;
 
-        // Запись команд. Привязать конвейер и динамические состояния
-        cmd_buffer->bindPipeline(vk::PipelineBindPoint::eGraphics, handles.pipeline);
-        cmd_buffer->setViewport(0, {viewport});
-        cmd_buffer->setScissor(0, {scissor});
+        // Динамические состояния одинаковы для всех конвейеров и сохраняются при смене конвейера
+        if (!context.viewport_set){
+            cmd_buffer.setViewport(0, {viewport});
+            cmd_buffer.setScissor(0, {scissor});
+            context.viewport_set = true;
+        }
     }
 
     void Renderer::cmd_bind_frame_descriptors(){
         // Если рендеринг отключен
         if (!is_rendering_) return;
-        // Текущий индекс кадра
+        // При параллельной записи дескрипторы привязываются в каждом вторичном буфере
+        if (recording_pool_ && active_context_ == nullptr) return;
+        // Текущий индекс кадра (наборы кадра ссылаются на его области кольцевых буферов)
         const auto frame_index = current_frame_ % static_cast<size_t>(config_.max_frames_in_flight);
         // Получить буфер команд
-        auto& cmd_buffer = vk_command_buffers_[frame_index];
+        auto& cmd_buffer = recording_context().cmd_buffer;
         // Получить макет конвейера
         const auto& ul = vk_uniform_layouts_[to<size_t>(UniformLayoutType::eBasicRasterization)];
-        static const auto& pl = ul->vk_pipeline_layout();
+        const auto& pl = ul->vk_pipeline_layout();
         // Привязать все необходимые дескрипторы
-        cmd_buffer->bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+        cmd_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
             pl,
             0,
             {
-                vk_dset_view_.get(),
-                vk_dset_objects_uniforms_.get(),
-                vk_dset_material_uniforms_.get(),
-                vk_dset_material_textures_.get(),
-                vk_dset_light_sources_.get()
+                vk_dsets_view_[frame_index].get(),
+                vk_dsets_objects_uniforms_[frame_index].get(),
+                vk_dsets_material_uniforms_[frame_index].get(),
+                vk_dsets_material_textures_[frame_index % vk_dsets_material_textures_.size()].get(),
+                vk_dsets_light_sources_[frame_index].get()
             },
             {});
     }
@@ -312,103 +517,483 @@ namespace nasral::rendering
         // Если рендеринг отключен
         if (!is_rendering_) return;
 
-        // Текущий индекс кадра
-        const auto frame_index = current_frame_ % static_cast<size_t>(config_.max_frames_in_flight);
+        // Получить контекст и буфер команд
+        auto& context = recording_context();
+        auto& cmd_buffer = context.cmd_buffer;
 
-        // Получить буфер команд
-        auto& cmd_buffer = vk_command_buffers_[frame_index];
+        // Конвейер с instanced-шейдером читает индекс объекта из буфера экземпляров
+        if (context.instanced){
+            cmd_draw_mesh_instanced(handles, &obj_index, 1);
+            return;
+        }
 
         // Получить макет конвейера
         const auto& ul = vk_uniform_layouts_[to<size_t>(UniformLayoutType::eBasicRasterization)];
-        static const auto& pl = ul->vk_pipeline_layout();
+        const auto& pl = ul->vk_pipeline_layout();
 
         // Передать индекс объекта через push constant
-        cmd_buffer->pushConstants(
+        cmd_buffer.pushConstants(
             pl,
             vk::ShaderStageFlagBits::eVertex|vk::ShaderStageFlagBits::eFragment,
             sizeof(uint32_t),
             sizeof(uint32_t),
             &obj_index);
 
-        // Запись команд. Привязать геометрию и нарисовать её
-        cmd_buffer->bindVertexBuffers(0, {handles.vertex_buffer}, {0});
-        cmd_buffer->bindIndexBuffer(handles.index_buffer, 0, vk::IndexType::eUint32);
-        cmd_buffer->drawIndexed(handles.index_count, 1, 0, 0, 0);
+        // Запись команд. Привязать геометрию (если она отличается от текущей) и нарисовать её
+        cmd_bind_mesh(context, handles);
+        cmd_buffer.drawIndexed(handles.index_count, 1, handles.first_index, 0, 0);
+        context.stats.draw_calls++;
+    }
+
+    void Renderer::cmd_draw_mesh_instanced(const Handles::Mesh& handles, const uint32_t* obj_indices, const uint32_t count){
+        // Если рендеринг отключен
+        if (!is_rendering_ || count == 0) return;
+        assert(obj_indices != nullptr);
+
+        // Текущий индекс кадра
+        const auto frame_index = current_frame_ % static_cast<size_t>(config_.max_frames_in_flight);
+
+        // Получить контекст и буфер команд
+        auto& context = recording_context();
+        auto& cmd_buffer = context.cmd_buffer;
+
+        // Занять отрезок области индексов текущего кадра (запись возможна из нескольких потоков)
+        // При переполнении рисуются поместившиеся экземпляры, область растет в начале следующего кадра
+        const auto offset = instance_cursor_.fetch_add(count, std::memory_order_relaxed);
+        const auto fitting = offset < draw_capacity_ ? std::min(count, draw_capacity_ - offset) : 0u;
+        if (fitting == 0) return;
+
+        // Скопировать индексы объектов, первый экземпляр указывает на начало отрезка
+        const auto first_instance = to<uint32_t>(frame_index) * draw_capacity_ + offset;
+        vk_ubo_instance_indices_->update_mapped(
+            sizeof(uint32_t) * first_instance,
+            sizeof(uint32_t) * fitting,
+            obj_indices);
+
+        // Запись команд. Привязать геометрию (если она отличается от текущей) и нарисовать экземпляры
+        cmd_bind_mesh(context, handles);
+        cmd_buffer.drawIndexed(handles.index_count, fitting, handles.first_index, 0, first_instance);
+        context.stats.draw_calls++;
+        context.stats.instances += fitting;
+    }
+
+    void Renderer::cmd_draw_mesh_indirect(const Handles::Mesh& handles, const uint32_t first_command, const uint32_t count){
+        // Если рендеринг отключен
+        if (!is_rendering_ || count == 0) return;
+
+        // Текущий индекс кадра (команды адресуются относительно области кадра)
+        const auto frame_index = current_frame_ % static_cast<size_t>(config_.max_frames_in_flight);
+        const auto command_index = to<uint32_t>(frame_index) * draw_capacity_ + first_command;
+        assert(first_command + count <= draw_capacity_);
+
+        // Получить контекст и буфер команд
+        auto& context = recording_context();
+        auto& cmd_buffer = context.cmd_buffer;
+
+        // Запись команд. Привязать геометрию (если она отличается от текущей)
+        cmd_bind_mesh(context, handles);
+
+        // Нарисовать команды из буфера (кол-во команд из буфера, если поддерживается)
+        const auto stride = to<uint32_t>(sizeof(vk::DrawIndexedIndirectCommand));
+        const auto offset = static_cast<vk::DeviceSize>(stride) * command_index;
+        const auto& features = vk_device_->optional_features();
+
+        if (features.draw_indirect_count){
+            cmd_buffer.drawIndexedIndirectCount(
+                vk_indirect_commands_->vk_buffer(),
+                offset,
+                vk_indirect_counts_->vk_buffer(),
+                sizeof(uint32_t) * command_index,
+                count,
+                stride);
+            context.stats.draw_calls++;
+        }else if (features.multi_draw_indirect || count == 1){
+            cmd_buffer.drawIndexedIndirect(vk_indirect_commands_->vk_buffer(), offset, count, stride);
+            context.stats.draw_calls++;
+        }else{
+            for (uint32_t i = 0; i < count; ++i){
+                cmd_buffer.drawIndexedIndirect(vk_indirect_commands_->vk_buffer(), offset + stride * i, 1, stride);
+            }
+            context.stats.draw_calls += count;
+        }
+        context.stats.indirect_commands += count;
+    }
+
+    void Renderer::cmd_record_parallel(const size_t count, const RecordFn& record){
+        // Если рендеринг отключен
+        if (!is_rendering_ || count == 0) return;
+
+        // Время начала записи
+        const auto started = std::chrono::steady_clock::now();
+        auto& main_context = recording_contexts_[0];
+
+        // Без потоков записи - запись в основной буфер команд текущим потоком
+        if (!recording_pool_){
+            record(0, count);
+            main_context.stats.record_time_ms += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - started).count();
+            return;
+        }
+
+        // Текущий индекс кадра и пакета (каждый вызов записывает свой набор вторичных буферов)
+        const auto frame_index = current_frame_ % static_cast<size_t>(config_.max_frames_in_flight);
+        const auto batch_index = recording_batches_++;
+        const size_t threads = recording_contexts_.size() - 1;
+
+        // Получить (либо выделить) вторичные буферы пакета для каждого потока
+        std::vector<vk::CommandBuffer> buffers(threads);
+        for (size_t t = 0; t < threads; ++t){
+            auto& thread_buffers = vk_recording_buffers_[frame_index][t];
+            if (thread_buffers.size() <= batch_index){
+                auto allocated = vk_device_->logical_device().allocateCommandBuffersUnique(
+                    vk::CommandBufferAllocateInfo()
+                    .setCommandPool(vk_recording_pools_[frame_index][t].get())
+                    .setLevel(vk::CommandBufferLevel::eSecondary)
+                    .setCommandBufferCount(1));
+                thread_buffers.emplace_back(std::move(allocated[0]));
+            }
+            buffers[t] = thread_buffers[batch_index].get();
+        }
+
+        // Вторичные буферы продолжают текущий проход рендеринга
+        const auto inheritance = vk::CommandBufferInheritanceInfo()
+            .setRenderPass(vk_render_pass_.get())
+            .setSubpass(0)
+            .setFramebuffer(vk_framebuffers_[available_image_index_]->vk_framebuffer());
+
+        // Каждый поток записывает свой непрерывный отрезок списка отрисовки
+        const size_t slice = (count + threads - 1) / threads;
+        recording_pool_->parallel_for(threads, [&](const size_t t){
+            auto& context = recording_contexts_[t + 1];
+            context.cmd_buffer = buffers[t];
+            context.reset_state();
+            context.cmd_buffer.begin(vk::CommandBufferBeginInfo()
+                .setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+                .setPInheritanceInfo(&inheritance));
+
+            // Дальнейшие команды этого потока направляются во вторичный буфер
+            active_context_ = &context;
+            try{
+                const size_t begin = std::min(count, t * slice);
+                const size_t end = std::min(count, begin + slice);
+                cmd_bind_frame_descriptors();
+                if (begin < end) record(begin, end);
+            }catch(...){
+                active_context_ = nullptr;
+                throw;
+            }
+            active_context_ = nullptr;
+
+            context.cmd_buffer.end();
+        });
+
+        // Сохранить порядок исполнения (порядок вызовов и отрезков)
+        vk_recorded_buffers_.insert(vk_recorded_buffers_.end(), buffers.begin(), buffers.end());
+        main_context.stats.command_buffers += to<uint32_t>(threads);
+        main_context.stats.record_time_ms += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - started).count();
+    }
+
+    void Renderer::cmd_draw_queue(){
+        // Если рендеринг отключен - пакеты текущего кадра отбрасываются
+        if (!is_rendering_){
+            render_queue_.clear();
+            return;
+        }
+
+        // Отсортировать пакеты (конвейер, материал, геометрия, глубина) и записать их
+        // Соседние пакеты чаще всего разделяют состояние, избыточные команды пропускаются при записи
+        render_queue_.sort();
+
+        // Непрямая отрисовка - команды заполняются заранее, записывается по одному вызову на пакет
+        if (config_.indirect_draws){
+            build_indirect_batches();
+            cmd_record_parallel(indirect_batches_.size(), [this](const size_t begin, const size_t end){
+                for (size_t b = begin; b < end; ++b){
+                    const auto& batch = indirect_batches_[b];
+                    const auto& packet = render_queue_.packet(batch.first_packet);
+                    cmd_bind_material(packet.material, packet.mat_index);
+
+                    if (batch.command_count > 0){
+                        cmd_draw_mesh_indirect(packet.mesh, batch.first_command, batch.command_count);
+                        continue;
+                    }
+
+                    // Экземпляры instanced-материала не поместились в область кадра (отрезок пропускается)
+                    if (packet.material.instanced) continue;
+
+                    // Материалы без instanced-шейдера получают индекс объекта через push constant
+                    for (uint32_t i = 0; i < batch.packet_count; ++i){
+                        const auto& p = render_queue_.packet(batch.first_packet + i);
+                        cmd_draw_mesh(p.mesh, p.obj_index);
+                    }
+                }
+            });
+            render_queue_.clear();
+            return;
+        }
+        cmd_record_parallel(render_queue_.size(), [this](const size_t begin, const size_t end){
+            std::vector<uint32_t> obj_indices;
+            for (size_t i = begin; i < end;){
+                const auto& packet = render_queue_.packet(i);
+                cmd_bind_material(packet.material, packet.mat_index);
+
+                if (!packet.material.instanced){
+                    cmd_draw_mesh(packet.mesh, packet.obj_index);
+                    ++i;
+                    continue;
+                }
+
+                // Соседние пакеты с тем же материалом и геометрией рисуются одним instanced-вызовом
+                obj_indices.clear();
+                for (; i < end && render_queue_.packet(i).shares_state(packet); ++i){
+                    obj_indices.push_back(render_queue_.packet(i).obj_index);
+                }
+                cmd_draw_mesh_instanced(packet.mesh, obj_indices.data(), to<uint32_t>(obj_indices.size()));
+            }
+        });
+        render_queue_.clear();
     }
 
     void Renderer::cmd_wait_for_frame() const{
         vk_device_->logical_device().waitIdle();
     }
 
+    void Renderer::cmd_begin_gpu_scope(const std::string& name){
+        // Если рендеринг отключен либо замеры не выполняются
+        if (!is_rendering_ || !gpu_profiler_) return;
+        // При параллельной записи проход рендеринга содержит только вторичные буферы - метки в нем не пишутся
+        if (recording_pool_) return;
+        gpu_profiler_->cmd_begin_scope(name);
+    }
+
+    void Renderer::cmd_end_gpu_scope(){
+        if (!is_rendering_ || !gpu_profiler_ || recording_pool_) return;
+        gpu_profiler_->cmd_end_scope();
+    }
+
+    void Renderer::save_gpu_profile(const std::string& path) const{
+        if (!gpu_profiler_) return;
+        gpu_profiler_->save(path);
+    }
+
+    void Renderer::queue_draw(
+        const Handles::Material& material,
+        const uint32_t mat_index,
+        const Handles::Mesh& mesh,
+        const uint32_t obj_index,
+        const float depth)
+    {
+        // Уровень детализации по экранному размеру ограничивающей сферы
+        const auto lod = select_lod(mesh, obj_index);
+        if (lod == mesh.lod){
+            render_queue_.push(material, mat_index, mesh, obj_index, depth);
+            recording_contexts_[0].stats.triangles_queued += mesh.index_count / 3;
+            return;
+        }
+
+        auto lod_mesh = mesh;
+        lod_mesh.lod = lod;
+        lod_mesh.first_index = mesh.lods[lod].first_index;
+        lod_mesh.index_count = mesh.lods[lod].index_count;
+        render_queue_.push(material, mat_index, lod_mesh, obj_index, depth);
+        recording_contexts_[0].stats.triangles_queued += lod_mesh.index_count / 3;
+    }
+
+    uint32_t Renderer::select_lod(const Handles::Mesh& mesh, const uint32_t obj_index) const{
+        if (mesh.lod_count < 2 || config_.lod_screen_size <= 0.0f) return mesh.lod;
+
+        // Экранный размер - проекция радиуса к половине высоты кадра (камера внутри сферы - полный уровень)
+        const auto sphere = frustum_culler_.sphere(obj_index);
+        const float distance = glm::length(glm::vec3(sphere) - camera_position_);
+        if (sphere.w < 0.0f || distance <= sphere.w) return 0;
+        const float size = sphere.w * camera_projection_scale_ / distance;
+
+        // Наиболее упрощенный уровень, плотность треугольников которого на экране не ниже плотности
+        // полного уровня на экранном размере lod_screen_size (кол-во треугольников пропорционально площади)
+        const float ratio = size / config_.lod_screen_size;
+        const float required = ratio * ratio * static_cast<float>(mesh.lods[0].index_count);
+        for (uint32_t lod = mesh.lod_count - 1; lod > 0; --lod){
+            if (static_cast<float>(mesh.lods[lod].index_count) >= required) return lod;
+        }
+        return 0;
+    }
+
+    vk::CommandBuffer Renderer::cmd_upload_frame_uniforms(const size_t frame_index){
+        // Буфер начат в начале кадра (в нем же сброшены запросы замеров GPU)
+        auto& cmd_buffer = vk_upload_command_buffers_[frame_index];
+        if (gpu_profiler_){
+            gpu_profiler_->set_cmd_buffer(cmd_buffer.get());
+            gpu_profiler_->cmd_begin_scope("upload");
+        }
+
+        // Буферы в памяти CPU обновляются сразу, для буферов в памяти устройства записываются команды копирования
+        bool copied = false;
+        for (auto* ring : {
+            vk_ubo_view_.get(),
+            vk_ubo_objects_transforms_.get(),
+            vk_ubo_objects_bounds_.get(),
+            vk_ubo_materials_phong_.get(),
+            vk_ubo_materials_pbr_.get(),
+            vk_ubo_materials_textures_.get(),
+            vk_ubo_light_sources_.get(),
+            vk_ubo_light_indices_.get()})
+        {
+            const auto bytes = ring->flush(frame_index, cmd_buffer.get());
+            recording_contexts_[0].stats.uniform_bytes_uploaded += bytes;
+            copied = copied || (bytes > 0 && ring->is_device_local());
+        }
+
+        // Скопированные данные читаются shader'ами кадра (включая вычислительный проход отсечения)
+        if (copied){
+            const auto barrier = vk::MemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+            cmd_buffer->pipelineBarrier(
+                vk::PipelineStageFlagBits::eTransfer,
+                vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader,
+                {},
+                {barrier},
+                {},
+                {});
+        }
+
+        if (gpu_profiler_){
+            gpu_profiler_->cmd_end_scope();
+        }
+
+        // Буфер с замерами исполняется и без копирования (содержит сброс запросов и начало области кадра)
+        cmd_buffer->end();
+        const bool profiled = gpu_profiler_ && gpu_profiler_->is_supported();
+        return copied || profiled ? cmd_buffer.get() : vk::CommandBuffer();
+    }
+
     void Renderer::request_surface_refresh(){
         surface_refresh_required_.store(true, std::memory_order_release);
     }
 
-    void Renderer::update_cam_ubo(const uint32_t index, const CameraUniforms& uniforms) const{
-        assert(vk_ubo_view_->is_mapped());
-        vk_ubo_view_->update_mapped(
-            ubo_offset<CameraUniforms>(index),
-            aligned_ubo_size<CameraUniforms>(),
-            &uniforms);
+    void Renderer::update_cam_ubo(const uint32_t index, const CameraUniforms& uniforms){
+        vk_ubo_view_->update(index, uniforms);
+
+        // Параметры основной камеры (выбор уровней детализации, кластеры освещения)
+        if (index == 0){
+            camera_position_ = glm::vec3(uniforms.position);
+            camera_projection_scale_ = std::abs(uniforms.projection[1][1]);
+            camera_view_ = uniforms.view;
+            camera_projection_ = uniforms.projection;
+        }
     }
 
     void Renderer::update_obj_ubo(const uint32_t index, const ObjectTransformUniforms& uniforms) const{
-        assert(vk_ubo_objects_transforms_->is_mapped());
-        vk_ubo_objects_transforms_->update_mapped(
-            sbo_offset<ObjectTransformUniforms>(index),
-            aligned_sbo_size<ObjectTransformUniforms>(),
-            &uniforms);
+        vk_ubo_objects_transforms_->update(index, uniforms);
+    }
+
+    void Renderer::update_obj_bounds(const uint32_t index, const glm::vec4& sphere, const glm::mat4& model){
+        assert(index < object_capacity_);
+
+        // Сфера в пространстве модели (для отсечения на GPU, трансформируется в shader'е)
+        vk_ubo_objects_bounds_->update(index, sphere);
+
+        // Сфера в мировом пространстве (радиус по наибольшему масштабу)
+        const auto center = glm::vec3(model * glm::vec4(glm::vec3(sphere), 1.0f));
+        const float scale = std::max({
+            glm::length(glm::vec3(model[0])),
+            glm::length(glm::vec3(model[1])),
+            glm::length(glm::vec3(model[2]))});
+        frustum_culler_.set_sphere(index, glm::vec4(center, sphere.w * scale));
+    }
+
+    void Renderer::cull_objects(const glm::mat4& view_proj){
+        if (gpu_culler_){
+            gpu_culler_->set_view(view_proj, camera_position_);
+        }
+
+        if (!config_.frustum_culling) return;
+        frustum_culler_.cull(view_proj);
+    }
+
+    void Renderer::init_gpu_culling(resources::ResourceManager* manager){
+        if (!config_.gpu_culling || gpu_culler_) return;
+        assert(manager != nullptr);
+
+        try{
+            gpu_culler_ = std::make_unique<GpuCuller>(this, manager);
+            logger()->info("Vulkan: GPU culling initialized.");
+        }catch(const std::exception& e){
+            gpu_culler_.reset();
+            config_.gpu_culling = false;
+            logger()->warning("Vulkan: Can't initialize GPU culling (" + std::string(e.what()) + "). Falling back to CPU culling.");
+        }
+    }
+
+    void Renderer::release_gpu_culling(){
+        if (!gpu_culler_) return;
+
+        // Конвейеры и пирамида могут использоваться активными кадрами
+        cmd_wait_for_frame();
+        gpu_culler_.reset();
     }
 
     void Renderer::update_material_ubo(const uint32_t index, const MaterialPhongUniforms& uniforms) const{
-        assert(vk_ubo_materials_phong_->is_mapped());
-        vk_ubo_materials_phong_->update_mapped(
-            sbo_offset<MaterialPhongUniforms>(index),
-            aligned_sbo_size<MaterialPhongUniforms>(),
-            &uniforms);
+        vk_ubo_materials_phong_->update(index, uniforms);
     }
 
     void Renderer::update_material_ubo(const uint32_t index, const MaterialPbrUniforms& uniforms) const{
-        assert(vk_ubo_materials_pbr_->is_mapped());
-        vk_ubo_materials_pbr_->update_mapped(
-            sbo_offset<MaterialPbrUniforms>(index),
-            aligned_sbo_size<MaterialPbrUniforms>(),
-            &uniforms);
+        vk_ubo_materials_pbr_->update(index, uniforms);
     }
 
-    void Renderer::update_material_tex(const uint32_t index, const TextureBindingInfo& info) const{
-        assert(index < MAX_MATERIALS);
-        assert(info.texture);
-        assert(vk_dset_material_textures_);
+    void Renderer::update_material_tex(const uint32_t index, const MaterialTextureUniforms& uniforms) const{
+        vk_ubo_materials_textures_->update(index, uniforms);
+    }
 
-        const auto& sampler = vk_texture_samplers_[to<size_t>(info.sampler_type)];
-        vk::DescriptorImageInfo image_info{};
-        image_info.setSampler(sampler.get())
-                  .setImageView(info.texture.image_view)
-                  .setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+    void Renderer::update_light_ubo(const uint32_t index, const LightUniforms &uniforms) {
+        vk_ubo_light_sources_->update(index, uniforms);
 
-        vk::WriteDescriptorSet write{};
-        write.setDstSet(vk_dset_material_textures_.get())
-             .setDstBinding(to<uint32_t>(info.type))
-             .setDstArrayElement(index) // Индекс объекта в массиве дескрипторов
-             .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
-             .setDescriptorCount(1)
-             .setImageInfo(image_info);
+        // Ограничивающая сфера источника (для распределения по кластерам)
+        light_clusterer_.set_light(index, glm::vec4(glm::vec3(uniforms.position), uniforms.radius));
+    }
+
+    vk::UniquePipeline Renderer::create_graphics_pipeline(const vk::GraphicsPipelineCreateInfo& info) const{
+        const auto started = std::chrono::steady_clock::now();
+        auto result = vk_device_->logical_device().createGraphicsPipelineUnique(vk_pipeline_cache_.get(), info);
+        if (result.result != vk::Result::eSuccess){
+            throw std::runtime_error("Failed to create graphics pipeline!");
+        }
+
+        on_pipeline_created(started);
+        return std::move(result.value);
+    }
+
+    vk::UniquePipeline Renderer::create_compute_pipeline(const UniformLayoutType& layout, const vk::ShaderModule& shader_module) const{
+        const auto started = std::chrono::steady_clock::now();
+        auto pipeline = vk_uniform_layout(layout).create_compute_pipeline(shader_module, vk_pipeline_cache_.get());
 
-        vk_device_->logical_device().updateDescriptorSets({write}, {});
+        on_pipeline_created(started);
+        return pipeline;
     }
 
-    void Renderer::update_light_ubo(const uint32_t index, const LightUniforms &uniforms) const {
-        assert(vk_ubo_light_sources_->is_mapped());
-        vk_ubo_light_sources_->update_mapped(
-            sbo_offset<LightUniforms>(index),
-            aligned_sbo_size<LightUniforms>(),
-            &uniforms);
+    std::future<void> Renderer::submit_pipeline_task(threading::ThreadPool::Task task) const{
+        // Без рабочих потоков задача выполняется сразу (в вызывающем потоке)
+        assert(compile_pool_);
+        return compile_pool_->submit(std::move(task));
     }
 
     uint32_t Renderer::obj_id_acquire_unsafe(){
+        // Нет свободных индексов - растут копии трансформаций, ограничивающих сфер и отсечения
         if (object_ids_.empty()){
-            throw RenderingError("No more object IDs available");
+            if (object_capacity_ > std::numeric_limits<uint32_t>::max() / 2){
+                throw RenderingError("No more object IDs available");
+            }
+
+            const uint32_t capacity = object_capacity_ * 2;
+            for (uint32_t i = capacity; i > object_capacity_; --i){
+                object_ids_.push_back(i - 1);
+            }
+            object_capacity_ = capacity;
+            vk_ubo_objects_transforms_->reserve(capacity);
+            vk_ubo_objects_bounds_->reserve(capacity);
+            frustum_culler_.reserve(capacity);
         }
 
         const uint32_t id = object_ids_.back();
@@ -422,8 +1007,9 @@ namespace nasral::rendering
     }
 
     void Renderer::obj_id_release_unsafe(const uint32_t id){
-        assert(id < MAX_OBJECTS);
+        assert(id < object_capacity_);
         object_ids_.push_back(id);
+        frustum_culler_.reset(id);
     }
 
     void Renderer::obj_id_release(const uint32_t id){
@@ -433,7 +1019,8 @@ namespace nasral::rendering
 
     void Renderer::obj_ids_reset_unsafe(){
         object_ids_.clear();
-        for (uint32_t i = MAX_OBJECTS; i > 0; --i){
+        frustum_culler_.reset_all();
+        for (uint32_t i = object_capacity_; i > 0; --i){
             object_ids_.push_back(i - 1);
         }
     }
@@ -448,18 +1035,36 @@ namespace nasral::rendering
         const std::string& path,
         const std::vector<std::string>& tex_paths)
     {
+        // Нет свободных индексов - растут слоты материалов, индексы их текстур и копии параметров
         if (material_ids_.empty()){
-            throw RenderingError("No more material IDs available");
+            if (material_capacity_ > std::numeric_limits<uint32_t>::max() / 2){
+                throw RenderingError("No more material IDs available");
+            }
+
+            const uint32_t capacity = material_capacity_ * 2;
+            for (uint32_t i = capacity; i > material_capacity_; --i){
+                material_ids_.push_back(i - 1);
+            }
+            material_capacity_ = capacity;
+            materials_.reserve(capacity);
+            material_texture_ids_.reserve(capacity);
+            vk_ubo_materials_phong_->reserve(capacity);
+            vk_ubo_materials_pbr_->reserve(capacity);
+            vk_ubo_materials_textures_->reserve(capacity);
         }
 
         const uint32_t id = material_ids_.back();
         material_ids_.pop_back();
 
-        assert(id < MAX_MATERIALS);
+        assert(id < material_capacity_);
         if (to<size_t>(id) >= materials_.size()){
             materials_.emplace_back(std::nullopt);
+            material_texture_ids_.emplace_back();
         }
 
+        // До загрузки текстур материал ссылается на текстуру по умолчанию
+        update_material_tex(id, MaterialTextureUniforms{});
+
         assert(materials_[id] == std::nullopt);
         materials_[id] = std::optional<MaterialInstance>({
             engine()->resource_manager(),
@@ -481,7 +1086,7 @@ namespace nasral::rendering
     }
 
     MaterialInstance& Renderer::material_instance_unsafe(const uint32_t id){
-        assert(id < MAX_MATERIALS);
+        assert(id < material_capacity_);
         if (materials_[id] == std::nullopt){
             throw RenderingError("Material ID is invalid");
         }
@@ -494,13 +1099,18 @@ namespace nasral::rendering
     }
 
     void Renderer::material_release_unsafe(const uint32_t id){
-        assert(id < MAX_MATERIALS);
+        assert(id < material_capacity_);
         if (materials_[id] == std::nullopt){
             throw RenderingError("Material ID is invalid");
         }
 
         materials_[id] = std::nullopt;
         material_ids_.push_back(id);
+
+        // Текстуры материала освобождаются в таблице
+        for (auto& texture_id : material_texture_ids_[id]){
+            texture_id_release_unsafe(std::exchange(texture_id, 0));
+        }
     }
 
     void Renderer::material_release(const uint32_t id){
@@ -509,10 +1119,17 @@ namespace nasral::rendering
     }
 
     void Renderer::materials_reset_unsafe(){
+        for (const auto& texture_ids : material_texture_ids_){
+            for (const auto texture_id : texture_ids){
+                texture_id_release_unsafe(texture_id);
+            }
+        }
+
         materials_.clear();
         material_ids_.clear();
+        material_texture_ids_.clear();
 
-        for (uint32_t i = MAX_MATERIALS; i > 0; --i){
+        for (uint32_t i = material_capacity_; i > 0; --i){
             material_ids_.push_back(i - 1);
         }
     }
@@ -523,11 +1140,25 @@ namespace nasral::rendering
     }
 
     void Renderer::materials_update_unsafe(){
+        profiling::Zone zone("Renderer::materials_update_unsafe");
+
+        // Индексы таблицы текстур, к которым могли обращаться только завершенные кадры, снова доступны
+        const auto matured = std::partition(retired_texture_ids_.begin(), retired_texture_ids_.end(), [this](const auto& retired_id){
+            return retired_id.first > current_frame_;
+        });
+        for (auto it = matured; it != retired_texture_ids_.end(); ++it){
+            texture_free_ids_.push_back(it->second);
+        }
+        retired_texture_ids_.erase(matured, retired_texture_ids_.end());
+
         for (size_t i = 0; i < materials_.size(); ++i){
             if (materials_[i].has_value()){
                 const auto index = to<uint32_t>(i);
                 auto& m = materials_[i].value();
 
+                // Конвейер материала (вариант по заданным текстурам, создается асинхронно)
+                m.update_render_handles();
+
                 // Параметры материалов
                 if (m.check_changes(MaterialInstance::eSettingsChanged, false, true)){
                     if (m.settings().has_value()){
@@ -544,25 +1175,45 @@ namespace nasral::rendering
                     }
                 }
 
-                // Текстуры материалов
+                // Текстуры материалов (индексы в глобальной таблице текстур и семплеры)
                 if (m.check_changes(MaterialInstance::eTextureChanged, false, true)){
+                    auto& texture_ids = material_texture_ids_[i];
+                    MaterialTextureUniforms uniforms{};
                     for (uint32_t tt = 0; tt < to<uint32_t>(TextureType::TOTAL); ++tt){
-                        if (const Handles::Texture& th = m.tex_render_handles(to<TextureType>(tt))){
-                            TextureBindingInfo info{};
-                            info.texture = th;
-                            info.type = to<TextureType>(tt);
-                            info.sampler_type = m.tex_sampler(info.type);
-                            update_material_tex(index, info);
-                        }
+                        // Незагруженная текстура - текстура по умолчанию (новая ссылка берется до освобождения прежней)
+                        const Handles::Texture& th = m.tex_render_handles(to<TextureType>(tt));
+                        const uint32_t texture_id = th ? texture_id_acquire_unsafe(th) : 0;
+                        texture_id_release_unsafe(texture_ids[tt]);
+                        texture_ids[tt] = texture_id;
+
+                        uniforms.textures[tt] = texture_id;
+                        uniforms.samplers[tt] = to<uint32_t>(m.tex_sampler(to<TextureType>(tt)));
                     }
+                    update_material_tex(index, uniforms);
                 }
             }
         }
+
+        // Новые элементы таблицы текстур всех материалов записываются одним вызовом
+        texture_writes_flush_unsafe();
     }
 
     uint32_t Renderer::light_id_acquire_unsafe() {
+        // Нет свободных индексов - растут позиции активных источников, копии параметров и кластеры
         if (light_ids_.empty()) {
-            throw RenderingError("No more light IDs available");
+            if (light_capacity_ > std::numeric_limits<uint32_t>::max() / 2) {
+                throw RenderingError("No more light IDs available");
+            }
+
+            const uint32_t capacity = light_capacity_ * 2;
+            for (uint32_t i = capacity; i > light_capacity_; --i) {
+                light_ids_.push_back(i - 1);
+            }
+            light_capacity_ = capacity;
+            active_light_slots_.resize(capacity, INACTIVE_LIGHT_SLOT);
+            vk_ubo_light_sources_->reserve(capacity);
+            vk_ubo_light_indices_->reserve(capacity + 1);
+            light_clusterer_.reserve(capacity);
         }
 
         const uint32_t id = light_ids_.back();
@@ -576,43 +1227,46 @@ namespace nasral::rendering
     }
 
     void Renderer::light_id_release_unsafe(const uint32_t id) {
-        assert(id < MAX_LIGHTS);
+        assert(id < light_capacity_);
         light_ids_.push_back(id);
     }
 
     void Renderer::light_id_release(const uint32_t id) {
-        std::lock_guard lock(obj_ids_mutex_);
+        std::lock_guard lock(light_ids_mutex_);
         light_id_release_unsafe(id);
     }
 
     void Renderer::light_ids_reset_unsafe() {
         light_ids_.clear();
-        for (uint32_t i = MAX_LIGHTS; i > 0; --i) {
+        for (uint32_t i = light_capacity_; i > 0; --i) {
             light_ids_.push_back(i - 1);
         }
     }
 
     void Renderer::light_ids_reset() {
-        std::lock_guard lock(obj_ids_mutex_);
+        std::lock_guard lock(light_ids_mutex_);
         light_ids_reset_unsafe();
     }
 
     void Renderer::light_ids_activate_unsafe(const std::vector<uint32_t> &ids) {
-        assert(vk_ubo_light_indices_->is_mapped());
-        assert(std::all_of(ids.begin(), ids.end(), [](const uint32_t id) { return id < MAX_LIGHTS; }));
-        assert(ids.size() <= MAX_LIGHTS);
+        assert(vk_ubo_light_indices_);
+        assert(std::all_of(ids.begin(), ids.end(), [this](const uint32_t id) { return id < light_capacity_; }));
+        assert(ids.size() <= light_capacity_);
 
+        // Новый источник дописывается в конец плотного списка (в буфер попадает только его элемент)
         auto& active = active_light_ids_;
+        const auto count = active.size();
         for (const auto id : ids) {
-            if (std::find(active.begin(), active.end(), id) == active.end()) {
-                active.push_back(id);
-            }
+            if (id >= light_capacity_ || active_light_slots_[id] != INACTIVE_LIGHT_SLOT) continue;
+            active_light_slots_[id] = to<uint32_t>(active.size());
+            active.push_back(id);
+            vk_ubo_light_indices_->update(to<uint32_t>(active.size()), id);
         }
 
-        auto* pids = static_cast<LightIndices*>(vk_ubo_light_indices_->mapped_ptr());
-        pids->count = static_cast<uint32_t>(active.size());
-        std::fill_n(pids->indices, MAX_LIGHTS, 0);
-        std::memcpy(pids->indices, active.data(), active.size() * sizeof(uint32_t));
+        // Кол-во обновляется один раз на весь пакет
+        if (active.size() != count) {
+            vk_ubo_light_indices_->update(0, to<uint32_t>(active.size()));
+        }
     }
 
     void Renderer::light_ids_activate(const std::vector<uint32_t> &ids) {
@@ -621,21 +1275,31 @@ namespace nasral::rendering
     }
 
     void Renderer::light_ids_deactivate_unsafe(const std::vector<uint32_t> &ids) {
-        if (!vk_ubo_light_indices_->is_mapped()) return;
-        assert(std::all_of(ids.begin(), ids.end(), [](const uint32_t id) { return id < MAX_LIGHTS; }));
-        assert(ids.size() <= MAX_LIGHTS);
+        if (!vk_ubo_light_indices_) return;
+        assert(std::all_of(ids.begin(), ids.end(), [this](const uint32_t id) { return id < light_capacity_; }));
+        assert(ids.size() <= light_capacity_);
 
+        // Место удаляемого источника занимает последний (в буфер попадает только перемещенный элемент)
         auto& active = active_light_ids_;
+        const auto count = active.size();
         for (const auto id : ids) {
-            if (auto it = std::find(active.begin(), active.end(), id); it != active.end()) {
-                active.erase(it);
+            if (id >= light_capacity_ || active_light_slots_[id] == INACTIVE_LIGHT_SLOT) continue;
+            const uint32_t slot = active_light_slots_[id];
+            const uint32_t last = active.back();
+            active_light_slots_[id] = INACTIVE_LIGHT_SLOT;
+            active.pop_back();
+
+            if (last != id) {
+                active[slot] = last;
+                active_light_slots_[last] = slot;
+                vk_ubo_light_indices_->update(slot + 1, last);
             }
         }
 
-        auto* pids = static_cast<LightIndices*>(vk_ubo_light_indices_->mapped_ptr());
-        pids->count = static_cast<uint32_t>(active.size());
-        std::fill_n(pids->indices, MAX_LIGHTS, 0);
-        std::memcpy(pids->indices, active.data(), active.size() * sizeof(uint32_t));
+        // Кол-во обновляется один раз на весь пакет
+        if (active.size() != count) {
+            vk_ubo_light_indices_->update(0, to<uint32_t>(active.size()));
+        }
     }
 
     void Renderer::light_ids_deactivate(const std::vector<uint32_t> &ids) {
@@ -663,10 +1327,254 @@ namespace nasral::rendering
         return engine()->logger();
     }
 
+    Renderer::RecordingContext& Renderer::recording_context(){
+        // Поток записывает вторичный буфер
+        if (active_context_ != nullptr){
+            return *active_context_;
+        }
+
+        // Основной буфер команд текущего кадра
+        const auto frame_index = current_frame_ % static_cast<size_t>(config_.max_frames_in_flight);
+        auto& context = recording_contexts_[0];
+        context.cmd_buffer = vk_command_buffers_[frame_index].get();
+        return context;
+    }
+
+    void Renderer::cmd_bind_mesh(RecordingContext& context, const Handles::Mesh& handles) const{
+        // Привязать буферы вершин и индексов (если они отличаются от текущих)
+        if (context.vertex_buffer != handles.vertex_buffer){
+            context.cmd_buffer.bindVertexBuffers(0, {handles.vertex_buffer}, {0});
+            context.vertex_buffer = handles.vertex_buffer;
+            context.stats.vertex_buffer_binds++;
+
+            // Параметры восстановления квантованных положений (push constant после индексов материала и объекта)
+            if (handles.vertex_format == VertexFormat::ePackedQuantized){
+                const auto& ul = vk_uniform_layouts_[to<size_t>(UniformLayoutType::eBasicRasterization)];
+                const std::array<glm::vec4, 2> pos_decode = {handles.pos_offset, handles.pos_scale};
+                context.cmd_buffer.pushConstants(
+                    ul->vk_pipeline_layout(),
+                    vk::ShaderStageFlagBits::eVertex|vk::ShaderStageFlagBits::eFragment,
+                    sizeof(glm::vec4),
+                    sizeof(pos_decode),
+                    pos_decode.data());
+            }
+        }else{
+            context.stats.vertex_buffer_binds_saved++;
+        }
+
+        if (context.index_buffer != handles.index_buffer){
+            context.cmd_buffer.bindIndexBuffer(handles.index_buffer, 0, handles.index_type);
+            context.index_buffer = handles.index_buffer;
+        }
+    }
+
+    void Renderer::build_indirect_batches(){
+        indirect_batches_.clear();
+
+        // Области буферов текущего кадра
+        const auto frame_index = current_frame_ % static_cast<size_t>(config_.max_frames_in_flight);
+        const auto frame_base = to<uint32_t>(frame_index) * draw_capacity_;
+        auto* commands = static_cast<vk::DrawIndexedIndirectCommand*>(vk_indirect_commands_->mapped_ptr()) + frame_base;
+        auto* counts = static_cast<uint32_t*>(vk_indirect_counts_->mapped_ptr()) + frame_base;
+        auto* instances = static_cast<uint32_t*>(vk_ubo_instance_indices_->mapped_ptr());
+
+        // При отсечении на GPU экземпляры команд заполняет вычислительный проход (по кандидатам)
+        const bool gpu_culling = gpu_culler_ && gpu_culler_->is_ready();
+        auto* candidates = gpu_culling ? gpu_culler_->candidates(frame_index) : nullptr;
+        uint32_t candidate_count = 0;
+
+        // Кластеры геометрии отсекаются отдельным вычислительным проходом (кандидаты - объекты отрезков с кластерами)
+        const bool meshlet_culling = gpu_culling && config_.meshlet_culling && gpu_culler_->is_meshlet_culling_ready();
+        auto* meshlet_candidates = meshlet_culling ? gpu_culler_->meshlet_candidates(frame_index) : nullptr;
+        uint32_t meshlet_candidate_count = 0;
+        meshlet_batches_.clear();
+
+        uint32_t command_count = 0;
+        for (size_t i = 0; i < render_queue_.size();){
+            const auto& packet = render_queue_.packet(i);
+
+            // Отрезок соседних пакетов с общим материалом и геометрией
+            size_t end = i + 1;
+            while (end < render_queue_.size() && render_queue_.packet(end).shares_state(packet)) ++end;
+
+            IndirectBatch batch{};
+            batch.first_packet = to<uint32_t>(i);
+            batch.packet_count = to<uint32_t>(end - i);
+            batch.first_command = command_count;
+
+            // Отрезок с кластерами полного уровня детализации: вычислительный проход дописывает видимые кластеры
+            // всех объектов отрезка в его команды (команда на кластер), кол-во команд - в счетчике отрезка.
+            // Емкость отрезка не должна вытеснять команды оставшихся пакетов (иначе отсекаются только объекты)
+            const auto meshlet_capacity = batch.packet_count * packet.mesh.meshlet_count;
+            const bool meshlets = meshlet_culling
+                && packet.material.instanced
+                && packet.mesh.meshlet_count > 0
+                && packet.mesh.lod == 0
+                && meshlet_batches_.size() < MAX_MESHLET_BATCHES
+                && command_count + meshlet_capacity + (render_queue_.size() - end) <= draw_capacity_
+                && meshlet_candidate_count + batch.packet_count <= draw_capacity_;
+
+            if (meshlets){
+                GpuCuller::MeshletBatch meshlet_batch{};
+                meshlet_batch.meshlet_buffer = packet.mesh.meshlet_buffer;
+                meshlet_batch.meshlet_count = packet.mesh.meshlet_count;
+                meshlet_batch.first_candidate = meshlet_candidate_count;
+                meshlet_batch.candidate_count = batch.packet_count;
+                meshlet_batch.first_command = command_count;
+                meshlet_batch.command_capacity = meshlet_capacity;
+                meshlet_batches_.push_back(meshlet_batch);
+
+                for (uint32_t k = 0; k < batch.packet_count; ++k){
+                    meshlet_candidates[meshlet_candidate_count++] = {render_queue_.packet(i + k).obj_index, frame_base + command_count};
+                }
+
+                // Без кол-ва команд из буфера рисуется вся емкость отрезка (команды за счетчиком - без экземпляров)
+                if (!vk_device_->optional_features().draw_indirect_count){
+                    std::fill_n(commands + command_count, meshlet_capacity, vk::DrawIndexedIndirectCommand());
+                }
+
+                batch.command_count = meshlet_capacity;
+                counts[batch.first_command] = 0;
+                command_count += batch.command_count;
+
+                indirect_batches_.push_back(batch);
+                i = end;
+                continue;
+            }
+
+            // Для instanced-материала отрезок описывается одной командой, индексы объектов - в области экземпляров
+            // Геометрия каждой сетки хранится в отдельных буферах, поэтому пакет содержит команды одной сетки
+            // При переполнении рисуются поместившиеся экземпляры (остальные учитываются курсором в статистике кадра)
+            if (packet.material.instanced){
+                const auto offset = instance_cursor_.fetch_add(batch.packet_count, std::memory_order_relaxed);
+                const auto fitting = offset < draw_capacity_ ? std::min(batch.packet_count, draw_capacity_ - offset) : 0u;
+                if (fitting > 0){
+                    const auto first_instance = frame_base + offset;
+                    for (uint32_t k = 0; k < fitting; ++k){
+                        if (gpu_culling){
+                            candidates[candidate_count++] = {render_queue_.packet(i + k).obj_index, frame_base + command_count};
+                        }else{
+                            instances[first_instance + k] = render_queue_.packet(i + k).obj_index;
+                        }
+                    }
+
+                    commands[command_count] = vk::DrawIndexedIndirectCommand()
+                        .setIndexCount(packet.mesh.index_count)
+                        .setInstanceCount(gpu_culling ? 0 : fitting)
+                        .setFirstIndex(packet.mesh.first_index)
+                        .setVertexOffset(0)
+                        .setFirstInstance(first_instance);
+
+                    batch.command_count = 1;
+                    counts[batch.first_command] = batch.command_count;
+                    command_count += batch.command_count;
+                }
+            }
+
+            indirect_batches_.push_back(batch);
+            i = end;
+        }
+
+        if (gpu_culler_){
+            gpu_culler_->set_frame_candidates(frame_index, candidate_count, gpu_culling ? command_count : 0, meshlet_batches_);
+        }
+    }
+
+    void Renderer::build_light_clusters(const size_t frame_index){
+        if (!config_.clustered_lighting || !vk_light_clusters_) return;
+
+        // Активные источники распределяются по кластерам основной камеры
+        {
+            std::lock_guard lock(light_ids_mutex_);
+            const auto resolution = get_rendering_resolution();
+            light_clusterer_.build(
+                active_light_ids_,
+                camera_view_,
+                camera_projection_,
+                glm::uvec2(resolution.width, resolution.height),
+                config_.use_opengl_style);
+        }
+
+        // Область кадра не используется GPU (кадр с этим индексом завершен)
+        auto* region = static_cast<uint8_t*>(vk_light_clusters_->mapped_ptr()) + light_clusters_region_ * frame_index;
+        light_clusterer_.write(region);
+    }
+
+    void Renderer::collect_frame_stats(){
+        FrameStats stats{};
+        stats.frame = current_frame_;
+
+        // Свести статистику всех контекстов записи и сбросить её для следующего кадра
+        for (auto& context : recording_contexts_){
+            stats.draw_calls += context.stats.draw_calls;
+            stats.instances += context.stats.instances;
+            stats.indirect_commands += context.stats.indirect_commands;
+            stats.command_buffers += context.stats.command_buffers;
+            stats.pipeline_binds += context.stats.pipeline_binds;
+            stats.pipeline_binds_saved += context.stats.pipeline_binds_saved;
+            stats.vertex_buffer_binds += context.stats.vertex_buffer_binds;
+            stats.vertex_buffer_binds_saved += context.stats.vertex_buffer_binds_saved;
+            stats.record_time_ms += context.stats.record_time_ms;
+            stats.uniform_bytes_uploaded += context.stats.uniform_bytes_uploaded;
+            stats.triangles_queued += context.stats.triangles_queued;
+            stats.descriptor_writes += context.stats.descriptor_writes;
+            stats.descriptor_updates += context.stats.descriptor_updates;
+            context.stats = {};
+        }
+
+        // Экземпляры, не поместившиеся в область кадра (область вырастет в начале следующего кадра)
+        const auto instances_requested = instance_cursor_.load(std::memory_order_relaxed);
+        stats.instances_overflow = instances_requested > draw_capacity_ ? instances_requested - draw_capacity_ : 0;
+
+        // Статистика отсечения (выполняется до записи кадра)
+        if (config_.frustum_culling){
+            const auto& cull_stats = frustum_culler_.stats();
+            stats.objects_visible = cull_stats.visible;
+            stats.objects_culled = cull_stats.culled;
+            stats.cull_time_ms = cull_stats.cull_time_ms;
+        }
+
+        // Статистика отсечения на GPU (результат последнего завершенного кадра с текущим индексом)
+        if (gpu_culler_){
+            stats.gpu_cull_candidates = gpu_culler_->stats().candidates;
+            stats.gpu_cull_visible = gpu_culler_->stats().visible;
+            stats.meshlets_tested = gpu_culler_->stats().meshlets_tested;
+            stats.meshlets_visible = gpu_culler_->stats().meshlets_visible;
+        }
+
+        // Статистика кластеров освещения (построены в начале кадра)
+        if (config_.clustered_lighting){
+            const auto& cluster_stats = light_clusterer_.stats();
+            stats.light_assignments = cluster_stats.assignments;
+            stats.lights_per_cluster_max = cluster_stats.max_per_cluster;
+            stats.light_cluster_time_ms = cluster_stats.build_time_ms;
+        }
+
+        // Время GPU последнего кадра с прочитанными замерами (первая область - весь буфер команд кадра)
+        if (gpu_profiler_ && !gpu_profiler_->timings().empty()){
+            stats.gpu_time_ms = gpu_profiler_->timings().front().time_ms;
+        }
+
+        frame_stats_ = stats;
+    }
+
     void Renderer::init_vk_instance()
     {
-        // Требуемые расширения и слои
-        std::vector<const char*> req_extensions = config_.surface_provider->surface_extensions();
+        // Без поверхности рендеринг возможен только в режиме headless
+        if (!config_.headless && !config_.surface_provider){
+            throw std::runtime_error("Surface provider is required (or headless mode must be enabled)");
+        }
+
+        // В режиме headless целевое разрешение должно быть задано явно
+        if (config_.headless && !config_.rendering_resolution.has_value()){
+            throw std::runtime_error("Rendering resolution is required in headless mode");
+        }
+
+        // Требуемые расширения и слои (расширения поверхности не нужны в режиме headless)
+        std::vector<const char*> req_extensions = {};
+        if (!config_.headless){
+            req_extensions = config_.surface_provider->surface_extensions();
+        }
         std::vector<const char*> req_layers = {};
 
         // Если нужна валидация
@@ -725,36 +1633,98 @@ namespace nasral::rendering
 
     void Renderer::init_vk_device(){
         assert(vk_instance_);
-        assert(vk_surface_);
+        assert(vk_surface_ || config_.headless);
 
-        // Требуемые расширения (поддержка своп-чейна и выделенных аллокаций памяти)
-        const std::vector req_extensions{
-            VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+        // Требуемые расширения (поддержка выделенных аллокаций памяти, своп-чейна при наличии поверхности)
+        std::vector req_extensions{
             VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME,
             VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME
         };
 
+        if (!config_.headless){
+            req_extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        }
+
         // Требования к очередям
         // Первая группа содержит 2 графические очереди (рендеринг и операции загрузки текстур)
         // Вторая группа содержит 1 очередь команд переноса данных (загрузка ресурсов)
         std::vector<vk::utils::Device::QueueGroupRequest> req_queues(to<size_t>(CommandGroup::TOTAL));
-        req_queues[to<size_t>(CommandGroup::eGraphicsAndPresent)] = vk::utils::Device::QueueGroupRequest::graphics(2, true),
-        req_queues[to<size_t>(CommandGroup::eTransfer)] = vk::utils::Device::QueueGroupRequest::transfer(1),
+        req_queues[to<size_t>(CommandGroup::eGraphicsAndPresent)] = vk::utils::Device::QueueGroupRequest::graphics(2, !config_.headless);
+        req_queues[to<size_t>(CommandGroup::eTransfer)] = vk::utils::Device::QueueGroupRequest::transfer(1);
 
         // Создать устройство
+        // В режиме headless допускаются интегрированные и программные (CPU) устройства
         vk_device_ = std::make_unique<vk::utils::Device>(
             vk_instance_,
             vk_surface_,
             req_queues,
-            req_extensions);
+            req_extensions,
+            config_.headless,
+            config_.headless);
+
+        // Непрямая отрисовка использует ненулевой firstInstance (области индексов экземпляров кадров)
+        if (config_.indirect_draws && !vk_device_->optional_features().draw_indirect_first_instance){
+            logger()->warning("Vulkan: Indirect draws require drawIndirectFirstInstance. Falling back to direct draws.");
+            config_.indirect_draws = false;
+        }
+
+        // Отсечение на GPU заполняет команды непрямой отрисовки
+        if (config_.gpu_culling && !config_.indirect_draws){
+            logger()->warning("Vulkan: GPU culling requires indirect draws. GPU culling disabled.");
+            config_.gpu_culling = false;
+        }
+    }
+
+    void Renderer::init_vk_pipeline_cache(){
+        assert(vk_device_);
+
+        // Данные кеша, сохраненные прошлым запуском
+        std::vector<char> data;
+        if (!config_.pipeline_cache_file.empty()){
+            std::ifstream file(config_.pipeline_cache_file, std::ios::binary);
+            if (file.is_open()){
+                data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            }
+        }
+
+        // Данные пригодны, только если созданы тем же устройством и драйвером (заголовок кеша)
+        if (!data.empty()){
+            VkPipelineCacheHeaderVersionOne header{};
+            bool compatible = data.size() >= sizeof(header);
+            if (compatible){
+                std::memcpy(&header, data.data(), sizeof(header));
+                const auto properties = vk_device_->physical_device().getProperties();
+                compatible = header.headerSize >= sizeof(header)
+                    && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+                    && header.vendorID == properties.vendorID
+                    && header.deviceID == properties.deviceID
+                    && std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+            }
+
+            if (!compatible){
+                logger()->warning("Vulkan: Pipeline cache file is incompatible with current device or driver. Ignoring it.");
+                data.clear();
+            }
+        }
+
+        vk_pipeline_cache_ = vk_device_->logical_device().createPipelineCacheUnique(
+            vk::PipelineCacheCreateInfo()
+            .setInitialDataSize(data.size())
+            .setPInitialData(data.empty() ? nullptr : data.data()));
+
+        pipeline_cache_warm_ = !data.empty();
     }
 
     void Renderer::init_vk_render_passes(){
         assert(vk_instance_);
-        assert(vk_surface_);
+        assert(vk_surface_ || config_.headless);
         assert(vk_device_);
 
-        if (!vk_device_->supports_color(config_.color_format, vk_surface_)){
+        const bool color_supported = config_.headless
+            ? vk_device_->supports_color_attachment(config_.color_format)
+            : vk_device_->supports_color(config_.color_format, vk_surface_);
+
+        if (!color_supported){
             throw std::runtime_error("Color format is not supported by the device");
         }
 
@@ -791,7 +1761,9 @@ namespace nasral::rendering
             .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)              // Трафарет не используем (цветовое вложение)
             .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)            // Трафарет не используем (цветовое вложение)
             .setInitialLayout(vk::ImageLayout::eUndefined)                  // Изначального макета памяти еще нет
-            .setFinalLayout(vk::ImageLayout::ePresentSrcKHR)                // В конце - отправка на экран (один под-проход)
+            .setFinalLayout(config_.headless                                // В конце - отправка на экран (один под-проход)
+                ? vk::ImageLayout::eTransferSrcOptimal                      // либо копирование (headless, без показа)
+                : vk::ImageLayout::ePresentSrcKHR)
         );
 
         // Глубина/трафарет
@@ -800,7 +1772,9 @@ namespace nasral::rendering
             .setFormat(config_.depth_stencil_format)
             .setSamples(vk::SampleCountFlagBits::e1)                        // Без multisampling (1 семпл)
             .setLoadOp(vk::AttachmentLoadOp::eClear)                        // Очистка вложение в начале под-прохода
-            .setStoreOp(vk::AttachmentStoreOp::eDontCare)                   // Хранить для показа не нужно (не показываем)
+            .setStoreOp(config_.gpu_culling                                 // Хранить для показа не нужно (не показываем),
+                ? vk::AttachmentStoreOp::eStore                             // но по глубине строится пирамида для отсечения на GPU
+                : vk::AttachmentStoreOp::eDontCare)
             .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)              // Трафарет не используем (только глубина)
             .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)            // Трафарет не используем (только глубина)
             .setInitialLayout(vk::ImageLayout::eUndefined)                  // Изначального макета памяти еще нет
@@ -853,11 +1827,29 @@ namespace nasral::rendering
             .setDstSubpass(VK_SUBPASS_EXTERNAL)                                   // Целевой (внешний)
             .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)   // Этап ожидания операций (вывод)
             .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)          // Операции записи
-            .setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)   // Этап выполнения операций целевого под-прохода
-            .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentRead)           // Операции чтения (swap chain)
+            .setDstStageMask(config_.headless                                     // Этап выполнения операций целевого под-прохода
+                ? vk::PipelineStageFlagBits::eTransfer
+                : vk::PipelineStageFlagBits::eColorAttachmentOutput)
+            .setDstAccessMask(config_.headless                                    // Операции чтения (swap chain либо копирование)
+                ? vk::AccessFlagBits::eTransferRead
+                : vk::AccessFlagBits::eColorAttachmentRead)
             .setDependencyFlags(vk::DependencyFlagBits::eByRegion)                // Синхронизация (по региону)
         );
 
+        // Глубина прошлого кадра читается при построении пирамиды - очистка ждет завершения чтения
+        if (config_.gpu_culling){
+            subpass_dependencies.push_back(
+                vk::SubpassDependency()
+                .setSrcSubpass(VK_SUBPASS_EXTERNAL)                               // Исходный под-проход (внешний)
+                .setDstSubpass(0)                                                 // Целевой (первый)
+                .setSrcStageMask(vk::PipelineStageFlagBits::eComputeShader)       // Этап ожидания операций (построение пирамиды)
+                .setSrcAccessMask(vk::AccessFlagBits::eNone)                      // Только зависимость исполнения (чтение)
+                .setDstStageMask(vk::PipelineStageFlagBits::eEarlyFragmentTests   // Этапы операций с глубиной
+                    | vk::PipelineStageFlagBits::eLateFragmentTests)
+                .setDstAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentWrite) // Запись глубины (очистка)
+            );
+        }
+
         // Создать проход
         vk_render_pass_ = vk_device_->logical_device().createRenderPassUnique(
             vk::RenderPassCreateInfo()
@@ -971,6 +1963,7 @@ namespace nasral::rendering
             vk::utils::Framebuffer::AttachmentInfo depth{};
             depth.format = config_.depth_stencil_format;
             depth.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+            if (config_.gpu_culling) depth.usage |= vk::ImageUsageFlagBits::eSampled;
             depth.aspect = vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
             attachments.push_back(depth);
 
@@ -983,6 +1976,47 @@ namespace nasral::rendering
         }
     }
 
+    void Renderer::init_vk_offscreen_framebuffers(){
+        assert(vk_instance_);
+        assert(vk_device_);
+        assert(config_.rendering_resolution.has_value());
+
+        // Размеры кадрового буфера задаются конфигурацией (поверхности нет)
+        const auto& resolution = config_.rendering_resolution.value();
+        const vk::Extent2D extent(resolution.x, resolution.y);
+
+        // Кольцо внеэкранных кадровых буферов (по одному на каждый активный кадр)
+        for (size_t i = 0; i < config_.max_frames_in_flight; ++i)
+        {
+            // Описать вложения кадрового буфера
+            std::vector<vk::utils::Framebuffer::AttachmentInfo> attachments{};
+
+            // Вложение цвета (изображение создается внутри кадрового буфера, может быть скопировано после кадра)
+            vk::utils::Framebuffer::AttachmentInfo color{};
+            color.format = config_.color_format;
+            color.usage = vk::ImageUsageFlagBits::eColorAttachment
+                | vk::ImageUsageFlagBits::eSampled
+                | vk::ImageUsageFlagBits::eTransferSrc;
+            color.aspect = vk::ImageAspectFlagBits::eColor;
+            attachments.push_back(color);
+
+            // Вложение глубины-трафарета (создается внутри кадрового буфера)
+            vk::utils::Framebuffer::AttachmentInfo depth{};
+            depth.format = config_.depth_stencil_format;
+            depth.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+            if (config_.gpu_culling) depth.usage |= vk::ImageUsageFlagBits::eSampled;
+            depth.aspect = vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+            attachments.push_back(depth);
+
+            // Создать и добавить кадровый буфер
+            vk_framebuffers_.emplace_back(std::make_unique<vk::utils::Framebuffer>(
+                vk_device_,
+                vk_render_pass_.get(),
+                extent,
+                attachments));
+        }
+    }
+
     void Renderer::init_vk_uniform_layouts(){
         assert(vk_instance_);
         assert(vk_device_);
@@ -993,9 +2027,34 @@ namespace nasral::rendering
         // Для шейдеров, которые не используют uniform блоки
         layouts[to<size_t>(UniformLayoutType::eDummy)] = std::make_unique<vk::utils::UniformLayout>(vk_device_);
 
+        // Глобальная таблица текстур заполняется частично, при поддержке элементы записываются и после привязки набора,
+        // в том числе во время исполнения кадров (новые элементы не используются активными кадрами).
+        // Размер таблицы ограничен возможностями устройства
+        const auto& features = vk_device_->optional_features();
+        const bool update_after_bind = features.sampled_image_update_after_bind;
+        texture_writes_concurrent_ = update_after_bind && features.update_unused_while_pending;
+
+        vk::DescriptorBindingFlagsEXT texture_binding_flags = vk::DescriptorBindingFlagBitsEXT::ePartiallyBound;
+        if (update_after_bind){
+            texture_binding_flags |= vk::DescriptorBindingFlagBitsEXT::eUpdateAfterBind;
+        }
+        if (texture_writes_concurrent_){
+            texture_binding_flags |= vk::DescriptorBindingFlagBitsEXT::eUpdateUnusedWhilePending;
+        }
+        {
+            auto indexing_properties = vk::PhysicalDeviceDescriptorIndexingPropertiesEXT().setPNext(nullptr);
+            auto properties2 = vk::PhysicalDeviceProperties2().setPNext(&indexing_properties);
+            vk_device_->physical_device().getProperties2(&properties2);
+
+            const auto max_textures = update_after_bind
+                ? indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages
+                : properties2.properties.limits.maxPerStageDescriptorSampledImages;
+            config_.texture_table_size = std::clamp(config_.texture_table_size, 1u, max_textures);
+        }
+
         // Для шейдеров базовой растеризации (камера, объекты, текстуры)
         std::vector<vk::utils::UniformLayout::SetLayoutInfo> set_layouts = {
-            // set = 0: Camera
+            // set = 0: Camera (по набору на каждый активный кадр)
             {
                 {
                     {
@@ -1005,89 +2064,52 @@ namespace nasral::rendering
                         vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment
                     }
                 },
-                1
+                config_.max_frames_in_flight
             },
-            // set = 1: Objects
+            // set = 1: Objects (по набору на каждый активный кадр)
             {
                 {
                     // Матрицы трансформации всех объектов
                     {0,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eVertex},
+                    // Индексы объектов для instanced-отрисовки
+                    {1,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eVertex},
                 },
-                1
+                config_.max_frames_in_flight
             },
-            // set = 2: Material settings
+            // set = 2: Material settings (по набору на каждый активный кадр)
             {
                 {
                     // Параметры Phong материала для всех объектов
                     {0,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eFragment},
                     // Параметры PBR материала для всех объектов
                     {1,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eFragment},
+                    // Индексы текстур и семплеров для всех материалов
+                    {2,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eFragment},
                 },
-                1
+                config_.max_frames_in_flight
             },
-            // set = 3: Material textures
+            // set = 3: Material textures (глобальная таблица текстур, общая для всех материалов)
             {
                 {
-                    // Текстуры albedo/diffuse для всех материалов (Phong/PBR материал)
-                    {
-                        to<uint32_t>(TextureType::eAlbedoColor),
-                        MAX_MATERIALS,
-                        vk::DescriptorType::eCombinedImageSampler,
-                        vk::ShaderStageFlagBits::eFragment,
-                        vk::DescriptorBindingFlagBitsEXT::ePartiallyBound
-                    },
-                    // Текстуры normal для всех материалов (Phong/PBR материал)
-                    {
-                        to<uint32_t>(TextureType::eNormal),
-                        MAX_MATERIALS,
-                        vk::DescriptorType::eCombinedImageSampler,
-                        vk::ShaderStageFlagBits::eFragment,
-                        vk::DescriptorBindingFlagBitsEXT::ePartiallyBound
-                    },
-                    // Текстуры roughness/specular для всех материалов (Phong/PBR материал)
-                    {
-                        to<uint32_t>(TextureType::eRoughnessOrSpecular),
-                        MAX_MATERIALS,
-                        vk::DescriptorType::eCombinedImageSampler,
-                        vk::ShaderStageFlagBits::eFragment,
-                        vk::DescriptorBindingFlagBitsEXT::ePartiallyBound
-                    },
-                    // Текстуры displace для всех материалов (Phong/PBR материал)
-                    {
-                        to<uint32_t>(TextureType::eHeight),
-                        MAX_MATERIALS,
-                        vk::DescriptorType::eCombinedImageSampler,
-                        vk::ShaderStageFlagBits::eFragment,
-                        vk::DescriptorBindingFlagBitsEXT::ePartiallyBound
-                    },
-                    // Текстуры metallic для всех материалов (Phong/PBR материал)
-                    {
-                        to<uint32_t>(TextureType::eMetallicOrReflection),
-                        MAX_MATERIALS,
-                        vk::DescriptorType::eCombinedImageSampler,
-                        vk::ShaderStageFlagBits::eFragment,
-                        vk::DescriptorBindingFlagBitsEXT::ePartiallyBound
-                    },
-                    // Текстуры ambient occlusion для всех материалов (PBR материал)
+                    // Изображения текстур (индекс в таблице - из параметров текстур материала)
                     {
-                        to<uint32_t>(TextureType::eAmbientOcclusion),
-                        MAX_MATERIALS,
-                        vk::DescriptorType::eCombinedImageSampler,
+                        0,
+                        config_.texture_table_size,
+                        vk::DescriptorType::eSampledImage,
                         vk::ShaderStageFlagBits::eFragment,
-                        vk::DescriptorBindingFlagBitsEXT::ePartiallyBound
+                        texture_binding_flags
                     },
-                    // Текстуры emission для всех материалов (PBR материал)
+                    // Семплеры текстур (индекс - тип семплера)
                     {
-                        to<uint32_t>(TextureType::eEmission),
-                        MAX_MATERIALS,
-                        vk::DescriptorType::eCombinedImageSampler,
-                        vk::ShaderStageFlagBits::eFragment,
-                        vk::DescriptorBindingFlagBitsEXT::ePartiallyBound
+                        1,
+                        to<uint32_t>(TextureSamplerType::TOTAL),
+                        vk::DescriptorType::eSampler,
+                        vk::ShaderStageFlagBits::eFragment
                     },
                 },
-                1
+                texture_writes_concurrent_ ? 1 : config_.max_frames_in_flight
             },
-            // set = 4: Light sources
+            // set = 4: Light sources (по набору на каждый активный кадр)
             {
                 {
                     // Источники света (параметры источников)
@@ -1103,18 +2125,25 @@ namespace nasral::rendering
                         1,
                         vk::DescriptorType::eStorageBuffer,
                         vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment
+                    },
+                    // Кластеры источников (отрезки индексов источников каждого кластера пространства вида)
+                    {
+                        2,
+                        1,
+                        vk::DescriptorType::eStorageBuffer,
+                        vk::ShaderStageFlagBits::eFragment
                     }
                 },
-                1
+                config_.max_frames_in_flight
             }
         };
 
         // Push-константы layout'а растеризации
         std::vector push_constants{
-            // Индекс объекта и индекс используемого материала
+            // Индекс объекта, индекс используемого материала и восстановление квантованных положений (со смещения 16)
             vk::PushConstantRange()
                 .setStageFlags(vk::ShaderStageFlagBits::eVertex|vk::ShaderStageFlagBits::eFragment)
-                .setSize(sizeof(uint32_t) * 2)
+                .setSize(sizeof(glm::vec4) * 3)
                 .setOffset(0)
         };
 
@@ -1123,6 +2152,66 @@ namespace nasral::rendering
             vk_device_,
             set_layouts,
             push_constants);
+
+        // Для вычислительных shader'ов отсечения на GPU (отсечение и построение пирамиды глубины)
+        std::vector<vk::utils::UniformLayout::SetLayoutInfo> culling_set_layouts = {
+            // set = 0: Culling (по набору на каждый активный кадр)
+            {
+                {
+                    // Параметры отсечения кадра (матрицы, плоскости, размеры пирамиды)
+                    {0,1, vk::DescriptorType::eUniformBuffer, vk::ShaderStageFlagBits::eCompute},
+                    // Матрицы трансформации всех объектов
+                    {1,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute},
+                    // Ограничивающие сферы всех объектов
+                    {2,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute},
+                    // Кандидаты на отсечение
+                    {3,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute},
+                    // Команды непрямой отрисовки
+                    {4,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute},
+                    // Индексы объектов экземпляров
+                    {5,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute},
+                    // Пирамида глубины
+                    {6,1, vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eCompute},
+                    // Кандидаты на отсечение кластеров
+                    {7,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute},
+                    // Кол-во команд непрямой отрисовки
+                    {8,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute},
+                },
+                config_.max_frames_in_flight
+            },
+            // set = 1: Depth pyramid (по набору на каждый кадровый буфер и уровень пирамиды)
+            {
+                {
+                    // Исходный уровень (глубина кадра либо предыдущий уровень)
+                    {0,1, vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eCompute},
+                    // Целевой уровень
+                    {1,1, vk::DescriptorType::eStorageImage, vk::ShaderStageFlagBits::eCompute},
+                },
+                64
+            },
+            // set = 2: Meshlets (по набору на каждый пакет с кластерами в каждом активном кадре)
+            {
+                {
+                    // Кластеры mesh'а пакета
+                    {0,1, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eCompute},
+                },
+                MAX_MESHLET_BATCHES * config_.max_frames_in_flight
+            }
+        };
+
+        // Push-константы layout'а отсечения (параметры вызова - кол-во кандидатов и кластеров, размеры уровней)
+        std::vector culling_push_constants{
+            vk::PushConstantRange()
+                .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+                .setSize(sizeof(uint32_t) * 8)
+                .setOffset(0)
+        };
+
+        // Создать pipeline layout для отсечения на GPU
+        layouts[to<size_t>(UniformLayoutType::eGpuCulling)] = std::make_unique<vk::utils::UniformLayout>(
+            vk_device_,
+            culling_set_layouts,
+            culling_push_constants);
     }
 
     void Renderer::init_vk_texture_samplers(){
@@ -1246,16 +2335,20 @@ namespace nasral::rendering
         const auto& ul = vk_uniform_layouts_[to<size_t>(UniformLayoutType::eBasicRasterization)];
         assert(ul);
 
-        // Выделить дескрипторный набор для камеры
-        ul->allocate_sets(0,1).front().swap(vk_dset_view_);
-        // Выделить дескрипторный набор для uniform-буферов объектов (трансформации)
-        ul->allocate_sets(1,1).front().swap(vk_dset_objects_uniforms_);
-        // Выделить дескрипторный набор для uniform-буферов материалов (блики, шероховатость и прочее)
-        ul->allocate_sets(2,1).front().swap(vk_dset_material_uniforms_);
-        // Выделить дескрипторный набор для текстур материалов (по массиву дескрипторов на каждый вид текстур)
-        ul->allocate_sets(3,1).front().swap(vk_dset_material_textures_);
-        // Выделить дескрипторный набор для источников света
-        ul->allocate_sets(4,1).front().swap(vk_dset_light_sources_);
+        // Кол-во активных кадров (наборы и области буферов выделяются для каждого из них)
+        const auto frames = config_.max_frames_in_flight;
+
+        // Выделить дескрипторные наборы для камеры
+        vk_dsets_view_ = ul->allocate_sets(0, frames);
+        // Выделить дескрипторные наборы для uniform-буферов объектов (трансформации)
+        vk_dsets_objects_uniforms_ = ul->allocate_sets(1, frames);
+        // Выделить дескрипторные наборы для uniform-буферов материалов (блики, шероховатость и прочее)
+        vk_dsets_material_uniforms_ = ul->allocate_sets(2, frames);
+        // Выделить дескрипторные наборы глобальной таблицы текстур (изображения по индексу текстуры и семплеры).
+        // Без записи во время исполнения кадров - по набору на каждый активный кадр
+        vk_dsets_material_textures_ = ul->allocate_sets(3, texture_writes_concurrent_ ? 1 : frames);
+        // Выделить дескрипторные наборы для источников света
+        vk_dsets_light_sources_ = ul->allocate_sets(4, frames);
 
         // Uniform буферы
         {
@@ -1271,161 +2364,463 @@ namespace nasral::rendering
                 .limits
                 .minStorageBufferOffsetAlignment;
 
+            // Данные, изменяемые CPU, хранятся в кольцевых буферах (по области на каждый активный кадр).
+            // Шаг элементов совпадает с шагом массивов std430, выравниваются только начала областей кадров.
+            // Крупные массивы, читаемые GPU каждый кадр, могут находиться в памяти устройства
+            const bool device_local = config_.device_local_uniforms;
+
             // Выделить uniform буфер для камеры (вид, проекция)
-            vk_ubo_view_ = std::make_unique<vk::utils::Buffer>(
-                vk_device_,
-                size_align(sizeof(CameraUniforms), ubo_alignment),
+            vk_ubo_view_ = std::make_unique<FrameRingBuffer>(
+                this,
+                sizeof(CameraUniforms),
+                1,
+                frames,
                 vk::BufferUsageFlagBits::eUniformBuffer,
-                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+                ubo_alignment);
 
             // Выделить uniform буфер для трансформаций объектов сцены
-            vk_ubo_objects_transforms_ = std::make_unique<vk::utils::Buffer>(
-                vk_device_,
-                size_align(sizeof(ObjectTransformUniforms), sbo_alignment) * MAX_OBJECTS,
+            vk_ubo_objects_transforms_ = std::make_unique<FrameRingBuffer>(
+                this,
+                sizeof(ObjectTransformUniforms),
+                object_capacity_,
+                frames,
                 vk::BufferUsageFlagBits::eStorageBuffer,
-                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+                sbo_alignment,
+                device_local);
+
+            // Выделить storage буфер для ограничивающих сфер объектов (в пространстве модели, для отсечения на GPU)
+            vk_ubo_objects_bounds_ = std::make_unique<FrameRingBuffer>(
+                this,
+                sizeof(glm::vec4),
+                object_capacity_,
+                frames,
+                vk::BufferUsageFlagBits::eStorageBuffer,
+                sbo_alignment,
+                device_local);
 
             // Выделить uniform буфер для параметров материала (Blin-Phong)
-            vk_ubo_materials_phong_ = std::make_unique<vk::utils::Buffer>(
-                vk_device_,
-                size_align(sizeof(MaterialPhongUniforms), sbo_alignment) * MAX_MATERIALS,
+            vk_ubo_materials_phong_ = std::make_unique<FrameRingBuffer>(
+                this,
+                sizeof(MaterialPhongUniforms),
+                material_capacity_,
+                frames,
                 vk::BufferUsageFlagBits::eStorageBuffer,
-                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+                sbo_alignment,
+                device_local);
 
             // Выделить uniform буфер для параметров материала (PBR)
-            vk_ubo_materials_pbr_ = std::make_unique<vk::utils::Buffer>(
-                vk_device_,
-                size_align(sizeof(MaterialPbrUniforms), sbo_alignment) * MAX_MATERIALS,
+            vk_ubo_materials_pbr_ = std::make_unique<FrameRingBuffer>(
+                this,
+                sizeof(MaterialPbrUniforms),
+                material_capacity_,
+                frames,
                 vk::BufferUsageFlagBits::eStorageBuffer,
-                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+                sbo_alignment,
+                device_local);
+
+            // Выделить storage буфер для индексов текстур материалов (в глобальной таблице) и семплеров
+            vk_ubo_materials_textures_ = std::make_unique<FrameRingBuffer>(
+                this,
+                sizeof(MaterialTextureUniforms),
+                material_capacity_,
+                frames,
+                vk::BufferUsageFlagBits::eStorageBuffer,
+                sbo_alignment,
+                device_local);
 
             // Выделить uniform буфер для источников света
-            vk_ubo_light_sources_ = std::make_unique<vk::utils::Buffer>(
-                vk_device_,
-                size_align(sizeof(LightUniforms), sbo_alignment) * MAX_OBJECTS,
+            vk_ubo_light_sources_ = std::make_unique<FrameRingBuffer>(
+                this,
+                sizeof(LightUniforms),
+                light_capacity_,
+                frames,
                 vk::BufferUsageFlagBits::eStorageBuffer,
-                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-
-            // Выделить uniform буфер для индексов источников
-            vk_ubo_light_indices_ = std::make_unique<vk::utils::Buffer>(
+                sbo_alignment,
+                device_local);
+
+            // Выделить буфер для индексов активных источников (элемент 0 - кол-во, далее индексы)
+            // Элементы обновляются по отдельности, поэтому в области кадров переносятся только измененные
+            vk_ubo_light_indices_ = std::make_unique<FrameRingBuffer>(
+                this,
+                sizeof(uint32_t),
+                light_capacity_ + 1,
+                frames,
+                vk::BufferUsageFlagBits::eStorageBuffer,
+                sbo_alignment);
+
+            // Выделить storage буфер для кластеров освещения (область на каждый активный кадр, заполняется в начале кадра)
+            // Без распределения по кластерам области содержат только заголовок (фрагменты обходят все активные источники)
+            light_clusters_region_ = size_align(
+                config_.clustered_lighting ? LightClusterer::data_size() : sizeof(LightClusterHeader),
+                sbo_alignment);
+            vk_light_clusters_ = std::make_unique<vk::utils::Buffer>(
                 vk_device_,
-                size_align(sizeof(LightIndices), sbo_alignment),
+                light_clusters_region_ * frames,
                 vk::BufferUsageFlagBits::eStorageBuffer,
                 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
         }
 
-        // Связать дескрипторы и буферы
-        std::vector<vk::WriteDescriptorSet> writes;
-        std::vector<vk::DescriptorBufferInfo> buffer_infos;
-        buffer_infos.reserve(6); // ВНИМАНИЕ! Зарезервировать память перед использованием!
-        writes.reserve(6);
+        // Буферы отрисовки (индексы экземпляров, команды непрямой отрисовки)
+        init_vk_draw_buffers();
 
-        // Камера (set = 0, binding = 0)
-        {
-            buffer_infos.emplace_back(vk::DescriptorBufferInfo()
-                .setBuffer(vk_ubo_view_->vk_buffer())
-                .setOffset(0)
-                .setRange(sizeof(CameraUniforms)));
+        // Подготовить буферы к записи (разметка памяти, кольцевые буферы размечены при создании)
+        vk_light_clusters_->map_unsafe();
 
-            writes.emplace_back(vk::WriteDescriptorSet()
-                .setDstSet(vk_dset_view_.get())
-                .setDstBinding(0)
-                .setDstArrayElement(0)
-                .setDescriptorType(vk::DescriptorType::eUniformBuffer)
-                .setDescriptorCount(1)
-                .setPBufferInfo(&buffer_infos.back()));
+        // Заголовки кластеров освещения (кластеры не построены, пока не распределены источники)
+        const LightClusterHeader cluster_header{};
+        for (size_t i = 0; i < frames; ++i){
+            vk_light_clusters_->update_mapped(light_clusters_region_ * i, sizeof(LightClusterHeader), &cluster_header);
         }
 
-        // Трансформации объектов (set = 1, binding = 0)
-        {
-            buffer_infos.emplace_back(vk::DescriptorBufferInfo()
-                .setBuffer(vk_ubo_objects_transforms_->vk_buffer())
-                .setOffset(0)
-                .setRange(sizeof(ObjectTransformUniforms) * MAX_OBJECTS));
+        // Связать дескрипторы и буферы (наборы кадра ссылаются на области кадра в кольцевых буферах)
+        for (size_t i = 0; i < frames; ++i){
+            update_frame_descriptors(i);
+        }
+    }
 
-            writes.emplace_back(vk::WriteDescriptorSet()
-                .setDstSet(vk_dset_objects_uniforms_.get())
+    void Renderer::init_vk_texture_table(){
+        assert(vk_device_);
+        assert(!vk_dsets_material_textures_.empty());
+
+        const auto& vd = vk_device_;
+        auto& cmd_group = vd->queue_group(to<size_t>(CommandGroup::eGraphicsAndPresent));
+        const vk::Extent3D extent{1, 1, 1};
+        const std::array<uint8_t, 4> white = {0xFF, 0xFF, 0xFF, 0xFF};
+
+        // Текстура по умолчанию (белый пиксель) - копируется из промежуточного изображения, как и загружаемые текстуры
+        const auto staging_image = std::make_unique<vk::utils::Image>(vd
+            , vk::utils::Image::Type::e2D
+            , vk::Format::eR8G8B8A8Unorm
+            , extent
+            , vk::ImageUsageFlagBits::eTransferSrc
+            , vk::ImageTiling::eLinear
+            , vk::ImageAspectFlagBits::eColor
+            , vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+            , vk::ImageLayout::ePreinitialized
+            , vk::SampleCountFlagBits::e1
+            , 1
+            , 1);
+
+        vk_fallback_texture_ = std::make_unique<vk::utils::Image>(vd
+            , vk::utils::Image::Type::e2D
+            , vk::Format::eR8G8B8A8Unorm
+            , extent
+            , vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled
+            , vk::ImageTiling::eOptimal
+            , vk::ImageAspectFlagBits::eColor
+            , vk::MemoryPropertyFlagBits::eDeviceLocal
+            , vk::ImageLayout::ePreinitialized
+            , vk::SampleCountFlagBits::e1
+            , 1
+            , 1);
+
+        const auto isl = vd->logical_device().getImageSubresourceLayout(
+            staging_image->image(),
+            {vk::ImageAspectFlagBits::eColor, 0, 0});
+        auto* mem = static_cast<uint8_t*>(staging_image->map(vk::ImageAspectFlagBits::eColor));
+        memcpy(mem + isl.offset, white.data(), white.size());
+        staging_image->unmap();
+        staging_image->copy_to(*vk_fallback_texture_, cmd_group, extent);
+
+        // Элемент 0 таблицы - текстура по умолчанию (не освобождается), остальные индексы свободны
+        texture_views_.assign(config_.texture_table_size, VK_NULL_HANDLE);
+        texture_refs_.assign(config_.texture_table_size, 0);
+        texture_free_ids_.clear();
+        for (uint32_t i = config_.texture_table_size; i > 1; --i){
+            texture_free_ids_.push_back(i - 1);
+        }
+        texture_views_[0] = static_cast<VkImageView>(vk_fallback_texture_->image_view());
+        texture_refs_[0] = 1;
+
+        // Семплеры (индекс - тип семплера) и текстура по умолчанию
+        std::array<vk::DescriptorImageInfo, static_cast<size_t>(TextureSamplerType::TOTAL)> sampler_infos{};
+        for (size_t i = 0; i < sampler_infos.size(); ++i){
+            sampler_infos[i].setSampler(vk_texture_samplers_[i].get());
+        }
+
+        const auto image_info = vk::DescriptorImageInfo()
+            .setImageView(vk_fallback_texture_->image_view())
+            .setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+
+        std::vector<vk::WriteDescriptorSet> writes;
+        for (const auto& dset : vk_dsets_material_textures_){
+            writes.push_back(vk::WriteDescriptorSet()
+                .setDstSet(dset.get())
                 .setDstBinding(0)
                 .setDstArrayElement(0)
-                .setDescriptorType(vk::DescriptorType::eStorageBuffer)
-                .setDescriptorCount(1)
-                .setPBufferInfo(&buffer_infos.back()));
+                .setDescriptorType(vk::DescriptorType::eSampledImage)
+                .setImageInfo(image_info));
+            writes.push_back(vk::WriteDescriptorSet()
+                .setDstSet(dset.get())
+                .setDstBinding(1)
+                .setDstArrayElement(0)
+                .setDescriptorType(vk::DescriptorType::eSampler)
+                .setImageInfo(sampler_infos));
         }
 
-        // Параметры Phong материалов (set = 2, binding = 0)
-        {
-            buffer_infos.emplace_back(vk::DescriptorBufferInfo()
-                .setBuffer(vk_ubo_materials_phong_->vk_buffer())
-                .setOffset(0)
-                .setRange(sizeof(MaterialPhongUniforms) * MAX_MATERIALS));
+        vd->logical_device().updateDescriptorSets(writes, {});
+        texture_frame_writes_.assign(vk_dsets_material_textures_.size(), {});
+    }
 
-            writes.emplace_back(vk::WriteDescriptorSet()
-                .setDstSet(vk_dset_material_uniforms_.get())
+    uint32_t Renderer::texture_id_acquire_unsafe(const Handles::Texture& texture){
+        assert(texture);
+
+        // Текстура уже в таблице (например, общая для нескольких материалов) - новая ссылка на её индекс
+        const auto view = static_cast<VkImageView>(texture.image_view);
+        if (const auto it = texture_ids_.find(view); it != texture_ids_.end()){
+            texture_refs_[it->second]++;
+            return it->second;
+        }
+
+        // Таблица заполнена - используется текстура по умолчанию
+        if (texture_free_ids_.empty()){
+            logger()->warning("Vulkan: Texture table is full (" + std::to_string(config_.texture_table_size) + " textures). Default texture is used.");
+            return 0;
+        }
+
+        const uint32_t id = texture_free_ids_.back();
+        texture_free_ids_.pop_back();
+        texture_ids_.emplace(view, id);
+        texture_views_[id] = view;
+        texture_refs_[id] = 1;
+
+        // Элемент не используется активными кадрами (освобожденные индексы переиспользуются после их завершения)
+        texture_writes_.emplace_back(id, vk::DescriptorImageInfo()
+            .setImageView(texture.image_view)
+            .setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal));
+        return id;
+    }
+
+    void Renderer::texture_id_release_unsafe(const uint32_t id){
+        // Текстура по умолчанию не освобождается
+        if (id == 0) return;
+
+        assert(id < texture_refs_.size());
+        assert(texture_refs_[id] > 0);
+        if (--texture_refs_[id] > 0) return;
+
+        // Индекс может использоваться параметрами материалов в активных кадрах
+        texture_ids_.erase(texture_views_[id]);
+        texture_views_[id] = VK_NULL_HANDLE;
+        retired_texture_ids_.emplace_back(current_frame_ + config_.max_frames_in_flight, id);
+    }
+
+    void Renderer::texture_writes_flush_unsafe(){
+        if (texture_writes_.empty()) return;
+
+        // При записи во время исполнения кадров общий набор обновляется сразу (новые элементы не используются кадрами),
+        // иначе элементы накапливаются для набора каждого кадра и записываются после завершения этого кадра
+        if (texture_writes_concurrent_){
+            write_texture_table(vk_dsets_material_textures_.front().get(), texture_writes_);
+        }else{
+            for (auto& frame_writes : texture_frame_writes_){
+                frame_writes.insert(frame_writes.end(), texture_writes_.begin(), texture_writes_.end());
+            }
+        }
+        texture_writes_.clear();
+    }
+
+    void Renderer::texture_writes_apply_unsafe(const size_t frame_index){
+        if (texture_writes_concurrent_) return;
+
+        assert(frame_index < texture_frame_writes_.size());
+        auto& frame_writes = texture_frame_writes_[frame_index];
+        if (frame_writes.empty()) return;
+
+        write_texture_table(vk_dsets_material_textures_[frame_index].get(), frame_writes);
+        frame_writes.clear();
+    }
+
+    void Renderer::write_texture_table(const vk::DescriptorSet& dset, std::vector<std::pair<uint32_t, vk::DescriptorImageInfo>>& elements){
+        // Элементы по возрастанию индекса, смежные индексы - одна запись с несколькими дескрипторами
+        // (сортировка устойчивая - при повторной записи индекса последней применяется более поздняя)
+        std::stable_sort(elements.begin(), elements.end(), [](const auto& a, const auto& b){
+            return a.first < b.first;
+        });
+
+        std::vector<vk::DescriptorImageInfo> image_infos;
+        image_infos.reserve(elements.size());
+        for (const auto& [id, info] : elements){
+            image_infos.push_back(info);
+        }
+
+        std::vector<vk::WriteDescriptorSet> writes;
+        for (size_t i = 0; i < elements.size();){
+            size_t end = i + 1;
+            while (end < elements.size() && elements[end].first == elements[end - 1].first + 1){
+                ++end;
+            }
+
+            writes.push_back(vk::WriteDescriptorSet()
+                .setDstSet(dset)
                 .setDstBinding(0)
-                .setDstArrayElement(0)
-                .setDescriptorType(vk::DescriptorType::eStorageBuffer)
-                .setDescriptorCount(1)
-                .setPBufferInfo(&buffer_infos.back()));
+                .setDstArrayElement(elements[i].first) // Индекс первой текстуры в таблице
+                .setDescriptorType(vk::DescriptorType::eSampledImage)
+                .setDescriptorCount(to<uint32_t>(end - i))
+                .setPImageInfo(image_infos.data() + i));
+            i = end;
         }
 
-        // Параметры PBR материалов (set = 2, binding = 1)
-        {
-            buffer_infos.emplace_back(vk::DescriptorBufferInfo()
-                .setBuffer(vk_ubo_materials_pbr_->vk_buffer())
-                .setOffset(0)
-                .setRange(sizeof(MaterialPbrUniforms) * MAX_MATERIALS));
+        vk_device_->logical_device().updateDescriptorSets(writes, {});
 
-            writes.emplace_back(vk::WriteDescriptorSet()
-                .setDstSet(vk_dset_material_uniforms_.get())
-                .setDstBinding(1)
-                .setDstArrayElement(0)
-                .setDescriptorType(vk::DescriptorType::eStorageBuffer)
-                .setDescriptorCount(1)
-                .setPBufferInfo(&buffer_infos.back()));
+        auto& stats = recording_contexts_[0].stats;
+        stats.descriptor_writes += to<uint32_t>(elements.size());
+        stats.descriptor_updates++;
+    }
+
+    void Renderer::init_vk_draw_buffers(){
+        const auto frames = config_.max_frames_in_flight;
+
+        // Выделить буферы непрямой отрисовки (команды и их кол-во, область на каждый активный кадр)
+        // Буферы доступны и как storage, чтобы команды могли заполняться вычислительным проходом
+        vk_indirect_commands_ = std::make_unique<vk::utils::Buffer>(
+            vk_device_,
+            sizeof(vk::DrawIndexedIndirectCommand) * draw_capacity_ * frames,
+            vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+        vk_indirect_counts_ = std::make_unique<vk::utils::Buffer>(
+            vk_device_,
+            sizeof(uint32_t) * draw_capacity_ * frames,
+            vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+        // Выделить storage буфер для индексов объектов экземпляров (область на каждый активный кадр и
+        // постоянная область тождественных индексов - для команд, экземпляр которых сразу указывает на объект)
+        vk_ubo_instance_indices_ = std::make_unique<vk::utils::Buffer>(
+            vk_device_,
+            sizeof(uint32_t) * draw_capacity_ * (frames + 1),
+            vk::BufferUsageFlagBits::eStorageBuffer,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+        // Подготовить буферы к записи (разметка памяти)
+        vk_ubo_instance_indices_->map_unsafe();
+        vk_indirect_commands_->map_unsafe();
+        vk_indirect_counts_->map_unsafe();
+
+        // Область тождественных индексов (следует за областями кадров)
+        auto* identity = static_cast<uint32_t*>(vk_ubo_instance_indices_->mapped_ptr()) + draw_capacity_ * frames;
+        for (uint32_t i = 0; i < draw_capacity_; ++i){
+            identity[i] = i;
         }
+    }
 
-        // Источники света (set = 4, binding = 0)
-        {
+    void Renderer::update_frame_descriptors(const size_t frame_index){
+        std::vector<vk::WriteDescriptorSet> writes;
+        std::vector<vk::DescriptorBufferInfo> buffer_infos;
+        buffer_infos.reserve(16); // ВНИМАНИЕ! Зарезервировать память перед использованием!
+        writes.reserve(16);
+
+        const auto write_buffer = [&](const vk::DescriptorSet& set, const uint32_t binding, const vk::DescriptorType type,
+                                      const vk::Buffer& buffer, const vk::DeviceSize offset, const vk::DeviceSize range){
             buffer_infos.emplace_back(vk::DescriptorBufferInfo()
-                .setBuffer(vk_ubo_light_sources_->vk_buffer())
-                .setOffset(0)
-                .setRange(sizeof(LightUniforms) * MAX_LIGHTS));
+                .setBuffer(buffer)
+                .setOffset(offset)
+                .setRange(range));
 
             writes.emplace_back(vk::WriteDescriptorSet()
-                .setDstSet(vk_dset_light_sources_.get())
-                .setDstBinding(0)
+                .setDstSet(set)
+                .setDstBinding(binding)
                 .setDstArrayElement(0)
-                .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                .setDescriptorType(type)
                 .setDescriptorCount(1)
                 .setPBufferInfo(&buffer_infos.back()));
-        }
+        };
+
+        const auto write_ring = [&](const vk::DescriptorSet& set, const uint32_t binding, const vk::DescriptorType type,
+                                    const FrameRingBuffer& ring){
+            write_buffer(set, binding, type, ring.vk_buffer(), ring.region_offset(frame_index), ring.region_size());
+        };
 
+        const auto i = frame_index;
+        // Камера (set = 0, binding = 0)
+        write_ring(vk_dsets_view_[i].get(), 0, vk::DescriptorType::eUniformBuffer, *vk_ubo_view_);
+        // Трансформации объектов (set = 1, binding = 0)
+        write_ring(vk_dsets_objects_uniforms_[i].get(), 0, vk::DescriptorType::eStorageBuffer, *vk_ubo_objects_transforms_);
+        // Индексы объектов экземпляров (set = 1, binding = 1), области кадров адресуются через first_instance
+        write_buffer(vk_dsets_objects_uniforms_[i].get(), 1, vk::DescriptorType::eStorageBuffer, vk_ubo_instance_indices_->vk_buffer(), 0, VK_WHOLE_SIZE);
+        // Параметры Phong материалов (set = 2, binding = 0)
+        write_ring(vk_dsets_material_uniforms_[i].get(), 0, vk::DescriptorType::eStorageBuffer, *vk_ubo_materials_phong_);
+        // Параметры PBR материалов (set = 2, binding = 1)
+        write_ring(vk_dsets_material_uniforms_[i].get(), 1, vk::DescriptorType::eStorageBuffer, *vk_ubo_materials_pbr_);
+        // Индексы текстур материалов (set = 2, binding = 2)
+        write_ring(vk_dsets_material_uniforms_[i].get(), 2, vk::DescriptorType::eStorageBuffer, *vk_ubo_materials_textures_);
+        // Источники света (set = 4, binding = 0)
+        write_ring(vk_dsets_light_sources_[i].get(), 0, vk::DescriptorType::eStorageBuffer, *vk_ubo_light_sources_);
         // Индексы активных источников света (set = 4, binding = 1)
+        write_ring(vk_dsets_light_sources_[i].get(), 1, vk::DescriptorType::eStorageBuffer, *vk_ubo_light_indices_);
+        // Кластеры источников света (set = 4, binding = 2)
+        write_buffer(vk_dsets_light_sources_[i].get(), 2, vk::DescriptorType::eStorageBuffer, vk_light_clusters_->vk_buffer(),
+            light_clusters_region_ * i, light_clusters_region_);
+
+        vk_device_->logical_device().updateDescriptorSets(writes, {});
+    }
+
+    void Renderer::grow_frame_buffers(const size_t frame_index){
+        const auto frames = static_cast<size_t>(config_.max_frames_in_flight);
+        std::vector<vk::utils::Buffer::Ptr> retired;
+
+        // Кольцевые буферы перевыделяются под емкость, зарезервированную при выдаче индексов
+        bool reallocated = false;
+        for (auto* ring : {
+            vk_ubo_objects_transforms_.get(),
+            vk_ubo_objects_bounds_.get(),
+            vk_ubo_materials_phong_.get(),
+            vk_ubo_materials_pbr_.get(),
+            vk_ubo_materials_textures_.get(),
+            vk_ubo_light_sources_.get(),
+            vk_ubo_light_indices_.get()})
         {
-            buffer_infos.emplace_back(vk::DescriptorBufferInfo()
-                .setBuffer(vk_ubo_light_indices_->vk_buffer())
-                .setOffset(0)
-                .setRange(sizeof(LightIndices)));
+            reallocated = ring->reallocate(retired) || reallocated;
+        }
 
-            writes.emplace_back(vk::WriteDescriptorSet()
-                .setDstSet(vk_dset_light_sources_.get())
-                .setDstBinding(1)
-                .setDstArrayElement(0)
-                .setDescriptorType(vk::DescriptorType::eStorageBuffer)
-                .setDescriptorCount(1)
-                .setPBufferInfo(&buffer_infos.back()));
+        // Области кадров буферов отрисовки вмещают все объекты и все экземпляры прошлого кадра
+        // (содержимое заполняется заново каждый кадр, курсор экземпляров еще хранит запрошенное кол-во)
+        const auto instances_requested = instance_cursor_.load(std::memory_order_relaxed);
+        if (draw_capacity_ < object_capacity_ || draw_capacity_ < instances_requested){
+            if (draw_capacity_ < instances_requested){
+                logger()->warning("Vulkan: Instance indices overflow (requested: " + std::to_string(instances_requested)
+                    + ", capacity: " + std::to_string(draw_capacity_) + ").");
+            }
+            draw_capacity_ = std::max(object_capacity_, instances_requested);
+            retired.push_back(std::move(vk_ubo_instance_indices_));
+            retired.push_back(std::move(vk_indirect_commands_));
+            retired.push_back(std::move(vk_indirect_counts_));
+            init_vk_draw_buffers();
+
+            if (gpu_culler_){
+                gpu_culler_->reserve(draw_capacity_, retired);
+            }
+            reallocated = true;
         }
 
-        // Связать дескрипторы с буферами
-        vk_device_->logical_device().updateDescriptorSets(writes, {});
+        // Старые буферы могут читаться активными кадрами - освобождаются после завершения кадров
+        if (reallocated){
+            buffers_generation_++;
+            for (auto& buffer : retired){
+                retired_buffers_.emplace_back(current_frame_ + frames, std::move(buffer));
+            }
 
-        // Подготовить uniform буферы к записи (разметка памяти)
-        vk_ubo_view_->map_unsafe();
-        vk_ubo_objects_transforms_->map_unsafe();
-        vk_ubo_materials_phong_->map_unsafe();
-        vk_ubo_materials_pbr_->map_unsafe();
-        vk_ubo_light_sources_->map_unsafe();
-        vk_ubo_light_indices_->map_unsafe();
+            logger()->info("Vulkan: Frame buffers reallocated (objects: " + std::to_string(object_capacity_)
+                + ", materials: " + std::to_string(material_capacity_)
+                + ", lights: " + std::to_string(light_capacity_) + ").");
+        }
+
+        // Кадр завершен, его наборы не используются - переключить их на буферы текущего поколения
+        if (frame_buffers_generation_[frame_index] != buffers_generation_){
+            update_frame_descriptors(frame_index);
+            if (gpu_culler_){
+                gpu_culler_->update_frame_descriptors(frame_index);
+            }
+            frame_buffers_generation_[frame_index] = buffers_generation_;
+        }
+
+        // Кадры, которые могли использовать замененные буферы, завершены
+        retired_buffers_.erase(
+            std::remove_if(retired_buffers_.begin(), retired_buffers_.end(), [this](const auto& retired_buffer){
+                return retired_buffer.first <= current_frame_;
+            }),
+            retired_buffers_.end());
     }
 
     void Renderer::init_vk_command_buffers(){
@@ -1439,6 +2834,44 @@ namespace nasral::rendering
             .setCommandPool(pool.get())
             .setLevel(vk::CommandBufferLevel::ePrimary)
             .setCommandBufferCount(config_.max_frames_in_flight));
+
+        // Буферы команд копирования данных кадра в память устройства (исполняются перед основным буфером)
+        vk_upload_command_buffers_ = vk_device_->logical_device().allocateCommandBuffersUnique(
+            vk::CommandBufferAllocateInfo()
+            .setCommandPool(pool.get())
+            .setLevel(vk::CommandBufferLevel::ePrimary)
+            .setCommandBufferCount(config_.max_frames_in_flight));
+    }
+
+    void Renderer::init_vk_recording_pools(){
+        assert(vk_instance_);
+        assert(vk_device_);
+
+        // Контекст основного буфера команд присутствует всегда
+        recording_contexts_.resize(1);
+        if (config_.recording_threads == 0) return;
+
+        // Контексты потоков записи
+        const size_t threads = config_.recording_threads;
+        recording_contexts_.resize(threads + 1);
+
+        // Пул рабочих потоков (один из отрезков записывает вызывающий поток)
+        recording_pool_ = std::make_unique<threading::ThreadPool>(threads - 1, "recording");
+
+        // Пулы команд для каждого кадра и потока (пул не может использоваться несколькими потоками одновременно)
+        const auto family_index = vk_device_->queue_group(to<size_t>(CommandGroup::eGraphicsAndPresent)).family_index.value();
+        vk_recording_pools_.resize(config_.max_frames_in_flight);
+        vk_recording_buffers_.resize(config_.max_frames_in_flight);
+
+        for (size_t i = 0; i < config_.max_frames_in_flight; ++i){
+            for (size_t t = 0; t < threads; ++t){
+                vk_recording_pools_[i].emplace_back(vk_device_->logical_device().createCommandPoolUnique(
+                    vk::CommandPoolCreateInfo()
+                    .setFlags(vk::CommandPoolCreateFlagBits::eTransient)
+                    .setQueueFamilyIndex(family_index)));
+            }
+            vk_recording_buffers_[i].resize(threads);
+        }
     }
 
     void Renderer::init_vk_sync_objects(){
@@ -1459,26 +2892,61 @@ namespace nasral::rendering
     }
 
     void Renderer::init_index_pools(){
-        object_ids_.reserve(MAX_OBJECTS);
-        light_ids_.reserve(MAX_LIGHTS);
-        active_light_ids_.reserve(MAX_LIGHTS);
-        material_ids_.reserve(MAX_MATERIALS);
-        materials_.reserve(MAX_MATERIALS);
-
-        for (uint32_t i = MAX_OBJECTS; i > 0; --i){
+        object_ids_.reserve(object_capacity_);
+        light_ids_.reserve(light_capacity_);
+        active_light_ids_.reserve(light_capacity_);
+        active_light_slots_.assign(light_capacity_, INACTIVE_LIGHT_SLOT);
+        material_ids_.reserve(material_capacity_);
+        materials_.reserve(material_capacity_);
+        material_texture_ids_.reserve(material_capacity_);
+
+        for (uint32_t i = object_capacity_; i > 0; --i){
             object_ids_.emplace_back(i - 1);
         }
 
-        for (uint32_t i = MAX_LIGHTS; i > 0; --i){
+        for (uint32_t i = light_capacity_; i > 0; --i){
             light_ids_.emplace_back(i - 1);
         }
 
-        for (uint32_t i = MAX_MATERIALS; i > 0; --i){
+        for (uint32_t i = material_capacity_; i > 0; --i){
             material_ids_.emplace_back(i - 1);
         }
     }
 
+    void Renderer::save_vk_pipeline_cache() const{
+        if (!vk_pipeline_cache_ || config_.pipeline_cache_file.empty()) return;
+
+        const auto data = vk_device_->logical_device().getPipelineCacheData(vk_pipeline_cache_.get());
+        const std::filesystem::path path(config_.pipeline_cache_file);
+        if (path.has_parent_path()){
+            std::filesystem::create_directories(path.parent_path());
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()){
+            throw std::runtime_error("Can't open file " + path.string());
+        }
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+        logger()->info("Vulkan: Pipeline cache saved (" + std::to_string(data.size()) + " bytes).");
+    }
+
+    void Renderer::on_pipeline_created(const std::chrono::steady_clock::time_point& started) const{
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+        pipelines_created_.fetch_add(1, std::memory_order_relaxed);
+        pipelines_create_time_us_.fetch_add(to<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+
+        std::ostringstream ss;
+        ss.setf(std::ios::fixed);
+        ss.precision(2);
+        ss << "Vulkan: Pipeline created in " << static_cast<double>(elapsed.count()) / 1000.0 << " ms.";
+        logger()->debug(ss.str());
+    }
+
     void Renderer::refresh_vk_surface(){
+        // Внеэкранные кадровые буферы не зависят от поверхности
+        if (config_.headless) return;
+
         assert(vk_instance_);
         assert(vk_surface_);
         assert(vk_device_);
@@ -1490,6 +2958,21 @@ namespace nasral::rendering
         is_rendering_ = false;
         current_frame_ = 0;
 
+        // Отложенные освобождения привязаны к номерам кадров - после ожидания устройства ни один кадр их не использует
+        retired_buffers_.clear();
+        for (const auto& retired_id : retired_texture_ids_){
+            texture_free_ids_.push_back(retired_id.second);
+        }
+        retired_texture_ids_.clear();
+
+        // Ожидающие чтения результаты кадров относятся к прежней нумерации кадров
+        if (gpu_culler_){
+            gpu_culler_->reset_frames();
+        }
+        if (gpu_profiler_){
+            gpu_profiler_->reset_frames();
+        }
+
         // Очистить командные буферы
         vk_command_buffers_.clear();
         logger()->info("Vulkan: cleared command buffers");
@@ -1508,6 +2991,12 @@ namespace nasral::rendering
         const std::string extent_str = std::to_string(extent.width) + "x" + std::to_string(extent.height);
         logger()->info("Vulkan: recreated framebuffers (" + extent_str + ")");
 
+        // Пирамида глубины зависит от размеров кадровых буферов
+        if (gpu_culler_){
+            gpu_culler_->refresh_framebuffers();
+            logger()->info("Vulkan: recreated depth pyramid");
+        }
+
         // Создать новые командные буферы
         init_vk_command_buffers();
         logger()->info("Vulkan: recreated command buffers");
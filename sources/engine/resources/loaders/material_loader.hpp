@@ -42,6 +42,9 @@ namespace nasral::resources
                 if (name == "PolygonMode"){
                     data.polygon_mode = setting.text().as_string();
                 }
+                if (name == "Instanced"){
+                    data.instanced = setting.text().as_bool();
+                }
                 if (name == "LineWidth"){
                     try{
                         data.line_width = std::stof(setting.text().as_string());
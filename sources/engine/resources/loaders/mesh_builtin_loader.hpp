@@ -1,5 +1,6 @@
 #pragma once
 #include <nasral/resources/mesh.h>
+#include "mesh_utils.hpp"
 
 namespace nasral::resources
 {
@@ -22,6 +23,7 @@ namespace nasral::resources
                     {{half_size, -half_size, 0.0f},{0.0f, 0.0f, 1.0f},{1.0f, 0.0f},{1.0f, 1.0f,0.0f,1.0f}}
                 };
                 std::vector<uint32_t> indices = {0, 1, 2, 2, 3, 0};
+                compute_tangents(vertices, indices);
                 return std::optional{Mesh::Data{
                     std::move(vertices),
                     std::move(indices)
@@ -96,6 +98,7 @@ namespace nasral::resources
                 base = static_cast<uint32_t>(vertices.size()) - 4;
                 indices.insert(indices.end(), {base, base + 1, base + 2, base + 2, base + 3, base});
 
+                compute_tangents(vertices, indices);
                 err_code_ = ErrorCode::eNoError;
                 return std::optional{Mesh::Data{
                     std::move(vertices),
@@ -171,6 +174,7 @@ namespace nasral::resources
                     }
                 }
 
+                compute_tangents(vertices, indices);
                 err_code_ = ErrorCode::eNoError;
                 return std::optional{Mesh::Data{
                     std::move(vertices),
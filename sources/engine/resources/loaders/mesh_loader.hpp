@@ -1,5 +1,6 @@
 #pragma once
 #include <nasral/resources/mesh.h>
+#include "mesh_utils.hpp"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -99,6 +100,22 @@ namespace nasral::resources
                         vertex.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
                     }
 
+                    // Касательная и направление битангенса (знак определяет зеркальность UV)
+                    if (mesh->HasTangentsAndBitangents()){
+                        const auto tangent = glm::vec3(
+                            mesh->mTangents[vtx_idx].x,
+                            mesh->mTangents[vtx_idx].y,
+                            mesh->mTangents[vtx_idx].z);
+
+                        const auto bitangent = glm::vec3(
+                            mesh->mBitangents[vtx_idx].x,
+                            mesh->mBitangents[vtx_idx].y,
+                            mesh->mBitangents[vtx_idx].z);
+
+                        const float handedness = glm::dot(glm::cross(vertex.normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f;
+                        vertex.tangent = glm::vec4(tangent, handedness);
+                    }
+
                     vertices.push_back(vertex);
                 }
 
@@ -121,6 +138,9 @@ namespace nasral::resources
                 return std::nullopt;
             }
 
+            // Касательные вершин, для которых они не были получены при загрузке
+            compute_tangents(vertices, indices);
+
             err_code_ = ErrorCode::eNoError;
             return std::optional{Mesh::Data{
                 std::move(vertices),
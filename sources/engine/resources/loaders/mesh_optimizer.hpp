@@ -0,0 +1,278 @@
+#pragma once
+#include <nasral/resources/mesh.h>
+
+namespace nasral::resources
+{
+    /**
+     * Показатели эффективности кеша вершин (после трансформации)
+     */
+    struct MeshCacheStats
+    {
+        float acmr = 0.0f;                                                  // Среднее кол-во промахов кеша на треугольник (0.5 - 3.0)
+        float atvr = 0.0f;                                                  // Отношение промахов к кол-ву используемых вершин (1.0 - идеал)
+    };
+
+    /**
+     * Оценка кеша вершин (моделируется FIFO кеш фиксированного размера)
+     * @param indices Индексы треугольников
+     * @param vertex_count Кол-во вершин
+     * @param cache_size Размер кеша
+     * @return Показатели ACMR и ATVR
+     */
+    inline MeshCacheStats analyze_vertex_cache(const std::vector<uint32_t>& indices, const size_t vertex_count, const size_t cache_size = 16)
+    {
+        MeshCacheStats stats{};
+        if (indices.size() < 3 || vertex_count == 0) return stats;
+
+        // Время попадания вершины в кеш (вершина в кеше, если в него попало меньше cache_size вершин после неё)
+        std::vector<size_t> timestamps(vertex_count, 0);
+        std::vector<uint8_t> used(vertex_count, 0);
+        size_t time = cache_size + 1;
+        size_t misses = 0;
+        size_t unique = 0;
+
+        for (const auto index : indices){
+            if (time - timestamps[index] > cache_size){
+                timestamps[index] = time++;
+                misses++;
+            }
+            if (!used[index]){
+                used[index] = 1;
+                unique++;
+            }
+        }
+
+        stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+        stats.atvr = static_cast<float>(misses) / static_cast<float>(unique);
+        return stats;
+    }
+
+    /**
+     * Упорядочивание треугольников для повторного использования вершин кеша (алгоритм Forsyth)
+     * @param indices Индексы треугольников (изменяются)
+     * @param vertex_count Кол-во вершин
+     *
+     * @details Жадно выбирается треугольник с наибольшей оценкой вершин. Оценка вершины выше, если она недавно
+     * была в кеше (модель LRU) и если у неё осталось мало неиспользованных треугольников.
+     */
+    inline void optimize_vertex_cache(std::vector<uint32_t>& indices, const size_t vertex_count)
+    {
+        constexpr size_t kCacheSize = 32;
+        constexpr float kLastTriangleScore = 0.75f;
+        constexpr float kCacheDecayPower = 1.5f;
+        constexpr float kValenceBoostScale = 2.0f;
+        constexpr float kValenceBoostPower = 0.5f;
+
+        const size_t triangle_count = indices.size() / 3;
+        if (triangle_count == 0 || vertex_count == 0) return;
+
+        // Треугольники каждой вершины (первые live[v] элементов - еще не выданные)
+        std::vector<uint32_t> live(vertex_count, 0);
+        for (size_t i = 0; i < triangle_count * 3; ++i) live[indices[i]]++;
+
+        std::vector<uint32_t> offsets(vertex_count + 1, 0);
+        for (size_t v = 0; v < vertex_count; ++v) offsets[v + 1] = offsets[v] + live[v];
+
+        std::vector<uint32_t> adjacency(triangle_count * 3);
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < triangle_count * 3; ++i) adjacency[fill[indices[i]]++] = to<uint32_t>(i / 3);
+        }
+
+        // Оценка вершины по положению в кеше и кол-ву оставшихся треугольников
+        std::vector<int32_t> cache_position(vertex_count, -1);
+        const auto vertex_score = [&](const size_t v){
+            if (live[v] == 0) return -1.0f;
+
+            float score = 0.0f;
+            const auto position = cache_position[v];
+            if (position >= 0){
+                if (position < 3){
+                    score = kLastTriangleScore;
+                }else{
+                    const float scaler = 1.0f / static_cast<float>(kCacheSize - 3);
+                    score = std::pow(1.0f - static_cast<float>(position - 3) * scaler, kCacheDecayPower);
+                }
+            }
+            return score + kValenceBoostScale * std::pow(static_cast<float>(live[v]), -kValenceBoostPower);
+        };
+
+        std::vector<float> vertex_scores(vertex_count);
+        for (size_t v = 0; v < vertex_count; ++v) vertex_scores[v] = vertex_score(v);
+
+        std::vector<float> triangle_scores(triangle_count);
+        for (size_t t = 0; t < triangle_count; ++t){
+            triangle_scores[t] = vertex_scores[indices[t * 3]] + vertex_scores[indices[t * 3 + 1]] + vertex_scores[indices[t * 3 + 2]];
+        }
+
+        std::vector<uint8_t> emitted(triangle_count, 0);
+        std::vector<uint32_t> result;
+        result.reserve(triangle_count * 3);
+
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> cache_next;
+        cache.reserve(kCacheSize + 3);
+        cache_next.reserve(kCacheSize + 3);
+
+        // Курсор линейного поиска (для треугольников, не связанных с вершинами кеша)
+        size_t search_cursor = 0;
+        int64_t best = -1;
+
+        for (size_t emitted_count = 0; emitted_count < triangle_count; ++emitted_count)
+        {
+            if (best < 0){
+                while (search_cursor < triangle_count && emitted[search_cursor]) ++search_cursor;
+                best = static_cast<int64_t>(search_cursor);
+            }
+
+            // Выдать треугольник и исключить его из списков вершин
+            const auto triangle = static_cast<size_t>(best);
+            emitted[triangle] = 1;
+            for (size_t k = 0; k < 3; ++k){
+                const auto v = indices[triangle * 3 + k];
+                result.push_back(v);
+
+                const auto begin = adjacency.begin() + offsets[v];
+                const auto end = begin + live[v];
+                const auto it = std::find(begin, end, to<uint32_t>(triangle));
+                std::iter_swap(it, end - 1);
+                live[v]--;
+            }
+
+            // Вершины треугольника в начало кеша, вытесненные вершины покидают кеш
+            cache_next.assign(indices.begin() + static_cast<ptrdiff_t>(triangle * 3), indices.begin() + static_cast<ptrdiff_t>(triangle * 3 + 3));
+            for (const auto v : cache){
+                if (v != cache_next[0] && v != cache_next[1] && v != cache_next[2]) cache_next.push_back(v);
+            }
+            for (size_t i = 0; i < cache_next.size(); ++i){
+                cache_position[cache_next[i]] = i < kCacheSize ? to<int32_t>(i) : -1;
+            }
+
+            // Пересчитать оценки вершин кеша и их треугольников, выбрать лучший из них
+            best = -1;
+            float best_score = -1.0f;
+            for (const auto v : cache_next){
+                const float score = vertex_score(v);
+                const float delta = score - vertex_scores[v];
+                vertex_scores[v] = score;
+
+                for (uint32_t i = offsets[v]; i < offsets[v] + live[v]; ++i){
+                    const auto t = adjacency[i];
+                    triangle_scores[t] += delta;
+                    if (triangle_scores[t] > best_score){
+                        best_score = triangle_scores[t];
+                        best = t;
+                    }
+                }
+            }
+
+            if (cache_next.size() > kCacheSize) cache_next.resize(kCacheSize);
+            std::swap(cache, cache_next);
+        }
+
+        indices.swap(result);
+    }
+
+    /**
+     * Упорядочивание групп треугольников для уменьшения перерисовки (по мотивам Tipsify)
+     * @param indices Индексы треугольников, упорядоченные для кеша вершин (изменяются)
+     * @param vertices Вершины
+     * @param cache_size Размер кеша (группы разделяются там, где кеш и так начинается заново)
+     *
+     * @details Группы рисуются от обращенных наружу к обращенным внутрь (относительно центра mesh'а),
+     * так внешние поверхности чаще закрывают внутренние раньше. Порядок внутри группы не меняется.
+     */
+    inline void optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<rendering::Vertex>& vertices, const size_t cache_size = 16)
+    {
+        const size_t triangle_count = indices.size() / 3;
+        if (triangle_count < 2) return;
+
+        // Группы: новая группа начинается с треугольника, все вершины которого не в кеше
+        std::vector<size_t> timestamps(vertices.size(), 0);
+        size_t time = cache_size + 1;
+        std::vector<size_t> cluster_starts;
+        for (size_t t = 0; t < triangle_count; ++t){
+            size_t misses = 0;
+            for (size_t k = 0; k < 3; ++k){
+                const auto index = indices[t * 3 + k];
+                if (time - timestamps[index] > cache_size){
+                    timestamps[index] = time++;
+                    misses++;
+                }
+            }
+            if (misses == 3 || t == 0) cluster_starts.push_back(t);
+        }
+        if (cluster_starts.size() < 2) return;
+        cluster_starts.push_back(triangle_count);
+
+        // Центр mesh'а (среднее положений вершин треугольников)
+        glm::vec3 mesh_center(0.0f);
+        for (const auto index : indices) mesh_center += vertices[index].pos;
+        mesh_center /= static_cast<float>(indices.size());
+
+        // Направленность группы наружу: проекция смещения центра группы на её средневзвешенную (площадью) нормаль
+        const size_t cluster_count = cluster_starts.size() - 1;
+        std::vector<float> sort_keys(cluster_count, 0.0f);
+        for (size_t c = 0; c < cluster_count; ++c){
+            glm::vec3 center(0.0f);
+            glm::vec3 normal(0.0f);
+            float area = 0.0f;
+
+            for (size_t t = cluster_starts[c]; t < cluster_starts[c + 1]; ++t){
+                const auto& p0 = vertices[indices[t * 3]].pos;
+                const auto& p1 = vertices[indices[t * 3 + 1]].pos;
+                const auto& p2 = vertices[indices[t * 3 + 2]].pos;
+                const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+                const float a = glm::length(n);
+
+                center += (p0 + p1 + p2) * (a / 3.0f);
+                normal += n;
+                area += a;
+            }
+
+            if (area <= 0.0f) continue;
+            center /= area;
+            const float normal_length = glm::length(normal);
+            if (normal_length > 0.0f){
+                sort_keys[c] = glm::dot(center - mesh_center, normal / normal_length);
+            }
+        }
+
+        std::vector<size_t> order(cluster_count);
+        for (size_t c = 0; c < cluster_count; ++c) order[c] = c;
+        std::stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b){
+            return sort_keys[a] > sort_keys[b];
+        });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (const auto c : order){
+            result.insert(result.end(),
+                indices.begin() + static_cast<ptrdiff_t>(cluster_starts[c] * 3),
+                indices.begin() + static_cast<ptrdiff_t>(cluster_starts[c + 1] * 3));
+        }
+        indices.swap(result);
+    }
+
+    /**
+     * Упорядочивание вершин по первому использованию (последовательная выборка вершин, неиспользуемые исключаются)
+     * @param vertices Вершины (изменяются)
+     * @param indices Индексы треугольников (изменяются)
+     */
+    inline void optimize_vertex_fetch(std::vector<rendering::Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        constexpr auto kUnused = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> remap(vertices.size(), kUnused);
+        std::vector<rendering::Vertex> result;
+        result.reserve(vertices.size());
+
+        for (auto& index : indices){
+            if (remap[index] == kUnused){
+                remap[index] = to<uint32_t>(result.size());
+                result.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        vertices.swap(result);
+    }
+}
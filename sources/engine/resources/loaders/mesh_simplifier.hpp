@@ -0,0 +1,302 @@
+#pragma once
+#include <nasral/resources/mesh.h>
+
+namespace nasral::resources
+{
+    /**
+     * Квадрика ошибки (сумма квадратов расстояний до плоскостей, симметричная матрица 4x4)
+     */
+    struct Quadric
+    {
+        double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+        double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+        double c = 0.0;
+
+        /**
+         * Квадрика плоскости
+         * @param n Единичная нормаль плоскости
+         * @param d Смещение плоскости (dot(n, p) + d = 0)
+         * @param weight Вес (площадь треугольника)
+         * @return Квадрика
+         */
+        static Quadric from_plane(const glm::dvec3& n, const double d, const double weight){
+            Quadric q;
+            q.a00 = n.x * n.x * weight; q.a01 = n.x * n.y * weight; q.a02 = n.x * n.z * weight;
+            q.a11 = n.y * n.y * weight; q.a12 = n.y * n.z * weight; q.a22 = n.z * n.z * weight;
+            q.b0 = n.x * d * weight; q.b1 = n.y * d * weight; q.b2 = n.z * d * weight;
+            q.c = d * d * weight;
+            return q;
+        }
+
+        Quadric& operator+=(const Quadric& other){
+            a00 += other.a00; a01 += other.a01; a02 += other.a02;
+            a11 += other.a11; a12 += other.a12; a22 += other.a22;
+            b0 += other.b0; b1 += other.b1; b2 += other.b2;
+            c += other.c;
+            return *this;
+        }
+
+        [[nodiscard]] double error(const glm::vec3& p) const{
+            const double x = p.x, y = p.y, z = p.z;
+            const double e = x * x * a00 + y * y * a11 + z * z * a22
+                + 2.0 * (x * y * a01 + x * z * a02 + y * z * a12)
+                + 2.0 * (x * b0 + y * b1 + z * b2)
+                + c;
+            return std::max(e, 0.0);
+        }
+    };
+
+    /**
+     * Упрощение треугольной сетки стягиванием ребер (квадрики ошибки Garland-Heckbert)
+     * @param vertices Вершины (не изменяются, упрощенная сетка ссылается на их подмножество)
+     * @param indices Индексы треугольников
+     * @param target_index_count Целевое кол-во индексов
+     * @return Индексы упрощенной сетки
+     *
+     * @details Вершины с одинаковым положением объединяются, ребро стягивается в одну из своих вершин (новые вершины
+     * не создаются, поэтому все уровни детализации используют общий буфер вершин). Вершины шва текстурных координат
+     * и открытой границы стягиваются только в вершины того же вида, границы дополнительно удерживаются плоскостями,
+     * перпендикулярными граничным ребрам. Стягивания, разворачивающие треугольники, отклоняются. За проход стягиваются
+     * самые дешевые несмежные ребра, проходы повторяются до целевого кол-ва индексов или пока стягивания возможны.
+     */
+    inline std::vector<uint32_t> simplify_mesh(
+        const std::vector<rendering::Vertex>& vertices,
+        const std::vector<uint32_t>& indices,
+        const size_t target_index_count)
+    {
+        constexpr uint8_t kManifold = 0;
+        constexpr uint8_t kBorder = 1;
+        constexpr uint8_t kSeam = 2;
+        constexpr double kBorderWeight = 10.0;
+
+        std::vector<uint32_t> result(indices);
+        if (indices.size() <= target_index_count || vertices.empty()) return result;
+
+        // Объединение вершин по положению (группа - индекс первой вершины с таким положением)
+        const auto vertex_count = vertices.size();
+        std::vector<uint32_t> group(vertex_count);
+        {
+            // Хеш согласован со сравнением glm::vec3 (-0.0 и 0.0 приводятся к 0.0, иначе равные положения попадут в разные группы)
+            struct PosHash
+            {
+                size_t operator()(const glm::vec3& p) const{
+                    const glm::vec3 canonical = p + 0.0f;
+                    uint32_t h[3];
+                    std::memcpy(h, &canonical, sizeof(h));
+                    return (h[0] * 73856093u) ^ (h[1] * 19349663u) ^ (h[2] * 83492791u);
+                }
+            };
+
+            std::unordered_map<glm::vec3, uint32_t, PosHash> positions;
+            positions.reserve(vertex_count);
+            for (size_t v = 0; v < vertex_count; ++v){
+                group[v] = positions.try_emplace(vertices[v].pos, to<uint32_t>(v)).first->second;
+            }
+        }
+
+        // Вершины каждой группы (CSR)
+        std::vector<uint32_t> member_offsets(vertex_count + 1, 0);
+        for (size_t v = 0; v < vertex_count; ++v) member_offsets[group[v] + 1]++;
+        for (size_t g = 0; g < vertex_count; ++g) member_offsets[g + 1] += member_offsets[g];
+        std::vector<uint32_t> members(vertex_count);
+        {
+            std::vector<uint32_t> fill(member_offsets.begin(), member_offsets.end() - 1);
+            for (size_t v = 0; v < vertex_count; ++v) members[fill[group[v]]++] = to<uint32_t>(v);
+        }
+
+        // Вид группы: шов (несколько вершин с разными атрибутами), граница (ребро с одним треугольником) или внутренняя
+        std::vector<uint8_t> kind(vertex_count, kManifold);
+        for (size_t g = 0; g < vertex_count; ++g){
+            if (member_offsets[g + 1] - member_offsets[g] > 1) kind[g] = kSeam;
+        }
+
+        const auto edge_key = [](const uint32_t a, const uint32_t b){
+            return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+        };
+
+        std::unordered_map<uint64_t, uint32_t> edge_use;
+        edge_use.reserve(indices.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3){
+            for (size_t k = 0; k < 3; ++k){
+                edge_use[edge_key(group[indices[i + k]], group[indices[i + (k + 1) % 3]])]++;
+            }
+        }
+
+        // Квадрики групп (плоскости треугольников, взвешенные площадью)
+        std::vector<Quadric> quadrics(vertex_count);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3){
+            const glm::dvec3 p0 = vertices[indices[i]].pos;
+            const glm::dvec3 p1 = vertices[indices[i + 1]].pos;
+            const glm::dvec3 p2 = vertices[indices[i + 2]].pos;
+            const glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+            const double area = glm::length(n);
+            if (area <= 0.0) continue;
+
+            const glm::dvec3 normal = n / area;
+            const auto q = Quadric::from_plane(normal, -glm::dot(normal, p0), area * 0.5);
+            for (size_t k = 0; k < 3; ++k) quadrics[group[indices[i + k]]] += q;
+
+            // Граничные ребра удерживаются плоскостью, перпендикулярной треугольнику
+            for (size_t k = 0; k < 3; ++k){
+                const auto a = group[indices[i + k]];
+                const auto b = group[indices[i + (k + 1) % 3]];
+                if (edge_use[edge_key(a, b)] != 1) continue;
+
+                const glm::dvec3 pa = vertices[a].pos;
+                const glm::dvec3 edge = glm::dvec3(vertices[b].pos) - pa;
+                const double length = glm::length(edge);
+                if (length <= 0.0) continue;
+
+                const glm::dvec3 side = glm::normalize(glm::cross(edge, normal));
+                const auto border = Quadric::from_plane(side, -glm::dot(side, pa), length * length * kBorderWeight);
+                quadrics[a] += border;
+                quadrics[b] += border;
+                if (kind[a] == kManifold) kind[a] = kBorder;
+                if (kind[b] == kManifold) kind[b] = kBorder;
+            }
+        }
+
+        // Для вершины стянутой группы выбирается вершина целевой группы с наиболее близкими атрибутами
+        const auto closest_member = [&](const uint32_t v, const uint32_t target){
+            uint32_t best = members[member_offsets[target]];
+            float best_distance = std::numeric_limits<float>::max();
+            for (uint32_t m = member_offsets[target]; m < member_offsets[target + 1]; ++m){
+                const auto& a = vertices[v];
+                const auto& b = vertices[members[m]];
+                const glm::vec2 duv = a.uv - b.uv;
+                const glm::vec3 dn = a.normal - b.normal;
+                const float distance = glm::dot(duv, duv) + glm::dot(dn, dn);
+                if (distance < best_distance){
+                    best_distance = distance;
+                    best = members[m];
+                }
+            }
+            return best;
+        };
+
+        struct Collapse
+        {
+            double cost;
+            uint32_t from;
+            uint32_t into;
+        };
+
+        std::vector<uint32_t> remap(vertex_count);
+        std::vector<uint8_t> locked(vertex_count);
+        std::vector<uint32_t> adjacency_offsets(vertex_count + 1);
+        std::vector<uint32_t> adjacency;
+        std::vector<Collapse> collapses;
+
+        while (result.size() > target_index_count)
+        {
+            const size_t triangle_count = result.size() / 3;
+
+            // Треугольники каждой группы (CSR)
+            std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+            for (const auto index : result) adjacency_offsets[group[index] + 1]++;
+            for (size_t g = 0; g < vertex_count; ++g) adjacency_offsets[g + 1] += adjacency_offsets[g];
+            adjacency.resize(result.size());
+            {
+                std::vector<uint32_t> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+                for (size_t i = 0; i < result.size(); ++i) adjacency[fill[group[result[i]]]++] = to<uint32_t>(i / 3);
+            }
+
+            // Стягивание from -> into допустимо, если треугольники вокруг from не разворачиваются
+            const auto preserves_orientation = [&](const uint32_t from, const uint32_t into){
+                const glm::vec3& target = vertices[into].pos;
+                for (uint32_t i = adjacency_offsets[from]; i < adjacency_offsets[from + 1]; ++i){
+                    const size_t t = adjacency[i];
+                    glm::vec3 p[3];
+                    bool removed = false;
+                    for (size_t k = 0; k < 3; ++k){
+                        const auto g = group[result[t * 3 + k]];
+                        removed = removed || g == into;
+                        p[k] = vertices[g].pos;
+                    }
+                    if (removed) continue;
+
+                    const glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                    if (glm::dot(before, before) <= 0.0f) continue;
+
+                    for (auto& point : p){
+                        if (point == vertices[from].pos) point = target;
+                    }
+                    const glm::vec3 after = glm::cross(p[1] - p[0], p[2] - p[0]);
+                    if (glm::dot(before, after) <= 0.25f * glm::length(before) * glm::length(after)) return false;
+                }
+                return true;
+            };
+
+            // Кандидаты (оба направления каждого ребра, дубликаты отсеиваются блокировкой)
+            collapses.clear();
+            for (size_t t = 0; t < triangle_count; ++t){
+                for (size_t k = 0; k < 3; ++k){
+                    const auto a = group[result[t * 3 + k]];
+                    const auto b = group[result[t * 3 + (k + 1) % 3]];
+                    for (const auto& [from, into] : {std::pair{a, b}, std::pair{b, a}}){
+                        if (kind[from] != kManifold && kind[from] != kind[into]) continue;
+
+                        Quadric q = quadrics[from];
+                        q += quadrics[into];
+                        collapses.push_back({q.error(vertices[into].pos), from, into});
+                    }
+                }
+            }
+
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b){
+                return a.cost < b.cost;
+            });
+
+            // Стягивание несмежных ребер в порядке стоимости
+            for (size_t v = 0; v < vertex_count; ++v) remap[v] = to<uint32_t>(v);
+            std::fill(locked.begin(), locked.end(), 0);
+
+            size_t estimated_indices = result.size();
+            size_t collapsed = 0;
+            for (const auto& collapse : collapses){
+                if (estimated_indices <= target_index_count) break;
+                if (locked[collapse.from] || locked[collapse.into]) continue;
+                if (!preserves_orientation(collapse.from, collapse.into)) continue;
+
+                // Соседи from блокируются до следующего прохода (их треугольники изменились)
+                size_t removed = 0;
+                for (uint32_t i = adjacency_offsets[collapse.from]; i < adjacency_offsets[collapse.from + 1]; ++i){
+                    const size_t t = adjacency[i];
+                    bool shared = false;
+                    for (size_t k = 0; k < 3; ++k){
+                        const auto g = group[result[t * 3 + k]];
+                        locked[g] = 1;
+                        shared = shared || g == collapse.into;
+                    }
+                    removed += shared ? 1 : 0;
+                }
+
+                for (uint32_t m = member_offsets[collapse.from]; m < member_offsets[collapse.from + 1]; ++m){
+                    remap[members[m]] = closest_member(members[m], collapse.into);
+                }
+                quadrics[collapse.into] += quadrics[collapse.from];
+
+                estimated_indices -= removed * 3;
+                collapsed++;
+            }
+
+            if (collapsed == 0) break;
+
+            // Перенос стянутых вершин, вырожденные треугольники исключаются
+            size_t write = 0;
+            for (size_t t = 0; t < triangle_count; ++t){
+                const auto i0 = remap[result[t * 3]];
+                const auto i1 = remap[result[t * 3 + 1]];
+                const auto i2 = remap[result[t * 3 + 2]];
+                if (group[i0] == group[i1] || group[i1] == group[i2] || group[i0] == group[i2]) continue;
+
+                result[write++] = i0;
+                result[write++] = i1;
+                result[write++] = i2;
+            }
+            result.resize(write);
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include <nasral/resources/mesh.h>
+#include <glm/gtc/packing.hpp>
+
+namespace nasral::resources
+{
+    /**
+     * Вычисление касательных для вершин, у которых они не заданы (w = 0)
+     * @param vertices Вершины (касательная в xyz, направление битангенса в w)
+     * @param indices Индексы треугольников
+     *
+     * @details Касательные треугольников (по позициям и UV) накапливаются в вершинах, затем ортогонализуются
+     * относительно нормали. Знак w учитывает зеркальные UV (битангенс = cross(N, T) * w).
+     */
+    inline void compute_tangents(std::vector<rendering::Vertex>& vertices, const std::vector<uint32_t>& indices)
+    {
+        std::vector<glm::vec3> tangents(vertices.size(), glm::vec3(0.0f));
+        std::vector<glm::vec3> bitangents(vertices.size(), glm::vec3(0.0f));
+
+        // Касательная и битангенс каждого треугольника (взвешены площадью в UV)
+        for (size_t i = 0; i + 2 < indices.size(); i += 3){
+            const auto i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+            const glm::vec3 edge1 = vertices[i1].pos - vertices[i0].pos;
+            const glm::vec3 edge2 = vertices[i2].pos - vertices[i0].pos;
+            const glm::vec2 delta_uv1 = vertices[i1].uv - vertices[i0].uv;
+            const glm::vec2 delta_uv2 = vertices[i2].uv - vertices[i0].uv;
+
+            // Вырожденные UV - треугольник не влияет на касательные
+            const float det = delta_uv1.x * delta_uv2.y - delta_uv2.x * delta_uv1.y;
+            if (std::abs(det) < 1e-12f) continue;
+
+            const float f = 1.0f / det;
+            const glm::vec3 tangent = f * (delta_uv2.y * edge1 - delta_uv1.y * edge2);
+            const glm::vec3 bitangent = f * (delta_uv1.x * edge2 - delta_uv2.x * edge1);
+
+            for (const auto index : {i0, i1, i2}){
+                tangents[index] += tangent;
+                bitangents[index] += bitangent;
+            }
+        }
+
+        // Ортогонализация (Грама-Шмидта) и направление битангенса
+        for (size_t i = 0; i < vertices.size(); ++i){
+            auto& vertex = vertices[i];
+            if (vertex.tangent.w != 0.0f) continue;
+
+            const glm::vec3 n = vertex.normal;
+            glm::vec3 t = tangents[i] - n * glm::dot(n, tangents[i]);
+
+            // Нет касательной по UV - любой вектор, перпендикулярный нормали
+            if (glm::dot(t, t) < 1e-12f){
+                t = glm::cross(n, std::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f));
+            }
+            if (glm::dot(t, t) < 1e-12f){
+                t = glm::vec3(1.0f, 0.0f, 0.0f);
+            }
+
+            t = glm::normalize(t);
+            const float w = glm::dot(glm::cross(n, t), bitangents[i]) < 0.0f ? -1.0f : 1.0f;
+            vertex.tangent = glm::vec4(t, w);
+        }
+    }
+
+    /**
+     * Октаэдрическое кодирование единичного вектора (проекция на октаэдр, развернутый в квадрат [-1, 1])
+     * @param v Единичный вектор
+     * @return Координаты на квадрате
+     */
+    inline glm::vec2 oct_encode(const glm::vec3& v)
+    {
+        const float sum = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+        if (sum <= 0.0f) return glm::vec2(0.0f);
+
+        const glm::vec3 n = v / sum;
+        if (n.z >= 0.0f) return glm::vec2(n.x, n.y);
+
+        // Нижняя полусфера отражается в углы квадрата
+        return glm::vec2(
+            (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+            (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+    }
+
+    /**
+     * Упаковка касательной (октаэдрические координаты, направление битангенса в знаке y)
+     * @param tangent Касательная (xyz) и направление битангенса (w)
+     * @return Координаты snorm16 x2
+     *
+     * @details Координата y переносится в (0, 1] (нулевое значение не имеет знака), shader восстанавливает её как |y| * 2 - 1.
+     */
+    inline uint32_t pack_tangent(const glm::vec4& tangent)
+    {
+        const glm::vec2 e = oct_encode(glm::vec3(tangent));
+        const float y = std::max(e.y * 0.5f + 0.5f, 1.0f / 32767.0f);
+        return glm::packSnorm2x16(glm::vec2(e.x, tangent.w < 0.0f ? -y : y));
+    }
+
+    /**
+     * Масштаб квантования положений (размер AABB, вырожденные оси заменяются единичными)
+     * @param bounds Ограничивающие объемы mesh'а
+     * @return Масштаб по осям
+     */
+    inline glm::vec3 quantization_scale(const rendering::Bounds& bounds)
+    {
+        const glm::vec3 extent = bounds.aabb_max - bounds.aabb_min;
+        return glm::vec3(
+            extent.x > 0.0f ? extent.x : 1.0f,
+            extent.y > 0.0f ? extent.y : 1.0f,
+            extent.z > 0.0f ? extent.z : 1.0f);
+    }
+
+    /**
+     * Упаковка вершин в формат буфера вершин
+     * @param vertices Вершины
+     * @param format Формат вершин
+     * @param bounds Ограничивающие объемы mesh'а (положения квантуются в пределах AABB)
+     * @return Данные буфера вершин
+     */
+    inline std::vector<uint8_t> pack_vertices(
+        const std::vector<rendering::Vertex>& vertices,
+        const rendering::VertexFormat format,
+        const rendering::Bounds& bounds)
+    {
+        // Атрибуты, общие для упакованных форматов
+        const auto pack_attributes = [](const rendering::Vertex& v, auto& packed){
+            packed.normal = glm::packSnorm2x16(oct_encode(v.normal));
+            packed.tangent = pack_tangent(v.tangent);
+            packed.uv = glm::packHalf2x16(v.uv);
+            packed.color = glm::packUnorm4x8(v.color);
+        };
+
+        std::vector<uint8_t> data;
+        switch (format)
+        {
+        case rendering::VertexFormat::ePacked:
+            {
+                data.resize(sizeof(rendering::PackedVertex) * vertices.size());
+                auto* packed = reinterpret_cast<rendering::PackedVertex*>(data.data());
+                for (size_t i = 0; i < vertices.size(); ++i){
+                    packed[i].pos = vertices[i].pos;
+                    pack_attributes(vertices[i], packed[i]);
+                }
+                break;
+            }
+        case rendering::VertexFormat::ePackedQuantized:
+            {
+                // Положения переводятся в [0, 1] в пределах AABB
+                const glm::vec3 scale = quantization_scale(bounds);
+
+                data.resize(sizeof(rendering::QuantizedVertex) * vertices.size());
+                auto* quantized = reinterpret_cast<rendering::QuantizedVertex*>(data.data());
+                for (size_t i = 0; i < vertices.size(); ++i){
+                    const glm::vec3 t = glm::clamp((vertices[i].pos - bounds.aabb_min) / scale, 0.0f, 1.0f);
+                    quantized[i].pos = {
+                        static_cast<uint16_t>(std::lround(t.x * 65535.0f)),
+                        static_cast<uint16_t>(std::lround(t.y * 65535.0f)),
+                        static_cast<uint16_t>(std::lround(t.z * 65535.0f)),
+                        0
+                    };
+                    pack_attributes(vertices[i], quantized[i]);
+                }
+                break;
+            }
+        default:
+            data.resize(sizeof(rendering::Vertex) * vertices.size());
+            std::memcpy(data.data(), vertices.data(), data.size());
+            break;
+        }
+        return data;
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <nasral/resources/mesh.h>
+
+namespace nasral::resources
+{
+    /**
+     * Разбиение треугольников на кластеры (meshlet) с ограничивающими сферами и конусами нормалей
+     * @param vertices Вершины
+     * @param indices Индексы треугольников
+     * @param first_index Первый индекс отрезка в буфере индексов
+     * @param index_count Кол-во индексов отрезка
+     * @return Кластеры (каждый - непрерывный отрезок индексов)
+     *
+     * @details Треугольники добавляются в кластер по порядку, пока не превышено кол-во вершин или треугольников, поэтому
+     * буфер индексов не меняется (порядок для кеша вершин делает кластеры компактными). Конус нормалей строится по
+     * нормалям треугольников (направленным как нормали вершин), при большом разбросе нормалей кластер не отсекается.
+     */
+    inline std::vector<rendering::Meshlet> build_meshlets(
+        const std::vector<rendering::Vertex>& vertices,
+        const std::vector<uint32_t>& indices,
+        const uint32_t first_index,
+        const uint32_t index_count)
+    {
+        std::vector<rendering::Meshlet> meshlets;
+        if (index_count < 3) return meshlets;
+
+        // Метка кластера, в который уже добавлена вершина
+        std::vector<uint32_t> stamps(vertices.size(), std::numeric_limits<uint32_t>::max());
+        std::vector<uint32_t> meshlet_vertices;
+        meshlet_vertices.reserve(MAX_MESHLET_VERTICES);
+
+        // Сфера (по AABB вершин кластера) и конус нормалей завершенного кластера
+        const auto finish = [&](const uint32_t begin, const uint32_t end){
+            rendering::Meshlet meshlet{};
+            meshlet.first_index = begin;
+            meshlet.index_count = end - begin;
+
+            glm::vec3 aabb_min = vertices[meshlet_vertices[0]].pos;
+            glm::vec3 aabb_max = aabb_min;
+            for (const auto v : meshlet_vertices){
+                aabb_min = glm::min(aabb_min, vertices[v].pos);
+                aabb_max = glm::max(aabb_max, vertices[v].pos);
+            }
+
+            const glm::vec3 center = (aabb_min + aabb_max) * 0.5f;
+            float radius_sq = 0.0f;
+            for (const auto v : meshlet_vertices){
+                const glm::vec3 d = vertices[v].pos - center;
+                radius_sq = std::max(radius_sq, glm::dot(d, d));
+            }
+            meshlet.sphere = glm::vec4(center, std::sqrt(radius_sq));
+
+            // Нормали треугольников (вырожденные пропускаются)
+            std::vector<glm::vec3> normals;
+            normals.reserve(meshlet.index_count / 3);
+            glm::vec3 axis(0.0f);
+            for (uint32_t i = begin; i < end; i += 3){
+                const auto& v0 = vertices[indices[i]];
+                const auto& v1 = vertices[indices[i + 1]];
+                const auto& v2 = vertices[indices[i + 2]];
+                glm::vec3 n = glm::cross(v1.pos - v0.pos, v2.pos - v0.pos);
+                const float length = glm::length(n);
+                if (length <= 0.0f) continue;
+
+                n /= length;
+                if (glm::dot(n, v0.normal + v1.normal + v2.normal) < 0.0f) n = -n;
+                normals.push_back(n);
+                axis += n;
+            }
+
+            // Синус наибольшего отклонения от оси - порог отсечения (конус обратных сторон расширяется на 90 градусов)
+            const float axis_length = glm::length(axis);
+            if (axis_length > 0.0f){
+                axis /= axis_length;
+                float min_dot = 1.0f;
+                for (const auto& n : normals) min_dot = std::min(min_dot, glm::dot(n, axis));
+                if (min_dot > 0.1f){
+                    meshlet.cone = glm::vec4(axis, std::sqrt(1.0f - min_dot * min_dot));
+                }
+            }
+
+            meshlets.push_back(meshlet);
+            meshlet_vertices.clear();
+        };
+
+        uint32_t begin = first_index;
+        const uint32_t end = first_index + index_count - index_count % 3;
+        for (uint32_t i = first_index; i < end; i += 3){
+            const auto meshlet_id = to<uint32_t>(meshlets.size());
+
+            // Новые вершины треугольника (еще не добавленные в текущий кластер)
+            size_t new_vertices = 0;
+            for (uint32_t k = 0; k < 3; ++k){
+                const auto v = indices[i + k];
+                const bool duplicate = (k > 0 && indices[i] == v) || (k > 1 && indices[i + 1] == v);
+                if (stamps[v] != meshlet_id && !duplicate) new_vertices++;
+            }
+
+            // Кластер заполнен - завершить его и начать новый с этого треугольника
+            const auto triangles = (i - begin) / 3;
+            if (meshlet_vertices.size() + new_vertices > MAX_MESHLET_VERTICES || triangles + 1 > MAX_MESHLET_TRIANGLES){
+                finish(begin, i);
+                begin = i;
+            }
+
+            const auto current_id = to<uint32_t>(meshlets.size());
+            for (uint32_t k = 0; k < 3; ++k){
+                const auto v = indices[i + k];
+                if (stamps[v] != current_id){
+                    stamps[v] = current_id;
+                    meshlet_vertices.push_back(v);
+                }
+            }
+        }
+
+        if (begin < end){
+            finish(begin, end);
+        }
+        return meshlets;
+    }
+}
@@ -10,6 +10,7 @@ namespace nasral::resources
         , material_type_(rendering::MaterialType::eDummy)
         , vk_polygon_mode_(vk::PolygonMode::eFill)
         , vk_line_width_(1.0f)
+        , instanced_(false)
         , path_(path)
         , loader_(std::move(loader))
         , vert_shader_res_(manager, Type::eShader, "")
@@ -20,6 +21,22 @@ namespace nasral::resources
     {}
 
     Material::~Material(){
+        // Дождаться создания конвейеров (задачи используют объекты материала)
+        if (vk_pipeline_task_.valid()){
+            vk_pipeline_task_.wait();
+        }
+
+        // Задачи вариантов ожидаются без блокировки (по завершении задача блокирует список вариантов)
+        std::vector<std::future<void>> variant_tasks;
+        {
+            std::lock_guard lock(variants_mutex_);
+            for (auto& [features, variant] : variants_){
+                if (variant.task.valid()) variant_tasks.push_back(std::move(variant.task));
+            }
+        }
+        for (const auto& task : variant_tasks){
+            task.wait();
+        }
         logger()->info("Material resource destroyed (" + std::string(path_.data()) + ")");
     }
 
@@ -70,6 +87,9 @@ namespace nasral::resources
             // Ширина линии
             vk_line_width_ = std::max(data->line_width, 1.0f);
 
+            // Вершинный shader получает индексы объектов из буфера экземпляров (instanced-отрисовка)
+            instanced_ = data->instanced;
+
             // Запрос под-ресурса вершинного shader'а
             // После завершения ПОПЫТКИ загрузки вызовет try_init_vk_objects()
             vert_shader_res_.set_path(data->vert_shader_path);
@@ -118,7 +138,7 @@ namespace nasral::resources
     }
 
     rendering::Handles::Material Material::render_handles() const {
-        return {vk_pipeline()};
+        return {vk_pipeline(), instanced_};
     }
 
     void Material::try_init_vk_objects(){
@@ -139,10 +159,103 @@ namespace nasral::resources
             return;
         }
 
-        // Получить renderer и устройство
+        // Конвейер уже создается
+        if (vk_pipeline_task_.valid()) return;
+
+        // Состояние, зависящее от поверхности, фиксируется в основном потоке (поверхность может пересоздаваться)
+        const auto* renderer = resource_manager_->engine()->renderer();
+        const auto extent = renderer->get_rendering_resolution();
+        const bool gl_style = renderer->config().use_opengl_style;
+        const vk::RenderPass render_pass = renderer->vk_render_pass();
+
+        // Создание конвейера (компиляция shader'ов драйвером) выполняется пулом потоков renderer'а
+        // До его завершения ресурс не загружен, экземпляры материала используют материал-заглушку
+        vk_pipeline_task_ = renderer->submit_pipeline_task([this, extent, gl_style, render_pass](){
+            init_vk_pipeline(extent, gl_style, render_pass);
+        });
+    }
+
+    void Material::init_vk_pipeline(const vk::Extent2D& extent, const bool gl_style, const vk::RenderPass& render_pass){
+        // Основной конвейер выполняет выборку из всех текстур
+        try{
+            vk_pipeline_ = create_vk_pipeline(extent, gl_style, render_pass, rendering::kAllTextureFeatures, rendering::VertexFormat::eFull);
+        }
+        catch([[maybe_unused]] std::exception& e){
+            err_code_ = ErrorCode::eVulkanError;
+            status_ = Status::eError;
+            logger()->error(e.what());
+            return;
+        }
+
+        // Ресурс готов (статус меняется последним - менеджер ресурсов читает его из основного потока)
+        err_code_ = ErrorCode::eNoError;
+        status_ = Status::eLoaded;
+        logger()->info("Material resource loaded (" + std::string(path_.data()) + ")");
+    }
+
+    std::optional<rendering::Handles::Material> Material::variant_handles(
+        uint32_t features,
+        const rendering::VertexFormat vertex_format) const
+    {
+        // Shader'ы материала не используют признаки - выборка из всех текстур
+        if (!has_texture_features()){
+            features = rendering::kAllTextureFeatures;
+        }
+
+        // Все текстуры заданы, вершины полного формата - основной конвейер
+        if (features == rendering::kAllTextureFeatures && vertex_format == rendering::VertexFormat::eFull){
+            return render_handles();
+        }
+
+        // Вариант, который не удалось создать, заменяется основным конвейером (только для того же формата вершин)
+        const uint32_t key = features | (to<uint32_t>(vertex_format) << 16);
+        const bool replaceable = vertex_format == rendering::VertexFormat::eFull;
+        {
+            std::lock_guard lock(variants_mutex_);
+            if (const auto it = variants_.find(key); it != variants_.end()){
+                if (!it->second.ready) return std::nullopt;
+                if (!it->second.pipeline) return replaceable ? render_handles() : rendering::Handles::Material{};
+                return rendering::Handles::Material{it->second.pipeline.get(), instanced_};
+            }
+            variants_.try_emplace(key);
+        }
+
+        // Первый запрос варианта - создание в пуле потоков (блокировка снята: без рабочих потоков задача выполняется сразу)
+        const auto* renderer = resource_manager_->engine()->renderer();
+        const auto extent = renderer->get_rendering_resolution();
+        const bool gl_style = renderer->config().use_opengl_style;
+        const vk::RenderPass render_pass = renderer->vk_render_pass();
+
+        auto task = renderer->submit_pipeline_task([this, extent, gl_style, render_pass, features, vertex_format, key](){
+            vk::UniquePipeline pipeline;
+            try{
+                pipeline = create_vk_pipeline(extent, gl_style, render_pass, features, vertex_format);
+            }
+            catch([[maybe_unused]] std::exception& e){
+                logger()->error(e.what());
+            }
+
+            std::lock_guard lock(variants_mutex_);
+            auto& variant = variants_[key];
+            variant.pipeline = std::move(pipeline);
+            variant.ready = true;
+        });
+
+        std::lock_guard lock(variants_mutex_);
+        variants_[key].task = std::move(task);
+        return std::nullopt;
+    }
+
+    vk::UniquePipeline Material::create_vk_pipeline(
+        const vk::Extent2D& extent,
+        const bool gl_style,
+        const vk::RenderPass& render_pass,
+        const uint32_t features,
+        const rendering::VertexFormat vertex_format) const
+    {
+        // Получить renderer и макет конвейера
         const auto* renderer = resource_manager_->engine()->renderer();
         const auto& ul = renderer->vk_uniform_layout(rendering::UniformLayoutType::eBasicRasterization);
-        const auto& vd = renderer->vk_device();
 
         /** 1. Входные данные **/
 
@@ -157,7 +270,7 @@ namespace nasral::resources
 
         // Описываем атрибуты вершин
         // Для каждого атрибута можно указать, к какому буферу он относится (binding)
-        std::array<vk::VertexInputAttributeDescription, 4> vertex_input_attributes = {
+        std::array<vk::VertexInputAttributeDescription, 5> vertex_input_attributes = {
             // Положение
             vk::VertexInputAttributeDescription()
             .setLocation(0)
@@ -184,9 +297,35 @@ namespace nasral::resources
             .setLocation(3)
             .setBinding(0)
             .setFormat(vk::Format::eR32G32B32A32Sfloat)
-            .setOffset(offsetof(rendering::Vertex, color))
+            .setOffset(offsetof(rendering::Vertex, color)),
+
+            // Касательная и направление битангенса
+            vk::VertexInputAttributeDescription()
+            .setLocation(4)
+            .setBinding(0)
+            .setFormat(vk::Format::eR32G32B32A32Sfloat)
+            .setOffset(offsetof(rendering::Vertex, tangent))
         };
 
+        // Упакованные форматы: октаэдрические нормаль и касательная, UV в half, цвет в unorm8 (распаковка при выборке)
+        const auto set_packed_attributes = [&](const auto& vertex){
+            using V = std::decay_t<decltype(vertex)>;
+            vertex_input_bindings[0].setStride(sizeof(V));
+            vertex_input_attributes[0].setOffset(offsetof(V, pos));
+            vertex_input_attributes[1].setFormat(vk::Format::eR16G16Snorm).setOffset(offsetof(V, normal));
+            vertex_input_attributes[2].setFormat(vk::Format::eR16G16Sfloat).setOffset(offsetof(V, uv));
+            vertex_input_attributes[3].setFormat(vk::Format::eR8G8B8A8Unorm).setOffset(offsetof(V, color));
+            vertex_input_attributes[4].setFormat(vk::Format::eR16G16Snorm).setOffset(offsetof(V, tangent));
+        };
+
+        if (vertex_format == rendering::VertexFormat::ePacked){
+            set_packed_attributes(rendering::PackedVertex{});
+        }else if (vertex_format == rendering::VertexFormat::ePackedQuantized){
+            // Положение в пределах AABB mesh'а (восстанавливается shader'ом)
+            set_packed_attributes(rendering::QuantizedVertex{});
+            vertex_input_attributes[0].setFormat(vk::Format::eR16G16B16A16Unorm);
+        }
+
         // Описываем стадию входных данных
         vk::PipelineVertexInputStateCreateInfo vertex_input_state = {};
         vertex_input_state.setVertexBindingDescriptions(vertex_input_bindings);
@@ -204,6 +343,31 @@ namespace nasral::resources
 
         /** 3. программируемые стадии (shaders) **/
 
+        // Константы специализации (размер таблицы текстур, признаки текстур и формат вершин, выборки из незаданных текстур исключаются,
+        // размер сетки кластеров освещения совпадает с размером, по которому источники распределяются на CPU)
+        // Константы, не объявленные в shader'е стадии, игнорируются
+        const std::array<uint32_t, 6> specialization_data = {
+            renderer->config().texture_table_size,
+            features,
+            to<uint32_t>(vertex_format),
+            LIGHT_CLUSTERS_X,
+            LIGHT_CLUSTERS_Y,
+            LIGHT_CLUSTERS_Z
+        };
+        const std::array<vk::SpecializationMapEntry, 6> specialization_entries = {
+            vk::SpecializationMapEntry(to<uint32_t>(rendering::SpecializationConstant::eTextureTableSize), 0, sizeof(uint32_t)),
+            vk::SpecializationMapEntry(to<uint32_t>(rendering::SpecializationConstant::eTextureFeatures), sizeof(uint32_t), sizeof(uint32_t)),
+            vk::SpecializationMapEntry(to<uint32_t>(rendering::SpecializationConstant::eVertexFormat), sizeof(uint32_t) * 2, sizeof(uint32_t)),
+            vk::SpecializationMapEntry(to<uint32_t>(rendering::SpecializationConstant::eLightClustersX), sizeof(uint32_t) * 3, sizeof(uint32_t)),
+            vk::SpecializationMapEntry(to<uint32_t>(rendering::SpecializationConstant::eLightClustersY), sizeof(uint32_t) * 4, sizeof(uint32_t)),
+            vk::SpecializationMapEntry(to<uint32_t>(rendering::SpecializationConstant::eLightClustersZ), sizeof(uint32_t) * 5, sizeof(uint32_t))
+        };
+
+        vk::SpecializationInfo specialization_info{};
+        specialization_info.setMapEntries(specialization_entries);
+        specialization_info.setDataSize(sizeof(specialization_data));
+        specialization_info.setPData(specialization_data.data());
+
         // Описываем программируемые стадии конвейера
         assert(vk_vert_shader_.has_value());
         assert(vk_frag_shader_.has_value());
@@ -215,14 +379,16 @@ namespace nasral::resources
             vk::PipelineShaderStageCreateInfo()
                 .setStage(vk::ShaderStageFlagBits::eVertex)
                 .setModule(vk_vert_shader_.value())
-                .setPName("main"));
+                .setPName("main")
+                .setPSpecializationInfo(&specialization_info));
 
         // Фрагментный шейдер
         shader_stages.emplace_back(
             vk::PipelineShaderStageCreateInfo()
                 .setStage(vk::ShaderStageFlagBits::eFragment)
                 .setModule(vk_frag_shader_.value())
-                .setPName("main"));
+                .setPName("main")
+                .setPSpecializationInfo(&specialization_info));
 
         // Геометрический шейдер (если нужно)
         if (vk_geom_shader_.has_value()){
@@ -230,15 +396,12 @@ namespace nasral::resources
                 vk::PipelineShaderStageCreateInfo()
                     .setStage(vk::ShaderStageFlagBits::eGeometry)
                     .setModule(vk_geom_shader_.value())
-                    .setPName("main"));
+                    .setPName("main")
+                    .setPSpecializationInfo(&specialization_info));
         }
 
         /** 4. View-port **/
 
-        // Пространство в стиле OpenGL
-        const auto extent = renderer->get_rendering_resolution();
-        const bool gl_style = renderer->config().use_opengl_style;
-
         // Статическая настройка вью-портов (может быть несколько)
         std::array<vk::Viewport, 1> viewports = {
             vk::Viewport()
@@ -330,44 +493,23 @@ namespace nasral::resources
 
         /** 8. Конвейер **/
 
-        // Попытка инициализации графического конвейера
-        try{
-            if (!ul.vk_pipeline_layout()){
-                throw std::runtime_error("Can't create graphics pipeline. Pipeline layout is not initialized!");
-            }
-
-            auto result = vd->logical_device().createGraphicsPipelineUnique(
-                {},
-                vk::GraphicsPipelineCreateInfo()
-                .setStages(shader_stages)
-                .setPVertexInputState(&vertex_input_state)
-                .setPInputAssemblyState(&input_assembly_state)
-                .setPViewportState(&viewport_state)
-                .setPRasterizationState(&rasterizer_state)
-                .setPDepthStencilState(&depth_stencil_state)
-                .setPMultisampleState(&multisampling_state)
-                .setPColorBlendState(&color_blending_state)
-                .setPDynamicState(&dynamic_states_info)
-                .setLayout(ul.vk_pipeline_layout())
-                .setRenderPass(renderer->vk_render_pass())
-                .setSubpass(0));
-
-            if (result.result != vk::Result::eSuccess){
-                throw std::runtime_error("Failed to create graphics pipeline!");
-            }
-
-            vk_pipeline_ = std::move(result.value);
-        }
-        catch([[maybe_unused]] std::exception& e){
-            status_ = Status::eError;
-            err_code_ = ErrorCode::eVulkanError;
-            logger()->error(e.what());
-            return;
+        if (!ul.vk_pipeline_layout()){
+            throw std::runtime_error("Can't create graphics pipeline. Pipeline layout is not initialized!");
         }
 
-        // Ресурс готов
-        status_ = Status::eLoaded;
-        err_code_ = ErrorCode::eNoError;
-        logger()->info("Material resource loaded (" + std::string(path_.data()) + ")");
+        return renderer->create_graphics_pipeline(
+            vk::GraphicsPipelineCreateInfo()
+            .setStages(shader_stages)
+            .setPVertexInputState(&vertex_input_state)
+            .setPInputAssemblyState(&input_assembly_state)
+            .setPViewportState(&viewport_state)
+            .setPRasterizationState(&rasterizer_state)
+            .setPDepthStencilState(&depth_stencil_state)
+            .setPMultisampleState(&multisampling_state)
+            .setPColorBlendState(&color_blending_state)
+            .setPDynamicState(&dynamic_states_info)
+            .setLayout(ul.vk_pipeline_layout())
+            .setRenderPass(render_pass)
+            .setSubpass(0));
     }
 }
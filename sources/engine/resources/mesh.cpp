@@ -1,6 +1,10 @@
 #include "pch.h"
 #include <nasral/engine.h>
 #include <nasral/resources/mesh.h>
+#include "loaders/mesh_utils.hpp"
+#include "loaders/mesh_optimizer.hpp"
+#include "loaders/mesh_simplifier.hpp"
+#include "loaders/meshlet_builder.hpp"
 
 namespace nasral::resources
 {
@@ -10,6 +14,11 @@ namespace nasral::resources
         , loader_(std::move(loader))
         , vertex_count_(0)
         , index_count_(0)
+        , lods_({})
+        , lod_count_(0)
+        , meshlet_count_(0)
+        , vertex_format_(rendering::VertexFormat::eFull)
+        , index_type_(vk::IndexType::eUint32)
     {}
 
     Mesh::~Mesh(){
@@ -22,7 +31,7 @@ namespace nasral::resources
         const auto path = manager()->full_path(path_.data());
 
         try{
-            const auto data = loader_->load(path);
+            auto data = loader_->load(path);
             if (!data.has_value()){
                 status_ = Status::eError;
                 err_code_ = loader_->err_code();
@@ -34,10 +43,85 @@ namespace nasral::resources
                 return;
             }
 
-            // Кол-во вершин и индексов
+            // Уровни детализации (каждый следующий упрощается из предыдущего, вершины общие)
+            const auto* lp = loader_->load_params<MeshLoadParams>();
+            std::vector<std::vector<uint32_t>> lod_indices;
+            lod_indices.push_back(std::move(data->indices));
+            const auto lod_count = lp != nullptr ? std::clamp<uint32_t>(lp->lod_count, 1, MAX_MESH_LODS) : 1;
+            while (lod_indices.size() < lod_count){
+                const auto& source = lod_indices.back();
+                const float reduction = std::clamp(lp->lod_reduction, 0.0f, 1.0f);
+                const auto target = static_cast<size_t>(static_cast<float>(source.size() / 3) * reduction) * 3;
+                auto simplified = simplify_mesh(data->vertices, source, target);
+
+                // Упрощение остановилось (швы, границы) - следующие уровни не отличались бы от текущего
+                if (simplified.empty() || simplified.size() * 10 > source.size() * 9) break;
+                lod_indices.push_back(std::move(simplified));
+            }
+
+            // Оптимизация порядка треугольников (кеш вершин, перерисовка) и порядка вершин (выборка вершин)
+            if (lp != nullptr && lp->optimize){
+                const auto before = analyze_vertex_cache(lod_indices[0], data->vertices.size());
+                for (auto& indices : lod_indices){
+                    optimize_vertex_cache(indices, data->vertices.size());
+                    optimize_overdraw(indices, data->vertices);
+                }
+                const auto after = analyze_vertex_cache(lod_indices[0], data->vertices.size());
+
+                std::ostringstream ss;
+                ss << "Mesh optimized (" << path_ << "): ACMR " << before.acmr << " -> " << after.acmr
+                   << ", ATVR " << before.atvr << " -> " << after.atvr;
+                logger()->info(ss.str());
+            }
+
+            // Индексы уровней хранятся подряд в общем буфере
+            lod_count_ = lod_indices.size();
+            data->indices.clear();
+            for (size_t i = 0; i < lod_count_; ++i){
+                lods_[i].first_index = to<uint32_t>(data->indices.size());
+                lods_[i].index_count = to<uint32_t>(lod_indices[i].size());
+                data->indices.insert(data->indices.end(), lod_indices[i].begin(), lod_indices[i].end());
+            }
+
+            if (lod_count_ > 1){
+                std::ostringstream ss;
+                ss << "Mesh LODs generated (" << path_ << "):";
+                for (size_t i = 0; i < lod_count_; ++i) ss << " " << lods_[i].index_count / 3;
+                ss << " triangles";
+                logger()->info(ss.str());
+            }
+
+            // Порядок вершин по первому использованию (полный уровень - первым)
+            if (lp != nullptr && lp->optimize){
+                optimize_vertex_fetch(data->vertices, data->indices);
+            }
+
+            // Кол-во вершин и индексов (всех уровней)
             vertex_count_ = data->vertices.size();
             index_count_ = data->indices.size();
 
+            // Ограничивающие объемы (AABB и сфера с центром в центре AABB)
+            bounds_ = {};
+            if (!data->vertices.empty()){
+                bounds_.aabb_min = bounds_.aabb_max = data->vertices[0].pos;
+                for (const auto& v : data->vertices){
+                    bounds_.aabb_min = glm::min(bounds_.aabb_min, v.pos);
+                    bounds_.aabb_max = glm::max(bounds_.aabb_max, v.pos);
+                }
+
+                const glm::vec3 center = (bounds_.aabb_min + bounds_.aabb_max) * 0.5f;
+                float radius_sq = 0.0f;
+                for (const auto& v : data->vertices){
+                    const glm::vec3 d = v.pos - center;
+                    radius_sq = std::max(radius_sq, glm::dot(d, d));
+                }
+                bounds_.sphere = glm::vec4(center, std::sqrt(radius_sq));
+            }
+
+            // Формат буфера вершин (упакованные форматы квантуют атрибуты, положения - в пределах AABB)
+            vertex_format_ = lp != nullptr ? lp->vertex_format : rendering::VertexFormat::eFull;
+            const auto vertex_data = pack_vertices(data->vertices, vertex_format_, bounds_);
+
             // Получить устройство и группу очередей для копирования/перемещения
             const auto* renderer = resource_manager_->engine()->renderer();
             const auto& vd = renderer->vk_device();
@@ -48,20 +132,20 @@ namespace nasral::resources
                 // Создать временный буфер вершин (память ОЗУ)
                 vk::utils::Buffer staging_buffer(
                     vd,
-                    sizeof(rendering::Vertex) * vertex_count_,
+                    vertex_data.size(),
                     vk::BufferUsageFlagBits::eTransferSrc,
                     vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
 
                 // Итоговый буфер вершин
                 vertex_buffer_ = std::make_unique<vk::utils::Buffer>(
                     vd,
-                    sizeof(rendering::Vertex) * vertex_count_,
+                    vertex_data.size(),
                     vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst,
                     vk::MemoryPropertyFlagBits::eDeviceLocal);
 
                 // Копировать данные во временный (staging) буфер
                 auto* p = staging_buffer.map_unsafe();
-                memcpy(p, data->vertices.data(), sizeof(rendering::Vertex) * vertex_count_);
+                memcpy(p, vertex_data.data(), vertex_data.size());
                 staging_buffer.unmap_unsafe();
 
                 // Копировать из временного в основной
@@ -70,34 +154,89 @@ namespace nasral::resources
 
             // Индексы
             {
+                // Индексы 16 бит, если ими адресуются все вершины (вдвое меньше памяти и чтения индексов)
+                std::vector<uint16_t> indices_16;
+                index_type_ = vertex_count_ <= 0x10000 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+                if (index_type_ == vk::IndexType::eUint16){
+                    indices_16.assign(data->indices.begin(), data->indices.end());
+                }
+
+                const void* index_data = indices_16.empty() ? static_cast<const void*>(data->indices.data()) : indices_16.data();
+                const vk::DeviceSize index_size = (indices_16.empty() ? sizeof(uint32_t) : sizeof(uint16_t)) * index_count_;
+
                 // Создать временный буфер индексов (память ОЗУ)
                 vk::utils::Buffer staging_buffer(
                     vd,
-                    sizeof(uint32_t) * index_count_,
+                    index_size,
                     vk::BufferUsageFlagBits::eTransferSrc,
                     vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
 
                 // Итоговый буфер индексов
                 index_buffer_ = std::make_unique<vk::utils::Buffer>(
                     vd,
-                    sizeof(uint32_t) * index_count_,
+                    index_size,
                     vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst,
                     vk::MemoryPropertyFlagBits::eDeviceLocal);
 
                 // Копировать данные во временный (staging) буфер
                 auto* p = staging_buffer.map_unsafe();
-                memcpy(p, data->indices.data(), sizeof(uint32_t) * index_count_);
+                memcpy(p, index_data, index_size);
                 staging_buffer.unmap_unsafe();
 
                 // Копировать из временного в основной
                 staging_buffer.copy_to(*index_buffer_, transfer_group);
             }
+
+            // Кластеры полного уровня детализации (для отсечения кластеров на GPU)
+            meshlet_count_ = 0;
+            if (lp != nullptr && lp->meshlets){
+                const auto meshlets = build_meshlets(data->vertices, data->indices, lods_[0].first_index, lods_[0].index_count);
+                meshlet_count_ = meshlets.size();
+
+                if (!meshlets.empty()){
+                    const vk::DeviceSize meshlets_size = sizeof(rendering::Meshlet) * meshlets.size();
+
+                    // Создать временный буфер кластеров (память ОЗУ)
+                    vk::utils::Buffer staging_buffer(
+                        vd,
+                        meshlets_size,
+                        vk::BufferUsageFlagBits::eTransferSrc,
+                        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+                    // Итоговый буфер кластеров (читается вычислительным проходом отсечения)
+                    meshlet_buffer_ = std::make_unique<vk::utils::Buffer>(
+                        vd,
+                        meshlets_size,
+                        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+                        vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+                    // Копировать данные во временный (staging) буфер
+                    auto* p = staging_buffer.map_unsafe();
+                    memcpy(p, meshlets.data(), meshlets_size);
+                    staging_buffer.unmap_unsafe();
+
+                    // Копировать из временного в основной
+                    staging_buffer.copy_to(*meshlet_buffer_, transfer_group);
+                }
+
+                std::ostringstream ss;
+                ss << "Mesh meshlets built (" << path_ << "): " << meshlet_count_ << " meshlets for "
+                   << lods_[0].index_count / 3 << " triangles";
+                logger()->info(ss.str());
+            }
         }
         catch([[maybe_unused]] const std::exception& e){
             vertex_buffer_.reset();
             index_buffer_.reset();
+            meshlet_buffer_.reset();
             vertex_count_ = 0;
             index_count_ = 0;
+            lods_ = {};
+            lod_count_ = 0;
+            meshlet_count_ = 0;
+            vertex_format_ = rendering::VertexFormat::eFull;
+            index_type_ = vk::IndexType::eUint32;
+            bounds_ = {};
 
             status_ = Status::eError;
             err_code_ = ErrorCode::eVulkanError;
@@ -111,10 +250,30 @@ namespace nasral::resources
     }
 
     rendering::Handles::Mesh Mesh::render_handles() const{
-        return {
+        rendering::Handles::Mesh handles = {
             vk_vertex_buffer(),
             vk_index_buffer(),
-            static_cast<uint32_t>(index_count_),
+            lods_[0].first_index,
+            lods_[0].index_count,
+            index_type_,
+            vertex_format_
         };
+
+        // Уровни детализации (выбираются при добавлении в очередь отрисовки)
+        handles.lods = lods_;
+        handles.lod_count = to<uint32_t>(std::max<size_t>(lod_count_, 1));
+
+        // Кластеры (отсекаются на GPU, если они построены)
+        if (meshlet_buffer_){
+            handles.meshlet_buffer = meshlet_buffer_->vk_buffer();
+            handles.meshlet_count = to<uint32_t>(meshlet_count_);
+        }
+
+        // Квантованные положения восстанавливаются shader'ом по AABB
+        if (vertex_format_ == rendering::VertexFormat::ePackedQuantized){
+            handles.pos_offset = glm::vec4(bounds_.aabb_min, 0.0f);
+            handles.pos_scale = glm::vec4(quantization_scale(bounds_), 0.0f);
+        }
+        return handles;
     }
 }
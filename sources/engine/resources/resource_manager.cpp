@@ -6,6 +6,7 @@
 #include <nasral/resources/mesh.h>
 #include <nasral/resources/texture.h>
 #include <nasral/engine.h>
+#include <nasral/profiling/profiler.h>
 
 #include "loaders/shader_loader.hpp"
 #include "loaders/material_loader.hpp"
@@ -20,6 +21,7 @@ namespace nasral::resources
     ResourceManager::ResourceManager(const Engine* engine, const ResourceConfig& config)
         : engine_(engine)
         , content_dir_(config.content_dir)
+        , fallback_material_path_(config.fallback_material)
     {
         // Начала инициализации, вывод базовой информации
         const std::string cwd = std::filesystem::current_path().string();
@@ -252,12 +254,36 @@ namespace nasral::resources
                 builtin_resources_[i].request();
             }
         }
+
+        // Материал-заглушка (его конвейер подставляется вместо еще не созданных конвейеров других материалов)
+        if (!fallback_material_path_.empty()){
+            fallback_material_ = make_ref(Type::eMaterial, fallback_material_path_);
+            fallback_material_.set_callback([this](IResource* resource){
+                const auto* material = dynamic_cast<Material*>(resource);
+                if (material && resource->status() == Status::eLoaded){
+                    fallback_material_handles_ = material->render_handles();
+                }
+            });
+            fallback_material_.request();
+        }
     }
 
     void ResourceManager::release_builtin(){
         for (size_t i = 0; i < to<size_t>(BuiltinResources::TOTAL); ++i){
             builtin_resources_[i].release();
         }
+
+        fallback_material_handles_ = {};
+        fallback_material_.release();
+    }
+
+    rendering::Handles::Material ResourceManager::fallback_material(const rendering::VertexFormat format) const{
+        if (format == rendering::VertexFormat::eFull) return fallback_material_handles_;
+
+        // Для упакованных форматов вершин - вариант конвейера материала-заглушки (создается при первом запросе)
+        const auto* material = dynamic_cast<const Material*>(fallback_material_.resource());
+        if (!fallback_material_handles_ || material == nullptr) return {};
+        return material->variant_handles(rendering::kAllTextureFeatures, format).value_or(rendering::Handles::Material{});
     }
 
     IResource::Ptr ResourceManager::make_resource(const Slot& slot){
@@ -396,6 +422,8 @@ namespace nasral::resources
     }
 
     void ResourceManager::update([[maybe_unused]] float delta){
+        profiling::Zone zone("ResourceManager::update");
+
         for (const size_t index : active_slots_){
             auto& slot = slots_[index];
 
@@ -432,7 +460,10 @@ namespace nasral::resources
                     slot.loading.in_progress.store(true, std::memory_order_release);
                     slot.resource = make_resource(slot);
                     slot.loading.task = std::async(std::launch::async, [&slot]() {
+                        profiling::set_thread_name("loader");
+                        profiling::Zone zone("IResource::load", slot.info.path.view());
                         slot.resource->load();
+                        zone.end();
                         slot.loading.in_progress.store(false, std::memory_order_release);
                     });
                 }
@@ -0,0 +1,95 @@
+#include "pch.h"
+#include <nasral/threading/thread_pool.h>
+#include <nasral/profiling/profiler.h>
+
+namespace nasral::threading
+{
+    ThreadPool::ThreadPool(const size_t thread_count, std::string name)
+        : stopping_(false)
+        , name_(std::move(name))
+    {
+        workers_.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; ++i){
+            workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool(){
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        condition_.notify_all();
+
+        for (auto& worker : workers_){
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    std::future<void> ThreadPool::submit(Task task){
+        std::packaged_task<void()> packaged(std::move(task));
+        auto future = packaged.get_future();
+
+        // Без рабочих потоков задача выполняется сразу (в вызывающем потоке)
+        if (workers_.empty()){
+            packaged();
+            return future;
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            tasks_.emplace(std::move(packaged));
+        }
+        condition_.notify_one();
+        return future;
+    }
+
+    void ThreadPool::parallel_for(const size_t count, const IndexedTask& task){
+        if (count == 0) return;
+
+        // Все задачи кроме первой отправляются рабочим потокам, первая выполняется вызывающим потоком
+        std::vector<std::future<void>> futures;
+        futures.reserve(count - 1);
+        for (size_t i = 1; i < count; ++i){
+            futures.emplace_back(submit([&task, i](){ task(i); }));
+        }
+
+        // Исключение вызывающего потока пробрасывается только после завершения остальных задач
+        std::exception_ptr error = nullptr;
+        try{
+            task(0);
+        }catch(...){
+            error = std::current_exception();
+        }
+
+        for (auto& future : futures){
+            try{
+                future.get();
+            }catch(...){
+                if (!error) error = std::current_exception();
+            }
+        }
+
+        if (error){
+            std::rethrow_exception(error);
+        }
+    }
+
+    void ThreadPool::worker_loop(const size_t index){
+        // Имя потока в трассировке зон CPU
+        profiling::set_thread_name(name_ + " " + std::to_string(index));
+
+        while (true)
+        {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock lock(mutex_);
+                condition_.wait(lock, [this](){ return stopping_ || !tasks_.empty(); });
+                if (stopping_ && tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+}